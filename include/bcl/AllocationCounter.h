@@ -0,0 +1,281 @@
+//===- AllocationCounter.h - Allocation Instrumentation ---------*- C++ -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements opt-in instrumentation which counts heap allocations.
+// Allocations are attributed to the innermost bcl::AllocationScope which is
+// active in the current thread. There are two sources of events:
+//   * bcl::CountingResource is a std::pmr::memory_resource which counts
+//     allocations requested from an upstream resource.
+//   * BCL_COUNTING_OPERATOR_NEW defines replaceable global allocation
+//     functions which count all allocations performed via operator new.
+//     It must be used at most once in a program, usually in a test.
+// \code
+//   BCL_COUNTING_OPERATOR_NEW
+//
+//   bool test() {
+//     bcl::AllocationScope Scope("json");
+//     parseSomething();
+//     return Scope.stats().Allocations <= 5;
+//   }
+// \endcode
+//===----------------------------------------------------------------------===//
+
+#ifndef BCL_ALLOCATION_COUNTER_H
+#define BCL_ALLOCATION_COUNTER_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+
+#ifdef _MSC_VER
+# include <malloc.h>
+#endif
+
+namespace bcl {
+/// Statistic of allocations.
+struct AllocationStats {
+  /// Number of allocations.
+  std::size_t Allocations = 0;
+
+  /// Number of deallocations.
+  std::size_t Deallocations = 0;
+
+  /// Total number of allocated bytes.
+  std::size_t Bytes = 0;
+
+  /// Accumulates statistic from a specified object.
+  AllocationStats & operator+=(const AllocationStats &RHS) noexcept {
+    Allocations += RHS.Allocations;
+    Deallocations += RHS.Deallocations;
+    Bytes += RHS.Bytes;
+    return *this;
+  }
+};
+
+/// \brief Scope which collects statistic of allocations in the current thread.
+///
+/// Scopes can be nested. Allocations are attributed to the innermost scope,
+/// and the statistic of a nested scope is added to its parent when the nested
+/// scope is destroyed. A scope does not allocate memory, so it can be used
+/// inside allocation functions.
+class AllocationScope {
+public:
+  /// Creates a new innermost scope with a specified name. The name is not
+  /// copied so it must outlive the scope.
+  explicit AllocationScope(const char *Name) noexcept :
+    mName(Name), mParent(mCurrent) {
+    mCurrent = this;
+  }
+
+  AllocationScope(const AllocationScope &) = delete;
+  AllocationScope & operator=(const AllocationScope &) = delete;
+
+  ~AllocationScope() {
+    mCurrent = mParent;
+    if (mParent)
+      mParent->mStats += mStats;
+  }
+
+  /// Returns name of the scope.
+  const char * name() const noexcept { return mName; }
+
+  /// Returns statistic of allocations performed in the scope.
+  const AllocationStats & stats() const noexcept { return mStats; }
+
+  /// Returns innermost scope in the current thread or nullptr.
+  static AllocationScope * current() noexcept { return mCurrent; }
+
+  /// Attributes allocation of a specified number of bytes to the innermost
+  /// scope.
+  static void allocate(std::size_t Bytes) noexcept {
+    if (auto *S = mCurrent) {
+      ++S->mStats.Allocations;
+      S->mStats.Bytes += Bytes;
+    }
+  }
+
+  /// Attributes deallocation to the innermost scope.
+  static void deallocate() noexcept {
+    if (auto *S = mCurrent)
+      ++S->mStats.Deallocations;
+  }
+
+private:
+  const char *mName;
+  AllocationScope *mParent;
+  AllocationStats mStats;
+  static inline thread_local AllocationScope *mCurrent = nullptr;
+};
+
+/// \brief Memory resource which counts allocations.
+///
+/// This forwards all requests to an upstream resource. Allocations are
+/// recorded in the statistic of this resource and in the innermost
+/// bcl::AllocationScope.
+class CountingResource : public std::pmr::memory_resource {
+public:
+  /// Creates resource which uses the default resource as an upstream.
+  CountingResource() noexcept :
+    mUpstream(std::pmr::get_default_resource()) {}
+
+  /// Creates resource which uses a specified upstream resource.
+  explicit CountingResource(std::pmr::memory_resource *Upstream) noexcept :
+    mUpstream(Upstream) {}
+
+  /// Returns upstream resource.
+  std::pmr::memory_resource * upstream_resource() const noexcept {
+    return mUpstream;
+  }
+
+  /// Returns statistic of allocations performed via this resource.
+  const AllocationStats & stats() const noexcept { return mStats; }
+
+  /// Resets statistic of allocations.
+  void reset() noexcept { mStats = AllocationStats(); }
+
+private:
+  void * do_allocate(std::size_t Bytes, std::size_t Alignment) override {
+    auto *Ptr = mUpstream->allocate(Bytes, Alignment);
+    ++mStats.Allocations;
+    mStats.Bytes += Bytes;
+    AllocationScope::allocate(Bytes);
+    return Ptr;
+  }
+
+  void do_deallocate(void *Ptr, std::size_t Bytes,
+      std::size_t Alignment) override {
+    ++mStats.Deallocations;
+    AllocationScope::deallocate();
+    mUpstream->deallocate(Ptr, Bytes, Alignment);
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource &Other) const noexcept override {
+    return this == &Other;
+  }
+
+  std::pmr::memory_resource *mUpstream;
+  AllocationStats mStats;
+};
+
+namespace detail {
+inline void * countingNew(std::size_t Size) {
+  bcl::AllocationScope::allocate(Size);
+  if (auto *Ptr = std::malloc(Size ? Size : 1))
+    return Ptr;
+  throw std::bad_alloc();
+}
+
+inline void * countingNew(std::size_t Size, const std::nothrow_t &) noexcept {
+  bcl::AllocationScope::allocate(Size);
+  return std::malloc(Size ? Size : 1);
+}
+
+inline void * countingNew(std::size_t Size, std::align_val_t Align) {
+  bcl::AllocationScope::allocate(Size);
+  auto A = static_cast<std::size_t>(Align);
+#ifdef _MSC_VER
+  // MSVC does not provide aligned_alloc().
+  if (auto *Ptr = _aligned_malloc(Size ? Size : 1, A))
+    return Ptr;
+#else
+  // Size passed to aligned_alloc() must be a multiple of alignment.
+  if (auto *Ptr = std::aligned_alloc(A, (Size ? Size + A - 1 : A) / A * A))
+    return Ptr;
+#endif
+  throw std::bad_alloc();
+}
+
+inline void countingDelete(void *Ptr) noexcept {
+  if (!Ptr)
+    return;
+  bcl::AllocationScope::deallocate();
+  std::free(Ptr);
+}
+
+inline void countingAlignedDelete(void *Ptr) noexcept {
+  if (!Ptr)
+    return;
+  bcl::AllocationScope::deallocate();
+#ifdef _MSC_VER
+  _aligned_free(Ptr);
+#else
+  std::free(Ptr);
+#endif
+}
+}
+}
+
+/// \brief Replaces global allocation functions with functions which count
+/// allocations in bcl::AllocationScope.
+///
+/// This macro must be used at most once in a program in a global namespace.
+#define BCL_COUNTING_OPERATOR_NEW \
+void * operator new(std::size_t Size) { \
+  return bcl::detail::countingNew(Size); \
+} \
+void * operator new[](std::size_t Size) { \
+  return bcl::detail::countingNew(Size); \
+} \
+void * operator new(std::size_t Size, const std::nothrow_t &NT) noexcept { \
+  return bcl::detail::countingNew(Size, NT); \
+} \
+void * operator new[](std::size_t Size, const std::nothrow_t &NT) noexcept { \
+  return bcl::detail::countingNew(Size, NT); \
+} \
+void operator delete(void *Ptr) noexcept { \
+  bcl::detail::countingDelete(Ptr); \
+} \
+void operator delete[](void *Ptr) noexcept { \
+  bcl::detail::countingDelete(Ptr); \
+} \
+void operator delete(void *Ptr, std::size_t) noexcept { \
+  bcl::detail::countingDelete(Ptr); \
+} \
+void operator delete[](void *Ptr, std::size_t) noexcept { \
+  bcl::detail::countingDelete(Ptr); \
+} \
+void operator delete(void *Ptr, const std::nothrow_t &) noexcept { \
+  bcl::detail::countingDelete(Ptr); \
+} \
+void operator delete[](void *Ptr, const std::nothrow_t &) noexcept { \
+  bcl::detail::countingDelete(Ptr); \
+} \
+void * operator new(std::size_t Size, std::align_val_t Align) { \
+  return bcl::detail::countingNew(Size, Align); \
+} \
+void * operator new[](std::size_t Size, std::align_val_t Align) { \
+  return bcl::detail::countingNew(Size, Align); \
+} \
+void operator delete(void *Ptr, std::align_val_t) noexcept { \
+  bcl::detail::countingAlignedDelete(Ptr); \
+} \
+void operator delete[](void *Ptr, std::align_val_t) noexcept { \
+  bcl::detail::countingAlignedDelete(Ptr); \
+} \
+void operator delete(void *Ptr, std::size_t, std::align_val_t) noexcept { \
+  bcl::detail::countingAlignedDelete(Ptr); \
+} \
+void operator delete[](void *Ptr, std::size_t, std::align_val_t) noexcept { \
+  bcl::detail::countingAlignedDelete(Ptr); \
+}
+
+#endif//BCL_ALLOCATION_COUNTER_H
@@ -0,0 +1,205 @@
+//===------- Base64.h ------- Base64 Encoding -------------------*- C++ -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements base64 encoding (RFC 4648) of binary data and defines
+// bcl::bytes, a sequence of bytes which is represented as a base64 string in
+// JSON (see Json.h).
+//
+// Encoding and decoding write directly into a destination buffer which
+// should be allocated in advance (see base64EncodedSize() and
+// base64DecodedSize()). Three bytes are processed at once: encoding uses
+// a table which maps 12 bits to two characters and decoding checks validity
+// of characters once per a whole input.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef BCL_BASE64_H
+#define BCL_BASE64_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace bcl {
+namespace detail {
+/// Alphabet of base64 encoding.
+inline constexpr char Base64Alphabet[] =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/// Character which pads encoded data.
+inline constexpr char Base64Pad = '=';
+
+/// Value of a character which does not belong to the alphabet.
+inline constexpr std::uint8_t Base64Invalid = 0x80;
+
+/// Tables which are used to encode and decode data.
+struct Base64Tables {
+  /// Two characters which encode each combination of 12 bits.
+  char Encode[4096][2];
+
+  /// Value of each character, characters which do not belong to the alphabet
+  /// are mapped to Base64Invalid.
+  std::uint8_t Decode[256];
+
+  constexpr Base64Tables() : Encode(), Decode() {
+    for (unsigned I = 0; I < 4096; ++I) {
+      Encode[I][0] = Base64Alphabet[I >> 6];
+      Encode[I][1] = Base64Alphabet[I & 0x3F];
+    }
+    for (unsigned I = 0; I < 256; ++I)
+      Decode[I] = Base64Invalid;
+    for (unsigned I = 0; I < 64; ++I)
+      Decode[static_cast<unsigned char>(Base64Alphabet[I])] =
+        static_cast<std::uint8_t>(I);
+  }
+};
+
+inline constexpr Base64Tables Base64{};
+}
+
+/// Returns number of characters which encode a specified number of bytes,
+/// the result includes padding.
+constexpr std::size_t base64EncodedSize(std::size_t Size) noexcept {
+  return (Size + 2) / 3 * 4;
+}
+
+/// \brief Encodes a specified number of bytes.
+///
+/// The destination buffer must be able to store base64EncodedSize(Size)
+/// characters, the result is not null-terminated.
+inline void base64Encode(const void *Data, std::size_t Size,
+    char *Out) noexcept {
+  auto &T = detail::Base64;
+  auto *I = static_cast<const unsigned char *>(Data), *EI = I + Size / 3 * 3;
+  for (; I != EI; I += 3, Out += 4) {
+    std::uint32_t V = (std::uint32_t(I[0]) << 16) |
+      (std::uint32_t(I[1]) << 8) | std::uint32_t(I[2]);
+    std::memcpy(Out, T.Encode[V >> 12], 2);
+    std::memcpy(Out + 2, T.Encode[V & 0xFFF], 2);
+  }
+  switch (Size % 3) {
+  case 1: {
+    std::uint32_t V = std::uint32_t(I[0]) << 4;
+    std::memcpy(Out, T.Encode[V], 2);
+    Out[2] = Out[3] = detail::Base64Pad;
+    break;
+  }
+  case 2: {
+    std::uint32_t V = (std::uint32_t(I[0]) << 10) | (std::uint32_t(I[1]) << 2);
+    std::memcpy(Out, T.Encode[V >> 6], 2);
+    Out[2] = detail::Base64Alphabet[V & 0x3F];
+    Out[3] = detail::Base64Pad;
+    break;
+  }
+  }
+}
+
+/// \brief Returns number of bytes which are encoded with a specified string.
+///
+/// Padding is optional. The string is not validated, so the result is
+/// meaningful only if the string can be decoded.
+constexpr std::size_t base64DecodedSize(std::string_view Str) noexcept {
+  auto Size = Str.size();
+  for (unsigned I = 0; I < 2 && Size > 0 && Str[Size - 1] == detail::Base64Pad;
+       ++I, --Size);
+  return Size / 4 * 3 + (Size % 4 > 1 ? Size % 4 - 1 : 0);
+}
+
+/// \brief Decodes a specified string.
+///
+/// The destination buffer must be able to store base64DecodedSize(Str) bytes.
+/// Padding is optional, however a padded string must consist of groups of
+/// four characters.
+/// \return False if the string is not a valid base64 encoding, in this case
+/// content of the destination buffer is unspecified.
+inline bool base64Decode(std::string_view Str, void *Out) noexcept {
+  auto &T = detail::Base64;
+  auto Size = Str.size();
+  if (Size > 0 && Str[Size - 1] == detail::Base64Pad) {
+    if (Size % 4 != 0)
+      return false;
+    Size -= Str[Size - 2] == detail::Base64Pad ? 2 : 1;
+  }
+  if (Size % 4 == 1)
+    return false;
+  auto *I = reinterpret_cast<const unsigned char *>(Str.data());
+  auto *EI = I + Size / 4 * 4;
+  auto *O = static_cast<unsigned char *>(Out);
+  // Invalid characters are accumulated and checked once.
+  std::uint8_t Invalid = 0;
+  for (; I != EI; I += 4, O += 3) {
+    auto A = T.Decode[I[0]], B = T.Decode[I[1]];
+    auto C = T.Decode[I[2]], D = T.Decode[I[3]];
+    Invalid |= A | B | C | D;
+    std::uint32_t V = (std::uint32_t(A) << 18) | (std::uint32_t(B) << 12) |
+      (std::uint32_t(C) << 6) | std::uint32_t(D);
+    O[0] = static_cast<unsigned char>(V >> 16);
+    O[1] = static_cast<unsigned char>(V >> 8);
+    O[2] = static_cast<unsigned char>(V);
+  }
+  switch (Size % 4) {
+  case 2: {
+    auto A = T.Decode[I[0]], B = T.Decode[I[1]];
+    Invalid |= A | B;
+    O[0] = static_cast<unsigned char>((A << 2) | ((B & 0x3F) >> 4));
+    break;
+  }
+  case 3: {
+    auto A = T.Decode[I[0]], B = T.Decode[I[1]], C = T.Decode[I[2]];
+    Invalid |= A | B | C;
+    O[0] = static_cast<unsigned char>((A << 2) | ((B & 0x3F) >> 4));
+    O[1] = static_cast<unsigned char>((B << 4) | ((C & 0x3F) >> 2));
+    break;
+  }
+  }
+  return !(Invalid & detail::Base64Invalid);
+}
+
+/// \brief Sequence of bytes.
+///
+/// This is a vector of std::byte which is represented as a base64 string
+/// in JSON.
+template<class Allocator = std::allocator<std::byte>>
+class basic_bytes : public std::vector<std::byte, Allocator> {
+  using BaseT = std::vector<std::byte, Allocator>;
+public:
+  using BaseT::BaseT;
+
+  basic_bytes() = default;
+
+  /// Creates a copy of a specified memory block.
+  basic_bytes(const void *Data, typename BaseT::size_type Size,
+      const Allocator &A = Allocator()) :
+    BaseT(static_cast<const std::byte *>(Data),
+      static_cast<const std::byte *>(Data) + Size, A) {}
+};
+
+/// Sequence of bytes.
+using bytes = basic_bytes<>;
+
+namespace pmr {
+/// Sequence of bytes which uses a polymorphic allocator.
+using bytes = basic_bytes<std::pmr::polymorphic_allocator<std::byte>>;
+}
+}
+#endif//BCL_BASE64_H
@@ -22,22 +22,33 @@
 // errors, etc.).
 // All diagnostics are represented as a string: <Kind> C<Code>(<Pos>): <Fmt>,
 // for example: error C101(100): unexpected character 'c'.
+// Diagnostics which are already formatted (for example, received from another
+// process) can be inserted with insert_text() which does not parse format
+// strings, split() extracts components from a diagnostic.
 //
 //===----------------------------------------------------------------------===//
 
 #ifndef BCL_DIAGNOSTIC_H
 #define BCL_DIAGNOSTIC_H
 
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
-#include <memory>
+#include <limits>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace bcl {
 /// \brief This is a simple container for diagnostics (warnings, errors, etc.).
 ///
-/// All diagnostics are represented as a character string.
+/// All diagnostics are represented as a character string. The strings and
+/// the container itself are allocated from a std::pmr::memory_resource,
+/// so a monotonic buffer resource can be used to avoid heap allocations.
 class Diagnostic {
-  typedef std::vector<std::unique_ptr<const char>> Collection;
+  typedef std::pmr::vector<const char *> Collection;
 
 public:
   typedef const char * value_type;
@@ -59,7 +70,7 @@ private:
 
     iterator_wrapper() = default;
 
-    reference operator*() const { return mCurItr->get(); }
+    reference operator*() const { return *mCurItr; }
     pointer operator->() const { return &operator*(); }
 
     bool operator==(const iterator_wrapper &RHS) const {
@@ -88,15 +99,55 @@ public:
   typedef iterator_wrapper<Collection::const_reverse_iterator> reverse_iterator;
   typedef reverse_iterator const_reverse_iterator;
 
-  /// Constructs container for diagnostics of a specified kind.
-  explicit Diagnostic(const char *Kind) {
-    char *Buf = new char[std::strlen(Kind) + 1];
-    std::strcpy(Buf, Kind);
-    mKind.reset(Buf);
+  /// \brief Constructs container for diagnostics of a specified kind.
+  ///
+  /// All memory is allocated from a specified resource.
+  explicit Diagnostic(const char *Kind,
+      std::pmr::memory_resource *R = std::pmr::get_default_resource()) :
+      mDiagnostics(R) {
+    mKind = copy(Kind);
+  }
+
+  Diagnostic(const Diagnostic &) = delete;
+  Diagnostic & operator=(const Diagnostic &) = delete;
+
+  /// Moves all diagnostics to a new container which uses the same resource.
+  Diagnostic(Diagnostic &&Other) noexcept :
+      mKind(Other.mKind), mDiagnostics(std::move(Other.mDiagnostics)),
+      mInternalError(Other.mInternalError) {
+    Other.mKind = nullptr;
+    Other.mDiagnostics.clear();
+    Other.mInternalError = 0;
+  }
+
+  /// \brief Replaces the contents with the contents of other.
+  ///
+  /// Diagnostics are copied if resources of containers are not equal.
+  Diagnostic & operator=(Diagnostic &&Other) {
+    if (this == &Other)
+      return *this;
+    if (resource()->is_equal(*Other.resource())) {
+      swapEqual(Other);
+      Other.clear();
+    } else {
+      assign(Other);
+      Other.clear();
+    }
+    return *this;
+  }
+
+  ~Diagnostic() {
+    clear();
+    deallocate(mKind);
   }
 
   /// Returns kind of diagnostics.
-  const char * getKind() const noexcept { return mKind.get(); }
+  const char * getKind() const noexcept { return mKind ? mKind : ""; }
+
+  /// Returns memory resource which is used to allocate diagnostics.
+  std::pmr::memory_resource * resource() const noexcept {
+    return mDiagnostics.get_allocator().resource();
+  }
 
   /// \brief Returns an iterator to the first element of the container.
   ///
@@ -165,13 +216,26 @@ public:
   size_type size() const { return mDiagnostics.size(); }
 
   /// Removes all elements from the container including internal errors.
-  void clear() { mDiagnostics.clear(); mInternalError = 0; }
+  void clear() noexcept {
+    for (auto *D : mDiagnostics)
+      deallocate(D);
+    mDiagnostics.clear();
+    mInternalError = 0;
+  }
 
-  /// Exchanges the contents of the container with those of other
+  /// \brief Exchanges the contents of the container with those of other
   /// including internal errors.
+  ///
+  /// Diagnostics are copied if resources of containers are not equal.
   void swap(Diagnostic &Other) {
-    mDiagnostics.swap(Other.mDiagnostics);
-    std::swap(mInternalError, Other.mInternalError);
+    if (resource()->is_equal(*Other.resource())) {
+      swapEqual(Other);
+      return;
+    }
+    Diagnostic Tmp(Other.getKind(), resource());
+    Tmp.assign(Other);
+    Other.assign(*this);
+    swapEqual(Tmp);
   }
 
   /// Returns number of internal erros which have been occurred when
@@ -196,24 +260,177 @@ public:
   template<class... Args>
   bool insert(size_type Code, const char *Fmt, uintmax_t Pos, Args... A) {
     static constexpr const char *PrefixFmt = "%s C%zu(%ju): ";
-    auto PreSize = std::snprintf(nullptr, 0, PrefixFmt, mKind.get(), Code, Pos);
+    auto PreSize = std::snprintf(nullptr, 0, PrefixFmt, getKind(), Code, Pos);
     auto ErrSize = std::snprintf(nullptr, 0, Fmt, A...);
     if (PreSize < 0 || ErrSize < 0) {
       ++mInternalError;
       return false;
     }
-    auto Size = PreSize + ErrSize + 1;
-    char *Buf = new char[Size];
-    if (std::snprintf(Buf, PreSize + 1, PrefixFmt, mKind.get(), Code, Pos) < 0 ||
+    std::size_t Size = PreSize + ErrSize + 1;
+    char *Buf = static_cast<char *>(resource()->allocate(Size, 1));
+    if (std::snprintf(Buf, PreSize + 1, PrefixFmt, getKind(), Code, Pos) < 0 ||
         std::snprintf(Buf + PreSize, ErrSize + 1, Fmt, A...) < 0) {
+      resource()->deallocate(Buf, Size, 1);
       ++mInternalError;
       return false;
     }
-    mDiagnostics.emplace_back(std::unique_ptr<const char>(Buf));
+    // An argument may produce a null character (for example, %c), so the
+    // diagnostic ends there. The buffer is shrunk because the size which is
+    // released by deallocate() is computed from the length of the string.
+    auto Length = std::strlen(Buf) + 1;
+    if (Length < Size) {
+      char *Exact;
+      try {
+        Exact = static_cast<char *>(resource()->allocate(Length, 1));
+      } catch (...) {
+        resource()->deallocate(Buf, Size, 1);
+        throw;
+      }
+      std::memcpy(Exact, Buf, Length);
+      resource()->deallocate(Buf, Size, 1);
+      Buf = Exact;
+      Size = Length;
+    }
+    try {
+      mDiagnostics.push_back(Buf);
+    } catch (...) {
+      resource()->deallocate(Buf, Size, 1);
+      throw;
+    }
     return true;
   }
+
+  /// \brief Inserts new diagnostic with a specified description.
+  ///
+  /// The description is not a format string, so it is copied as is.
+  /// This does not use temporary buffers, the only allocated memory is
+  /// the diagnostic itself.
+  /// \return False if the description contains null characters, nothing is
+  /// inserted in this case.
+  bool insert_text(size_type Code, uintmax_t Pos, std::string_view Msg) {
+    if (Msg.find('\0') != std::string_view::npos)
+      return false;
+    return insert_text(Code, Pos, Msg.size(), [Msg](char *Buf) noexcept {
+      std::memcpy(Buf, Msg.data(), Msg.size());
+    });
+  }
+
+  /// \brief Inserts new diagnostic with a description of a specified size.
+  ///
+  /// The Write(char *Buf) function must write exactly Size characters of the
+  /// description to a buffer which is allocated for the diagnostic. So, it is
+  /// possible to convert description directly into the container storage.
+  /// \return False if the written description contains null characters,
+  /// nothing is inserted in this case.
+  template<class WriterT>
+  bool insert_text(size_type Code, uintmax_t Pos, std::size_t Size,
+      WriterT &&Write) {
+    char CodeBuf[std::numeric_limits<size_type>::digits10 + 1];
+    char PosBuf[std::numeric_limits<uintmax_t>::digits10 + 1];
+    auto CodeEnd = std::to_chars(CodeBuf, CodeBuf + sizeof(CodeBuf), Code).ptr;
+    auto PosEnd = std::to_chars(PosBuf, PosBuf + sizeof(PosBuf), Pos).ptr;
+    auto KindSize = std::strlen(getKind());
+    auto CodeSize = static_cast<std::size_t>(CodeEnd - CodeBuf);
+    auto PosSize = static_cast<std::size_t>(PosEnd - PosBuf);
+    auto PreSize = KindSize + CodeSize + PosSize + 6;
+    auto BufSize = PreSize + Size + 1;
+    char *Buf = static_cast<char *>(resource()->allocate(BufSize, 1));
+    char *I = Buf;
+    auto append = [&I](const char *Str, std::size_t StrSize) {
+      std::memcpy(I, Str, StrSize);
+      I += StrSize;
+    };
+    append(getKind(), KindSize);
+    append(" C", 2);
+    append(CodeBuf, CodeSize);
+    append("(", 1);
+    append(PosBuf, PosSize);
+    append("): ", 3);
+    try {
+      Write(I);
+      if (std::memchr(I, '\0', Size)) {
+        resource()->deallocate(Buf, BufSize, 1);
+        return false;
+      }
+      I[Size] = '\0';
+      mDiagnostics.push_back(Buf);
+    } catch (...) {
+      resource()->deallocate(Buf, BufSize, 1);
+      throw;
+    }
+    return true;
+  }
+
+  /// Components of a diagnostic <Kind> C<Code>(<Pos>): <Message>.
+  struct Components {
+    std::string_view Kind;
+    size_type Code = 0;
+    uintmax_t Pos = 0;
+    std::string_view Message;
+  };
+
+  /// \brief Splits a specified diagnostic into components.
+  ///
+  /// Kind may contain spaces, so it is separated from a message with the
+  /// first occurrence of " C<Code>(<Pos>): ". Components refer to the
+  /// specified string.
+  /// \return False if a string does not match the format of diagnostics.
+  static bool split(std::string_view D, Components &C) noexcept {
+    auto *EI = D.data() + D.size();
+    for (auto I = D.find(" C"); I != std::string_view::npos;
+         I = D.find(" C", I + 1)) {
+      auto CodeRes = std::from_chars(D.data() + I + 2, EI, C.Code);
+      if (CodeRes.ec != std::errc() || CodeRes.ptr == EI ||
+          *CodeRes.ptr != '(')
+        continue;
+      auto PosRes = std::from_chars(CodeRes.ptr + 1, EI, C.Pos);
+      if (PosRes.ec != std::errc() || EI - PosRes.ptr < 3 ||
+          std::memcmp(PosRes.ptr, "): ", 3) != 0)
+        continue;
+      C.Kind = D.substr(0, I);
+      C.Message = D.substr(PosRes.ptr + 3 - D.data());
+      return true;
+    }
+    return false;
+  }
 private:
-  std::unique_ptr<const char> mKind;
+  /// Copies a null-terminated string to the resource of this container.
+  const char * copy(const char *Str) {
+    auto Size = std::strlen(Str) + 1;
+    auto *Buf = static_cast<char *>(resource()->allocate(Size, 1));
+    std::memcpy(Buf, Str, Size);
+    return Buf;
+  }
+
+  /// \brief Releases a string allocated in the resource of this container.
+  ///
+  /// The size of the allocation is the length of the string, so each stored
+  /// string must not contain null characters before its end.
+  void deallocate(const char *Str) noexcept {
+    if (Str)
+      resource()->deallocate(const_cast<char *>(Str), std::strlen(Str) + 1, 1);
+  }
+
+  /// Replaces the contents with copies of diagnostics from other.
+  void assign(const Diagnostic &Other) {
+    clear();
+    auto *Kind = copy(Other.getKind());
+    deallocate(mKind);
+    mKind = Kind;
+    mDiagnostics.reserve(Other.size());
+    for (auto *D : Other.mDiagnostics)
+      mDiagnostics.push_back(copy(D));
+    mInternalError = Other.mInternalError;
+  }
+
+  /// Exchanges the contents of containers which use equal resources.
+  void swapEqual(Diagnostic &Other) noexcept {
+    std::swap(mKind, Other.mKind);
+    mDiagnostics.swap(Other.mDiagnostics);
+    std::swap(mInternalError, Other.mInternalError);
+  }
+
+  const char *mKind = nullptr;
   Collection mDiagnostics;
   size_type mInternalError = 0;
 };
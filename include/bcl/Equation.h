@@ -25,10 +25,20 @@
 #ifndef BCL_EQUATION_H
 #define BCL_EQUATION_H
 
+#include "Trace.h"
 #include <assert.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <numeric>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace milp {
@@ -219,13 +229,71 @@ private:
 };
 
 namespace detail {
+/// Compute GCD of two non-negative integer numbers and coefficients X and Y
+/// such as GCD = X * LHS + Y * RHS without recursion.
 template<typename IntT>
-std::tuple<IntT, IntT, IntT> euclidGCD(IntT LHS, IntT RHS) {
-  if (RHS == 0)
-    return std::make_tuple(LHS, 1, 0);
-  auto Res = euclidGCD(RHS, LHS % RHS);
-  return std::make_tuple(std::get<0>(Res), std::get<2>(Res),
-    std::get<1>(Res) - LHS / RHS * std::get<2>(Res));
+IntT extendedGCD(IntT LHS, IntT RHS, IntT &X, IntT &Y) noexcept {
+  IntT NextX = 0, NextY = 1;
+  X = 1;
+  Y = 0;
+  while (RHS != 0) {
+    auto Q = LHS / RHS;
+    auto R = LHS - Q * RHS;
+    LHS = RHS;
+    RHS = R;
+    auto TmpX = X - Q * NextX;
+    X = NextX;
+    NextX = TmpX;
+    auto TmpY = Y - Q * NextY;
+    Y = NextY;
+    NextY = TmpY;
+  }
+  return LHS;
+}
+
+/// Compute GCD of two non-negative integer numbers.
+///
+/// \return GCD and two coefficients X and Y such as GCD = X * LHS + Y * RHS.
+template<typename IntT>
+std::tuple<IntT, IntT, IntT> euclidGCD(IntT LHS, IntT RHS) noexcept {
+  IntT X, Y;
+  auto GCD = extendedGCD(LHS, RHS, X, Y);
+  return std::make_tuple(GCD, X, Y);
+}
+
+/// Return true if a product of two integer numbers overflows.
+template<typename IntT> bool isMulOverflow(IntT LHS, IntT RHS) noexcept {
+#if defined __GNUC__
+  IntT Res;
+  return __builtin_mul_overflow(LHS, RHS, &Res);
+#else
+  using Limits = std::numeric_limits<IntT>;
+  if (LHS == 0 || RHS == 0)
+    return false;
+  if (LHS > 0)
+    return RHS > 0 ? LHS > Limits::max() / RHS : RHS < Limits::min() / LHS;
+  return RHS > 0 ? LHS < Limits::min() / RHS : LHS < Limits::max() / RHS;
+#endif
+}
+
+/// Return true if a difference of two integer numbers overflows.
+template<typename IntT> bool isSubOverflow(IntT LHS, IntT RHS) noexcept {
+#if defined __GNUC__
+  IntT Res;
+  return __builtin_sub_overflow(LHS, RHS, &Res);
+#else
+  using Limits = std::numeric_limits<IntT>;
+  return RHS < 0 ? LHS > Limits::max() + RHS : LHS < Limits::min() + RHS;
+#endif
+}
+
+/// Return magnitude of an integer number, it is representable for the
+/// minimum value of signed types.
+template<typename IntT>
+typename std::make_unsigned<IntT>::type magnitude(IntT V) noexcept {
+  using UnsignedT = typename std::make_unsigned<IntT>::type;
+  return V < 0 ? UnsignedT(0) - static_cast<UnsignedT>(V)
+               : static_cast<UnsignedT>(V);
 }
 }
 
@@ -242,6 +310,23 @@ std::tuple<IntT, IntT, IntT> euclidGCD(IntT LHS, IntT RHS) {
   return Res;
 }
 
+/// Strategy which determines the order of equations to eliminate in
+/// BinomialSystem::solve().
+///
+/// Each substitution multiplies coefficients, so the order of elimination
+/// affects growth of coefficients and a number of rewritten equations.
+enum class PivotOrder : std::uint8_t {
+  /// Equations are eliminated in the order of insertion.
+  Natural,
+  /// An equation with the smallest maximum magnitude of its current
+  /// coefficients is eliminated first.
+  SmallestCoefficient,
+  /// An equation which variables occur in the smallest number of other
+  /// equations is eliminated first. The order is computed before
+  /// elimination on the graph of variable occurrences.
+  MinDegree,
+};
+
 /// This is a system of binomial affine equations with integer constants.
 ///
 /// Each equation may have guards and computable monomials.
@@ -262,6 +347,9 @@ std::tuple<IntT, IntT, IntT> euclidGCD(IntT LHS, IntT RHS) {
 /// parameter that was previously introduces with parameterColumn() methods,
 /// - std::string name(ColumnT) returns string representation of a specified
 /// variable.
+///
+/// The order of elimination may be changed with setPivotOrder(), statistics
+/// of coefficients are available after solve() (see getStats()).
 template<typename ColumnT, typename ValueT,
   std::size_t GuardN, std::size_t InverseGuardN, std::size_t ComputedMonomN>
 class BinomialSystem {
@@ -301,6 +389,23 @@ class BinomialSystem {
           * = nullptr) {}
 
 public:
+  using MagnitudeT = typename std::make_unsigned<ValueT>::type;
+
+  /// Statistics of coefficients which are collected by solve().
+  struct Stats {
+    /// Number of equations which are solved by substitutions after presolve.
+    std::size_t NumPivots = 0;
+    /// Number of monomials which are rewritten by substitutions.
+    std::size_t NumUpdates = 0;
+    /// Number of operations on coefficients and constants which overflow.
+    std::size_t NumOverflows = 0;
+    /// Maximum magnitude of coefficients and constants before elimination.
+    MagnitudeT MaxInitialMagnitude = 0;
+    /// Maximum magnitude of coefficients and constants which are computed
+    /// during elimination.
+    MagnitudeT MaxMagnitude = 0;
+  };
+
   template <typename ColumnInfoT, typename StreamT>
   static void printEquation(const EquationT &Row, const ColumnInfoT &Info,
                        StreamT &OS) {
@@ -350,25 +455,76 @@ public:
     return mRows.begin() + mInstantiatedSize;
   }
 
+  /// Set strategy which determines the order of elimination in solve().
+  void setPivotOrder(PivotOrder Order) noexcept { mPivotOrder = Order; }
+
+  /// Return strategy which determines the order of elimination in solve().
+  PivotOrder getPivotOrder() const noexcept { return mPivotOrder; }
+
   /// Solve the instantiated part of the system
   ///
+  /// At first, equations with a single variable, duplicates and multiples of
+  /// other equations are solved or removed (see presolve()). Substitutions
+  /// are performed for the remaining equations only, they are eliminated in
+  /// the order which is determined by the pivot order strategy. Presolve is
+  /// skipped for a system of a single equation, it has nothing to propagate
+  /// or deduplicate there.
+  ///
+  /// A variable which is not constrained by the system, for example `y` in
+  /// `x + 0 * y = 1`, is omitted from the solution (see getSolution()).
+  /// Earlier versions returned `y = t` for such variable, where `t` is
+  /// a parameter.
   /// \tparam IsSolvable If it is `true`, assume that the system always has a
   /// solution.
   /// \tparam StreamT Enable logging, if it is specified.
   /// \pre The system was has been instantiated.
-  /// \return A number of successfully solved equations.
+  /// \return A number of successfully solved equations, it is less than
+  /// a number of instantiated equations if the system has no solution.
   template <class ColumnInfoT, bool IsSolvable = true,
             typename StreamT = const UndefT>
   std::size_t solve(ColumnInfoT &Info, StreamT &OS = Undef) {
-    for (std::size_t I = 0; I < mInstantiatedSize; ++I) {
+    BCL_TRACE_SCOPE("milp::BinomialSystem::solve");
+    mStats = Stats();
+    std::size_t CoreSize;
+    bool IsFeasible;
+    if (mInstantiatedSize < MinPresolveSize)
+      std::tie(CoreSize, IsFeasible) = std::make_pair(mInstantiatedSize, true);
+    else
+      std::tie(CoreSize, IsFeasible) = presolve(Info, OS);
+    if (!IsSolvable && !IsFeasible)
+      return 0;
+    assert(IsFeasible && "Equation must have solution!");
+    auto PresolvedSize = mInstantiatedSize - CoreSize;
+    for (std::size_t I = 0; I < CoreSize; ++I) {
+      auto &Row = mRows[mIdx[I]];
+      mStats.MaxInitialMagnitude = std::max({mStats.MaxInitialMagnitude,
+        detail::magnitude(Row.LHS.Value), detail::magnitude(Row.RHS.Value),
+        detail::magnitude(Row.Constant)});
+    }
+    mStats.MaxMagnitude =
+      std::max(mStats.MaxMagnitude, mStats.MaxInitialMagnitude);
+    mStats.NumPivots = CoreSize;
+    if (mPivotOrder == PivotOrder::MinDegree)
+      orderByDegree(CoreSize);
+    for (std::size_t I = 0; I < CoreSize; ++I) {
+      if (mPivotOrder == PivotOrder::SmallestCoefficient)
+        selectSmallestCoefficient(I, CoreSize);
       auto &Row = mRows[mIdx[I]];
+      // Substitutions may produce monomials with the same variable, so they
+      // are merged at first. Equation 0 = 0 does not constrain variables.
+      auto Kind = normalize(Row);
+      if (!IsSolvable && !Kind.second)
+        return PresolvedSize + I;
+      assert(Kind.second && "Equation must have solution!");
+      if (Kind.first == RowKind::Removed)
+        continue;
       // We want to solve binomial equation A * X + B * Y = C
       // 1. Find GCD and two coefficients X' and Y' such as GCD = A * X' + B * Y'
       auto GCD = euclidGCD(Row.LHS.Value, Row.RHS.Value);
       log("> solve:\n", OS);
       logEquation(Row, Info, OS);
       if (!IsSolvable && Row.Constant % std::get<0>(GCD))
-        return I;
+        return PresolvedSize + I;
       assert(Row.Constant % std::get<0>(GCD) == 0 &&
         "Equation must have solution!");
       // 2. It is known that linear equation has solution if GCD of coefficients
@@ -379,6 +535,8 @@ public:
       //     ----------------------------------------
       // So: A * (X' * Q) + B * (Y' * Q) = GCD *Q = C
       // We find one of possible solutions: (X' * Q, Y' * Q)
+      mStats.NumOverflows += detail::isMulOverflow(Q, std::get<1>(GCD)) +
+        detail::isMulOverflow(Q, std::get<2>(GCD));
       auto AnySolution =
         std::make_pair(Q * std::get<1>(GCD), Q * std::get<2>(GCD));
       auto ParameterCol = Info.parameterColumn();
@@ -389,45 +547,46 @@ public:
       // So, the solution of the original equation is:
       // X = (X' * Q) - (B / GCD) * T
       // Y = (Y' * Q) + (A / GCD) * T, where T is any integer value.
-      mSolution.emplace_back(Row.LHS.Column, 1,
-        ParameterCol, Row.RHS.Value / std::get<0>(GCD), AnySolution.first);
-      mSolution.emplace_back(Row.RHS.Column, 1,
-        ParameterCol, - Row.LHS.Value / std::get<0>(GCD), AnySolution.second);
-      auto &SolutionLHS = mSolution[mSolution.size() - 1];
-      auto &SolutionRHS = mSolution[mSolution.size() - 2];
+      // A variable with zero coefficient is not constrained by the equation,
+      // so its solution is not built.
+      auto FirstSolution = mSolution.size();
+      if (Row.LHS.Value != 0)
+        mSolution.emplace_back(Row.LHS.Column, 1,
+          ParameterCol, Row.RHS.Value / std::get<0>(GCD), AnySolution.first);
+      if (Row.RHS.Value != 0)
+        mSolution.emplace_back(Row.RHS.Column, 1,
+          ParameterCol, - Row.LHS.Value / std::get<0>(GCD),
+          AnySolution.second);
+      auto LastSolution = mSolution.size();
       log("> solution:\n", OS);
-      logEquation(SolutionLHS, Info, OS);
-      logEquation(SolutionRHS, Info, OS);
-      auto updateRow = [](const EquationT &Solution, ValueT &Constant,
-          typename RowT::Monom &M) {
-        if (M.Column == Solution.LHS.Column) {
-          M.Column = Solution.RHS.Column;
-          Constant = Constant - Solution.Constant * M.Value;
-          M.Value = -(M.Value * Solution.RHS.Value);
-        }
-      };
+      for (std::size_t K = FirstSolution; K < LastSolution; ++K)
+        logEquation(mSolution[K], Info, OS);
       log("> update rows:\n", OS);
-      for (std::size_t J = I + 1; J < mInstantiatedSize; ++J) {
+      BCL_TRACE_SCOPE("milp::BinomialSystem::solve::update");
+      for (std::size_t J = I + 1; J < CoreSize; ++J) {
         auto &RowToUpdate = mRows[mIdx[J]];
         logEquation(RowToUpdate, Info, OS);
-        updateRow(SolutionLHS, RowToUpdate.Constant, RowToUpdate.LHS);
-        updateRow(SolutionLHS, RowToUpdate.Constant, RowToUpdate.RHS);
-        updateRow(SolutionRHS, RowToUpdate.Constant, RowToUpdate.LHS);
-        updateRow(SolutionRHS, RowToUpdate.Constant, RowToUpdate.RHS);
+        for (std::size_t K = FirstSolution; K < LastSolution; ++K) {
+          updateRow(mSolution[K], RowToUpdate.Constant, RowToUpdate.LHS);
+          updateRow(mSolution[K], RowToUpdate.Constant, RowToUpdate.RHS);
+        }
         logEquation(RowToUpdate, Info, OS);
       }
       log("> update solution:\n", OS);
-      for (std::size_t J = 0, EJ = mSolution.size() - 2; J < EJ; ++J) {
+      for (std::size_t J = 0; J < FirstSolution; ++J) {
         auto &SolutionToUpdate = mSolution[J];
         logEquation(SolutionToUpdate, Info, OS);
-        updateRow(SolutionLHS, SolutionToUpdate.Constant, SolutionToUpdate.LHS);
-        updateRow(SolutionLHS, SolutionToUpdate.Constant, SolutionToUpdate.RHS);
-        updateRow(SolutionRHS, SolutionToUpdate.Constant, SolutionToUpdate.LHS);
-        updateRow(SolutionRHS, SolutionToUpdate.Constant, SolutionToUpdate.RHS);
+        for (std::size_t K = FirstSolution; K < LastSolution; ++K) {
+          updateRow(mSolution[K], SolutionToUpdate.Constant,
+            SolutionToUpdate.LHS);
+          updateRow(mSolution[K], SolutionToUpdate.Constant,
+            SolutionToUpdate.RHS);
+        }
         logEquation(SolutionToUpdate, Info, OS);
       }
     }
     // Now, we exclude all equations without original variables.
+    BCL_TRACE_SCOPE("milp::BinomialSystem::solve::exclude");
     std::size_t SignificantSize = mSolution.size();
     for (std::size_t I = 0; I < SignificantSize;) {
       if (Info.isParameter(mSolution[I].LHS.Column) &&
@@ -442,6 +601,8 @@ public:
     return mInstantiatedSize;
   }
 
+  /// Return solution which is built by solve(), it contains variables which
+  /// are constrained by the system only.
   const std::vector<EquationT> &getSolution() const noexcept {
     return mSolution;
   }
@@ -505,6 +666,7 @@ public:
   void instantiate(const ColumnInfoT &Info) {
     assert(mRows.size() == mIdx.size() && "Storage has been corrupted!");
     assert(!isInstantiated() && "System was already instantiated!");
+    BCL_TRACE_SCOPE("milp::BinomialSystem::instantiate");
     mIsInstantiated = true;
     mInstantiatedSize = mIdx.size();
     for (std::size_t I = 0; I < mInstantiatedSize;) {
@@ -581,13 +743,771 @@ public:
     }
   }
 
+  /// Return statistics of coefficients which are collected by the last
+  /// call of solve().
+  const Stats &getStats() const noexcept { return mStats; }
+
 private:
+  /// Substitute a solution `x + b * t = c` of a variable `x` into a monomial.
+  void updateRow(const EquationT &Solution, ValueT &Constant,
+                 typename RowT::Monom &M) {
+    if (M.Column == Solution.LHS.Column) {
+      ++mStats.NumUpdates;
+      if (detail::isMulOverflow(Solution.Constant, M.Value) ||
+          detail::isSubOverflow(Constant, Solution.Constant * M.Value))
+        ++mStats.NumOverflows;
+      if (detail::isMulOverflow(M.Value, Solution.RHS.Value))
+        ++mStats.NumOverflows;
+      M.Column = Solution.RHS.Column;
+      Constant = Constant - Solution.Constant * M.Value;
+      M.Value = -(M.Value * Solution.RHS.Value);
+      mStats.MaxMagnitude = std::max({mStats.MaxMagnitude,
+        detail::magnitude(Constant), detail::magnitude(M.Value)});
+    }
+  }
+
+  /// Move an equation with the smallest maximum magnitude of coefficients
+  /// among equations [I, CoreSize) to the I-th position.
+  void selectSmallestCoefficient(std::size_t I, std::size_t CoreSize) {
+    auto getMagnitude = [this](std::size_t Idx) {
+      auto &Row = mRows[Idx];
+      return std::max(detail::magnitude(Row.LHS.Value),
+        detail::magnitude(Row.RHS.Value));
+    };
+    auto Min = I;
+    auto MinMagnitude = getMagnitude(mIdx[I]);
+    for (std::size_t J = I + 1; J < CoreSize; ++J) {
+      auto Magnitude = getMagnitude(mIdx[J]);
+      if (Magnitude < MinMagnitude) {
+        Min = J;
+        MinMagnitude = Magnitude;
+      }
+    }
+    std::swap(mIdx[I], mIdx[Min]);
+  }
+
+  /// Reorder equations [0, CoreSize) in the order of minimum degree.
+  ///
+  /// Degree of an equation is a number of occurrences of its variables in
+  /// other equations, these equations are rewritten when the equation is
+  /// eliminated. Elimination is simulated on the graph of variable
+  /// occurrences: both variables of an eliminated equation are replaced with
+  /// a new parameter, so they are merged.
+  void orderByDegree(std::size_t CoreSize) {
+    BCL_TRACE_SCOPE("milp::BinomialSystem::orderByDegree");
+    // Dense identifiers of variables and union-find forest of merged
+    // variables.
+    std::unordered_map<ColumnT, std::size_t> Ids;
+    Ids.reserve(2 * CoreSize);
+    std::vector<std::size_t> Parent, Degree;
+    std::vector<std::pair<std::size_t, std::size_t>> Vars(CoreSize);
+    auto getId = [&Ids, &Parent, &Degree](const ColumnT &C) {
+      auto Res = Ids.emplace(C, Parent.size());
+      if (Res.second) {
+        Parent.push_back(Parent.size());
+        Degree.push_back(0);
+      }
+      ++Degree[Res.first->second];
+      return Res.first->second;
+    };
+    for (std::size_t I = 0; I < CoreSize; ++I) {
+      auto &Row = mRows[mIdx[I]];
+      Vars[I] = std::make_pair(getId(Row.LHS.Column), getId(Row.RHS.Column));
+    }
+    auto find = [&Parent](std::size_t Id) {
+      while (Parent[Id] != Id)
+        Id = Parent[Id] = Parent[Parent[Id]];
+      return Id;
+    };
+    std::vector<std::size_t> Order(CoreSize);
+    std::iota(Order.begin(), Order.end(), 0);
+    for (std::size_t I = 0; I < CoreSize; ++I) {
+      std::size_t Min = I, MinDegree = 0;
+      for (std::size_t J = I; J < CoreSize; ++J) {
+        auto L = find(Vars[Order[J]].first), R = find(Vars[Order[J]].second);
+        auto D = L == R ? Degree[L] : Degree[L] + Degree[R];
+        if (J == I || D < MinDegree) {
+          Min = J;
+          MinDegree = D;
+        }
+      }
+      std::swap(Order[I], Order[Min]);
+      auto L = find(Vars[Order[I]].first), R = find(Vars[Order[I]].second);
+      if (L != R) {
+        Parent[R] = L;
+        Degree[L] += Degree[R];
+      }
+      Degree[L] -= 2;
+    }
+    std::vector<std::size_t> Idx(CoreSize);
+    for (std::size_t I = 0; I < CoreSize; ++I)
+      Idx[I] = mIdx[Order[I]];
+    std::copy(Idx.begin(), Idx.end(), mIdx.begin());
+  }
+
+  /// Minimum number of instantiated equations to run presolve.
+  static constexpr std::size_t MinPresolveSize = 2;
+
+  /// Kind of an instantiated equation which is determined by presolve.
+  enum class RowKind : std::uint8_t {
+    Binomial,   // Both coefficients are not zero.
+    Monomial,   // A single coefficient is not zero.
+    Removed,    // Equation is solved or implied by other equations.
+  };
+
+  /// Canonical form of an equation `a * x + b * y = c`, where `x < y`,
+  /// `a > 0` and GCD(a, b) = 1.
+  using RowKey = std::tuple<ColumnT, ValueT, ColumnT, ValueT>;
+
+  struct RowKeyHash {
+    std::size_t operator()(const RowKey &K) const {
+      std::size_t Hash = std::hash<ColumnT>()(std::get<0>(K));
+      auto combine = [&Hash](std::size_t V) {
+        Hash ^= V + 0x9e3779b9 + (Hash << 6) + (Hash >> 2);
+      };
+      combine(std::hash<ValueT>()(std::get<1>(K)));
+      combine(std::hash<ColumnT>()(std::get<2>(K)));
+      combine(std::hash<ValueT>()(std::get<3>(K)));
+      return Hash;
+    }
+  };
+
+  /// Merge monomials with the same variable and divide an equation by GCD
+  /// of its coefficients.
+  ///
+  /// \return Kind of the equation and false if the equation has no integer
+  /// solution.
+  static std::pair<RowKind, bool> normalize(RowT &Row) {
+    if (Row.LHS.Column == Row.RHS.Column && Row.RHS.Value != 0) {
+      Row.LHS.Value += Row.RHS.Value;
+      Row.RHS.Value = 0;
+    }
+    if (Row.LHS.Value == 0 && Row.RHS.Value == 0)
+      return std::make_pair(RowKind::Removed, Row.Constant == 0);
+    auto GCD = std::get<0>(euclidGCD(Row.LHS.Value, Row.RHS.Value));
+    if (Row.Constant % GCD != 0)
+      return std::make_pair(RowKind::Removed, false);
+    Row.LHS.Value /= GCD;
+    Row.RHS.Value /= GCD;
+    Row.Constant /= GCD;
+    return std::make_pair(Row.LHS.Value == 0 || Row.RHS.Value == 0 ?
+      RowKind::Monomial : RowKind::Binomial, true);
+  }
+
+  /// Build canonical form of a normalized binomial equation.
+  static std::pair<RowKey, ValueT> canonical(const RowT &Row) {
+    auto L = Row.LHS, R = Row.RHS;
+    if (R.Column < L.Column)
+      std::swap(L, R);
+    auto Sign = L.Value < 0 ? -1 : 1;
+    return std::make_pair(
+      RowKey(L.Column, Sign * L.Value, R.Column, Sign * R.Value),
+      Sign * Row.Constant);
+  }
+
+  /// Simplify the instantiated part of the system before substitutions.
+  ///
+  /// The following equations are solved or removed:
+  /// - equations with a single variable (after merging of monomials with the
+  ///   same variable) are solved immediately, the value is substituted into
+  ///   other equations which may become equations with a single variable;
+  ///   a variable with zero coefficient is not constrained by such equation,
+  ///   so the solution does not contain it unless other equations do,
+  /// - duplicates and scalar multiples of other equations are removed,
+  ///   equations are divided by GCD of coefficients and then compared in the
+  ///   canonical form.
+  /// Remaining equations are moved to the beginning of the instantiated part,
+  /// their relative order is preserved.
+  /// \return Number of remaining equations and false if the system has no
+  /// integer solution.
+  template <class ColumnInfoT, typename StreamT>
+  std::pair<std::size_t, bool> presolve(ColumnInfoT &Info, StreamT &OS) {
+    BCL_TRACE_SCOPE("milp::BinomialSystem::presolve");
+    log("> presolve:\n", OS);
+    std::vector<RowKind> Kinds(mInstantiatedSize);
+    std::vector<std::size_t> Worklist;
+    // Variables of binomial equations, they are sorted to find equations
+    // which contain a variable with a known value.
+    std::vector<std::pair<ColumnT, std::size_t>> Occurrences;
+    Occurrences.reserve(2 * mInstantiatedSize);
+    for (std::size_t I = 0; I < mInstantiatedSize; ++I) {
+      auto &Row = mRows[mIdx[I]];
+      bool IsFeasible;
+      std::tie(Kinds[I], IsFeasible) = normalize(Row);
+      if (!IsFeasible) {
+        logEquation(Row, Info, OS);
+        return std::make_pair(mInstantiatedSize, false);
+      }
+      if (Kinds[I] == RowKind::Monomial) {
+        Worklist.push_back(I);
+      } else if (Kinds[I] == RowKind::Binomial) {
+        Occurrences.emplace_back(Row.LHS.Column, I);
+        Occurrences.emplace_back(Row.RHS.Column, I);
+      }
+    }
+    auto OccurrenceLess = [](const std::pair<ColumnT, std::size_t> &LHS,
+                             const std::pair<ColumnT, std::size_t> &RHS) {
+      return LHS.first < RHS.first;
+    };
+    std::stable_sort(Occurrences.begin(), Occurrences.end(), OccurrenceLess);
+    // Values of variables which were found at presolve.
+    std::unordered_map<ColumnT, ValueT> Pinned;
+    for (std::size_t W = 0; W < Worklist.size(); ++W) {
+      auto I = Worklist[W];
+      if (Kinds[I] == RowKind::Removed)
+        continue;
+      auto &Row = mRows[mIdx[I]];
+      Kinds[I] = RowKind::Removed;
+      auto &M = Row.LHS.Value != 0 ? Row.LHS : Row.RHS;
+      if (M.Value == 0) {
+        // All variables have been substituted.
+        if (Row.Constant != 0)
+          return std::make_pair(mInstantiatedSize, false);
+        continue;
+      }
+      if (Row.Constant % M.Value != 0)
+        return std::make_pair(mInstantiatedSize, false);
+      auto Value = Row.Constant / M.Value;
+      auto PinnedInfo = Pinned.emplace(M.Column, Value);
+      if (!PinnedInfo.second) {
+        if (PinnedInfo.first->second != Value)
+          return std::make_pair(mInstantiatedSize, false);
+        continue;
+      }
+      log("> solve:\n", OS);
+      logEquation(Row, Info, OS);
+      mSolution.emplace_back(M.Column, 1, Info.parameterColumn(), 0, Value);
+      auto &Solution = mSolution.back();
+      log("> solution:\n", OS);
+      logEquation(Solution, Info, OS);
+      auto Range = std::equal_range(Occurrences.begin(), Occurrences.end(),
+        std::make_pair(Solution.LHS.Column, std::size_t(0)), OccurrenceLess);
+      for (auto Itr = Range.first; Itr != Range.second; ++Itr) {
+        auto J = Itr->second;
+        if (Kinds[J] == RowKind::Removed)
+          continue;
+        auto &RowToUpdate = mRows[mIdx[J]];
+        updateRow(Solution, RowToUpdate.Constant, RowToUpdate.LHS);
+        updateRow(Solution, RowToUpdate.Constant, RowToUpdate.RHS);
+        bool IsFeasible;
+        std::tie(Kinds[J], IsFeasible) = normalize(RowToUpdate);
+        if (!IsFeasible)
+          return std::make_pair(mInstantiatedSize, false);
+        if (Kinds[J] == RowKind::Monomial)
+          Worklist.push_back(J);
+      }
+    }
+    // The hash table is not built if there is nothing to compare.
+    auto NumBinomials = std::count(Kinds.begin(), Kinds.end(),
+      RowKind::Binomial);
+    std::unordered_map<RowKey, ValueT, RowKeyHash> Unique;
+    if (NumBinomials > 1)
+      Unique.reserve(NumBinomials);
+    for (std::size_t I = 0; NumBinomials > 1 && I < mInstantiatedSize; ++I) {
+      if (Kinds[I] != RowKind::Binomial)
+        continue;
+      auto Canonical = canonical(mRows[mIdx[I]]);
+      auto Res = Unique.emplace(Canonical);
+      if (Res.second)
+        continue;
+      if (Res.first->second != Canonical.second)
+        return std::make_pair(mInstantiatedSize, false);
+      Kinds[I] = RowKind::Removed;
+    }
+    std::size_t CoreSize = 0;
+    for (std::size_t I = 0; I < mInstantiatedSize; ++I)
+      if (Kinds[I] == RowKind::Binomial)
+        std::swap(mIdx[CoreSize++], mIdx[I]);
+    return std::make_pair(CoreSize, true);
+  }
+
   std::vector<RowT> mRows;
   std::vector<std::size_t> mIdx;
   std::vector<EquationT> mSolution;
   bool mIsInstantiated = false;
   std::size_t mInstantiatedSize = 0;
+  PivotOrder mPivotOrder = PivotOrder::Natural;
+  Stats mStats;
 };
 
+
+/// This is a batch of small independent systems of binomial affine equations
+/// with integer constants.
+///
+/// This is an alternative to BinomialSystem for a large number of systems
+/// which have at most MaxRowN equations each and do not have guards and
+/// computable monomials. Equations of all systems are stored in a flat buffer.
+/// Systems are solved in lockstep by blocks: equations of a block are
+/// transposed to a structure-of-arrays form, where for each position of an
+/// equation in a system there are separate arrays of variables, coefficients
+/// and constants which are indexed by a system. So, each step of the algorithm
+/// is a loop over contiguous arrays and memory is allocated only if the batch
+/// grows.
+///
+/// Variables of each system are mapped to local columns [0, 2 * MaxRowN).
+/// A parameter which is introduced when I-th equation in a system is solved
+/// is a local column 2 * MaxRowN + I. Solutions of all systems are stored in
+/// a flat buffer, use solution_begin() and solution_end() to access solution
+/// of a system and column() to obtain original variables.
+template<typename ColumnT, typename ValueT, std::size_t MaxRowN = 8>
+class BinomialBatch {
+public:
+  using LocalColumnT = std::uint8_t;
+  using EquationT = BAEquation<LocalColumnT, ValueT>;
+  using MonomT = typename BAEquation<ColumnT, ValueT>::Monom;
+
+  /// Maximum number of variables in a system.
+  static constexpr std::size_t MaxColumnN = 2 * MaxRowN;
+
+  static_assert(MaxRowN > 0 && MaxColumnN + MaxRowN < UINT8_MAX,
+    "Unsupported number of equations in a system!");
+
+  /// Return true if a specified local column is a parameter.
+  static constexpr bool isParameter(LocalColumnT C) noexcept {
+    return C >= MaxColumnN;
+  }
+
+  /// Add a new empty system to the batch and return its index.
+  std::size_t addSystem() {
+    mEquationBegin.push_back(mEquations.size());
+    mColumnBegin.push_back(mColumns.size());
+    return mEquationBegin.size() - 1;
+  }
+
+  /// Add new equation to the last system in the batch.
+  void push_back(MonomT LHS, MonomT RHS, ValueT Constant) {
+    assert(!empty() && "Batch must not be empty!");
+    assert(mEquations.size() - mEquationBegin.back() < MaxRowN &&
+      "Too many equations in a system!");
+    auto LHSColumn = local(LHS.Column);
+    auto RHSColumn = local(RHS.Column);
+    mEquations.emplace_back(
+      LHSColumn, LHS.Value, RHSColumn, RHS.Value, Constant);
+  }
+
+  /// Return number of systems in the batch.
+  std::size_t size() const noexcept { return mEquationBegin.size(); }
+
+  /// Return true if the batch is empty.
+  bool empty() const noexcept { return mEquationBegin.empty(); }
+
+  /// Return number of equations in a specified system.
+  std::size_t size(std::size_t S) const noexcept {
+    return (S + 1 < size() ? mEquationBegin[S + 1] : mEquations.size()) -
+      mEquationBegin[S];
+  }
+
+  /// Reserve memory for a specified number of systems.
+  void reserve(std::size_t N) {
+    mEquationBegin.reserve(N);
+    mColumnBegin.reserve(N);
+  }
+
+  /// Remove all systems, allocated memory is not released.
+  void clear() noexcept {
+    mEquations.clear();
+    mEquationBegin.clear();
+    mColumns.clear();
+    mColumnBegin.clear();
+    mSolution.clear();
+    mSolutionBegin.clear();
+    mIsSolved.clear();
+  }
+
+  /// Return a variable which is represented with a specified local column
+  /// in a specified system.
+  ColumnT column(std::size_t S, LocalColumnT C) const noexcept {
+    assert(!isParameter(C) && "Parameter does not have a variable!");
+    assert(mColumnBegin[S] + C <
+      (S + 1 < size() ? mColumnBegin[S + 1] : mColumns.size()) &&
+      "Unknown column!");
+    return mColumns[mColumnBegin[S] + C];
+  }
+
+  /// Solve all systems in the batch.
+  ///
+  /// Equations are solved in the same way as in BinomialSystem::solve(),
+  /// a variable which has zero coefficient is not constrained by an equation.
+  /// \return A number of systems which have solutions.
+  std::size_t solve() {
+    BCL_TRACE_SCOPE("milp::BinomialBatch::solve");
+    // The workspace is allocated on the first call, a batch which has been
+    // moved from allocates it again.
+    if (!mWork)
+      mWork.reset(new Workspace);
+    auto N = size();
+    mIsSolved.assign(N, 1);
+    mSolution.clear();
+    mSolutionBegin.resize(N + 1);
+    // Systems are processed in blocks, so arrays which are accessed while
+    // a block is solved fit into the cache.
+    std::size_t NumSolved = 0;
+    for (std::size_t Begin = 0; Begin < N; Begin += BlockSize)
+      NumSolved += solve(Begin, Begin + BlockSize < N ? Begin + BlockSize : N);
+    mSolutionBegin[N] = mSolution.size();
+    return NumSolved;
+  }
+
+  /// Return true if a specified system has been successfully solved.
+  bool isSolved(std::size_t S) const noexcept { return mIsSolved[S]; }
+
+  /// Return the first equation in solution of a specified system.
+  ///
+  /// Each equation has the form `x + b * t = c`, where `x` is a variable and
+  /// `t` is a parameter (see column() and isParameter()).
+  const EquationT *solution_begin(std::size_t S) const noexcept {
+    return mSolution.data() + mSolutionBegin[S];
+  }
+
+  /// Return the end of solution of a specified system.
+  const EquationT *solution_end(std::size_t S) const noexcept {
+    return mSolution.data() + mSolutionBegin[S + 1];
+  }
+
+private:
+  /// Number of systems which are solved at once.
+  static constexpr std::size_t BlockSize = 256;
+
+  /// Column of a disabled solution, it does not match any column in equations.
+  static constexpr LocalColumnT NoColumn = UINT8_MAX;
+
+  /// Equations at the same position in all systems of a block.
+  struct EquationArrays {
+    LocalColumnT LHSColumn[BlockSize];
+    ValueT LHSValue[BlockSize];
+    LocalColumnT RHSColumn[BlockSize];
+    ValueT RHSValue[BlockSize];
+    ValueT Constant[BlockSize];
+  };
+
+  /// Return a local column for a specified variable in the last system.
+  LocalColumnT local(const ColumnT &C) {
+    auto Begin = mColumnBegin.back(), Size = mColumns.size() - Begin;
+    for (std::size_t I = 0; I < Size; ++I)
+      if (mColumns[Begin + I] == C)
+        return static_cast<LocalColumnT>(I);
+    assert(Size < MaxColumnN && "Too many variables in a system!");
+    mColumns.push_back(C);
+    return static_cast<LocalColumnT>(Size);
+  }
+
+  /// Disable a solution in a specified system, so it does not match any
+  /// column in equations.
+  static void disable(std::size_t S, LocalColumnT Parameter,
+      EquationArrays &Solution) noexcept {
+    Solution.LHSColumn[S] = NoColumn;
+    Solution.LHSValue[S] = 1;
+    Solution.RHSColumn[S] = Parameter;
+    Solution.RHSValue[S] = 0;
+    Solution.Constant[S] = 0;
+  }
+
+  /// Solve systems in a specified range [Begin, End) and append their
+  /// solutions to the flat buffer.
+  /// \return A number of systems which have solutions.
+  std::size_t solve(std::size_t Begin, std::size_t End) {
+    auto N = End - Begin;
+    auto &Rows = mWork->Rows;
+    auto &Solutions = mWork->Solutions;
+    // Transpose equations into the structure-of-arrays form.
+    std::size_t NumRows = 0;
+    for (std::size_t S = 0; S < N; ++S) {
+      auto Size = size(Begin + S);
+      mNumRows[S] = static_cast<LocalColumnT>(Size);
+      NumRows = NumRows < Size ? Size : NumRows;
+      auto *Equation = mEquations.data() + mEquationBegin[Begin + S];
+      for (std::size_t R = 0; R < Size; ++R) {
+        Rows[R].LHSColumn[S] = Equation[R].LHS.Column;
+        Rows[R].LHSValue[S] = Equation[R].LHS.Value;
+        Rows[R].RHSColumn[S] = Equation[R].RHS.Column;
+        Rows[R].RHSValue[S] = Equation[R].RHS.Value;
+        Rows[R].Constant[S] = Equation[R].Constant;
+      }
+    }
+    auto *IsSolved = mIsSolved.data() + Begin;
+    for (std::size_t R = 0; R < NumRows; ++R) {
+      auto &Row = Rows[R];
+      auto &SolutionX = Solutions[2 * R];
+      auto &SolutionY = Solutions[2 * R + 1];
+      auto Parameter = static_cast<LocalColumnT>(MaxColumnN + R);
+      // 1. Solve R-th equation A * X + B * Y = C in each system. Solutions
+      // in systems without this equation are disabled, so substitution
+      // does not change these systems.
+      for (std::size_t S = 0; S < N; ++S) {
+        if (R >= mNumRows[S] || !IsSolved[S]) {
+          disable(S, Parameter, SolutionX);
+          disable(S, Parameter, SolutionY);
+          continue;
+        }
+        auto &A = Row.LHSValue[S], &B = Row.RHSValue[S];
+        if (Row.LHSColumn[S] == Row.RHSColumn[S]) {
+          A += B;
+          B = 0;
+        }
+        ValueT X, Y;
+        auto GCD = detail::extendedGCD<ValueT>(
+          A < 0 ? -A : A, B < 0 ? -B : B, X, Y);
+        auto C = Row.Constant[S];
+        if (GCD == 0 || C % GCD != 0) {
+          // Equation 0 = 0 does not produce solutions.
+          IsSolved[S] = GCD == 0 && C == 0;
+          disable(S, Parameter, SolutionX);
+          disable(S, Parameter, SolutionY);
+          continue;
+        }
+        auto Q = C / GCD;
+        // X = (X' * Q) - (B / GCD) * T
+        // Y = (Y' * Q) + (A / GCD) * T
+        // A variable with zero coefficient is not constrained, so its solution
+        // is disabled.
+        SolutionX.LHSColumn[S] = A != 0 ? Row.LHSColumn[S] : NoColumn;
+        SolutionX.LHSValue[S] = 1;
+        SolutionX.RHSColumn[S] = Parameter;
+        SolutionX.RHSValue[S] = B / GCD;
+        SolutionX.Constant[S] = Q * (A < 0 ? -X : X);
+        SolutionY.LHSColumn[S] = B != 0 ? Row.RHSColumn[S] : NoColumn;
+        SolutionY.LHSValue[S] = 1;
+        SolutionY.RHSColumn[S] = Parameter;
+        SolutionY.RHSValue[S] = -A / GCD;
+        SolutionY.Constant[S] = Q * (B < 0 ? -Y : Y);
+      }
+      // 2. Substitute solutions into the following equations.
+      for (std::size_t J = R + 1; J < NumRows; ++J)
+        substitute<true>(SolutionX, SolutionY, N, Rows[J]);
+      // 3. Substitute solutions into previously computed solutions. Variables
+      // at the left-hand side of these solutions have been already eliminated,
+      // so only parameters are updated.
+      for (std::size_t K = 0; K < 2 * R; ++K)
+        substitute<false>(SolutionX, SolutionY, N, Solutions[K]);
+    }
+    // 4. Copy solutions into the flat buffer, exclude solutions of parameters
+    // and disabled solutions.
+    std::size_t NumSolved = 0;
+    for (std::size_t S = 0; S < N; ++S) {
+      mSolutionBegin[Begin + S] = mSolution.size();
+      if (!IsSolved[S])
+        continue;
+      ++NumSolved;
+      for (std::size_t K = 0, EK = 2 * mNumRows[S]; K < EK; ++K) {
+        auto &Solution = Solutions[K];
+        if (isParameter(Solution.LHSColumn[S]))
+          continue;
+        mSolution.emplace_back(Solution.LHSColumn[S], Solution.LHSValue[S],
+          Solution.RHSColumn[S], Solution.RHSValue[S], Solution.Constant[S]);
+      }
+    }
+    return NumSolved;
+  }
+
+  /// Substitute solutions `x + b * t = c` into equations in N first systems
+  /// of a block.
+  ///
+  /// Selects are used instead of branches, so the loop can be vectorized.
+  /// If UpdateLHS is false, the left-hand side of equations is not updated.
+  template<bool UpdateLHS>
+  static void substitute(const EquationArrays &SolutionX,
+      const EquationArrays &SolutionY, std::size_t N, EquationArrays &To) {
+    auto update = [&To](const EquationArrays &Solution, std::size_t S,
+        LocalColumnT &Column, ValueT &Value) {
+      bool IsMatched = Column == Solution.LHSColumn[S];
+      auto Delta = Solution.Constant[S] * Value;
+      To.Constant[S] -= IsMatched ? Delta : 0;
+      Column = IsMatched ? Solution.RHSColumn[S] : Column;
+      Value = IsMatched ? -(Value * Solution.RHSValue[S]) : Value;
+    };
+    for (std::size_t S = 0; S < N; ++S) {
+      if (UpdateLHS)
+        update(SolutionX, S, To.LHSColumn[S], To.LHSValue[S]);
+      update(SolutionX, S, To.RHSColumn[S], To.RHSValue[S]);
+      if (UpdateLHS)
+        update(SolutionY, S, To.LHSColumn[S], To.LHSValue[S]);
+      update(SolutionY, S, To.RHSColumn[S], To.RHSValue[S]);
+    }
+  }
+
+  /// Arrays which are used to solve a block of systems.
+  struct Workspace {
+    EquationArrays Rows[MaxRowN];
+    EquationArrays Solutions[2 * MaxRowN];
+  };
+
+  std::vector<EquationT> mEquations;
+  std::vector<std::size_t> mEquationBegin;
+  std::vector<ColumnT> mColumns;
+  std::vector<std::size_t> mColumnBegin;
+
+  std::unique_ptr<Workspace> mWork;
+  LocalColumnT mNumRows[BlockSize];
+  std::vector<char> mIsSolved;
+
+  std::vector<EquationT> mSolution;
+  std::vector<std::size_t> mSolutionBegin;
+};
+
+/// This is a compiled form of a parametric solution of a system of binomial
+/// equations, it evaluates the solution for a large number of values of
+/// parameters.
+///
+/// Each equation `a * x + b * t = c` of a solution (see
+/// BinomialSystem::getSolution() and BinomialBatch::solution_begin()) is
+/// converted to an instruction `x = a * (c - b * t)` which refers to
+/// a variable and a parameter by their dense indices. The coefficient `a`
+/// must be 1 or -1 (solutions which are built by solve() and
+/// reverseSolution() have `a = 1`), so a variable is integral at any value
+/// of its parameter and no division is performed. Variables and parameters
+/// are numbered in the order of their first occurrence (see targets() and
+/// parameters()), an equation with `b = 0` does not introduce a parameter.
+///
+/// Values of parameters and results are stored in contiguous arrays: values
+/// of I-th parameter (variable) occupy [I * N, (I + 1) * N), where N is
+/// a number of points. Each instruction is evaluated for all points at once,
+/// so loops over points do not have branches and they can be vectorized.
+template<typename ColumnT, typename ValueT>
+class SolutionProgram {
+public:
+  /// Compile an empty solution.
+  SolutionProgram() = default;
+
+  /// Compile a solution which is a range of BAEquation objects.
+  template<typename ItrT> SolutionProgram(ItrT I, ItrT EI) {
+    std::unordered_map<ColumnT, std::size_t> Parameters;
+    for (; I != EI; ++I) {
+      assert((I->LHS.Value == 1 || I->LHS.Value == -1) &&
+        "Variable must have unit coefficient!");
+      Instruction Inst;
+      Inst.Target = mTargets.size();
+      Inst.Parameter = NoParameter;
+      if (I->RHS.Value != 0) {
+        auto Res = Parameters.emplace(I->RHS.Column, mParameters.size());
+        if (Res.second)
+          mParameters.push_back(I->RHS.Column);
+        Inst.Parameter = Res.first->second;
+      }
+      // Division by 1 or -1 is multiplication.
+      Inst.Constant = I->LHS.Value * I->Constant;
+      Inst.Coefficient = -I->LHS.Value * I->RHS.Value;
+      mTargets.push_back(I->LHS.Column);
+      mProgram.push_back(Inst);
+    }
+    // Instructions which use the same parameter are evaluated one after
+    // another, so values of the parameter remain in the cache.
+    std::stable_sort(mProgram.begin(), mProgram.end(),
+      [](const Instruction &LHS, const Instruction &RHS) {
+        return LHS.Parameter < RHS.Parameter;
+      });
+  }
+
+  /// Compile a specified solution.
+  template<typename EquationT>
+  explicit SolutionProgram(const std::vector<EquationT> &Solution)
+    : SolutionProgram(Solution.begin(), Solution.end()) {}
+
+  /// Return variables which are computed by the program, the order of
+  /// variables determines the order of results.
+  const std::vector<ColumnT> &targets() const noexcept { return mTargets; }
+
+  /// Return parameters of the program, the order of parameters determines
+  /// the order of their values.
+  const std::vector<ColumnT> &parameters() const noexcept {
+    return mParameters;
+  }
+
+  /// Evaluate the solution at N points.
+  ///
+  /// \param [in] Parameters Values of parameters, I-th parameter at J-th
+  /// point is Parameters[I * N + J].
+  /// \param [out] Out Values of variables, I-th variable at J-th point is
+  /// Out[I * N + J]. The buffer must be able to store
+  /// targets().size() * N values.
+  void evaluate(const ValueT *Parameters, std::size_t N,
+      ValueT *Out) const noexcept {
+    BCL_TRACE_SCOPE("milp::SolutionProgram::evaluate");
+    for (auto &Inst : mProgram) {
+      auto *To = Out + Inst.Target * N;
+      if (Inst.Parameter == NoParameter) {
+        std::fill(To, To + N, Inst.Constant);
+        continue;
+      }
+      auto *From = Parameters + Inst.Parameter * N;
+      auto C = Inst.Constant, K = Inst.Coefficient;
+      for (std::size_t J = 0; J < N; ++J)
+        To[J] = C + K * From[J];
+    }
+  }
+
+  /// Return a number of points in a grid Lower[I] <= t[I] <= Upper[I],
+  /// where t[I] is I-th parameter.
+  std::size_t gridSize(const ValueT *Lower,
+      const ValueT *Upper) const noexcept {
+    std::size_t Size = 1;
+    for (std::size_t I = 0, EI = mParameters.size(); I < EI; ++I) {
+      if (Upper[I] < Lower[I])
+        return 0;
+      Size *= static_cast<std::size_t>(Upper[I] - Lower[I]) + 1;
+    }
+    return Size;
+  }
+
+  /// Evaluate the solution at each point of a grid
+  /// Lower[I] <= t[I] <= Upper[I], where t[I] is I-th parameter.
+  ///
+  /// Points are enumerated in the lexicographical order, so the last
+  /// parameter changes fastest. Each variable depends on a single parameter,
+  /// so values of a variable are computed once for each value of its parameter
+  /// and then they are replicated.
+  /// \param [out] Out Values of variables, I-th variable at J-th point is
+  /// Out[I * N + J], where N is gridSize(Lower, Upper). The buffer must be
+  /// able to store targets().size() * N values.
+  /// \return Number of points in the grid.
+  std::size_t evaluateGrid(const ValueT *Lower, const ValueT *Upper,
+      ValueT *Out) const {
+    BCL_TRACE_SCOPE("milp::SolutionProgram::evaluateGrid");
+    auto N = gridSize(Lower, Upper);
+    if (N == 0)
+      return 0;
+    std::vector<std::size_t> Strides(mParameters.size());
+    for (std::size_t I = mParameters.size(), Stride = 1; I > 0; --I) {
+      Strides[I - 1] = Stride;
+      Stride *= static_cast<std::size_t>(Upper[I - 1] - Lower[I - 1]) + 1;
+    }
+    for (auto &Inst : mProgram) {
+      auto *To = Out + Inst.Target * N;
+      if (Inst.Parameter == NoParameter) {
+        std::fill(To, To + N, Inst.Constant);
+        continue;
+      }
+      auto P = Inst.Parameter;
+      auto Stride = Strides[P];
+      auto Count = static_cast<std::size_t>(Upper[P] - Lower[P]) + 1;
+      auto C = Inst.Constant, K = Inst.Coefficient;
+      // Fill the first block of points where the parameter takes all values,
+      // then copy it to the remaining blocks.
+      auto T = Lower[P];
+      for (std::size_t J = 0; J < Count; ++J, ++T)
+        std::fill(To + J * Stride, To + (J + 1) * Stride, C + K * T);
+      auto Block = Count * Stride;
+      for (std::size_t J = Block; J < N; J += Block)
+        std::copy(To, To + Block, To + J);
+    }
+    return N;
+  }
+
+private:
+  /// Parameter of an instruction which computes a constant.
+  static constexpr std::size_t NoParameter =
+    std::numeric_limits<std::size_t>::max();
+
+  /// Instruction `Out[Target] = Constant + Coefficient * t[Parameter]`.
+  struct Instruction {
+    std::size_t Target;
+    std::size_t Parameter;
+    ValueT Constant;
+    ValueT Coefficient;
+  };
+
+  std::vector<Instruction> mProgram;
+  std::vector<ColumnT> mTargets;
+  std::vector<ColumnT> mParameters;
+};
 }
 #endif//BCL_EQUATION_H
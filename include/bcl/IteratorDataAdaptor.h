@@ -28,26 +28,84 @@
 
 #include <iterator>
 #include <type_traits>
+#include <utility>
 
 namespace bcl {
+namespace detail {
+/// Determines the strongest iterator tag which does not exceed `MaxTag` and
+/// is satisfied by both `Tag` and `MaxTag`.
+template<class Tag, class MaxTag> struct MinIteratorTag {
+  using type = typename std::conditional<
+    std::is_base_of<MaxTag, Tag>::value, MaxTag, Tag>::type;
+};
+
+/// Checks whether a specified iterator is at least bidirectional.
+template<class ItrTy> struct IsBidirectionalIterator :
+  std::is_base_of<std::bidirectional_iterator_tag,
+    typename std::iterator_traits<ItrTy>::iterator_category> {};
+
+/// Checks whether a specified iterator is random access.
+template<class ItrTy> struct IsRandomAccessIterator :
+  std::is_base_of<std::random_access_iterator_tag,
+    typename std::iterator_traits<ItrTy>::iterator_category> {};
+
+/// Determines C++ 20 iterator concept of a specified iterator.
+///
+/// If `iterator_concept` is not available the iterator category is used.
+template<class ItrTy, class = void> struct IteratorConcept {
+  using type = typename std::iterator_traits<ItrTy>::iterator_category;
+};
+
+template<class ItrTy>
+struct IteratorConcept<ItrTy, std::void_t<typename ItrTy::iterator_concept>> {
+  using type = typename ItrTy::iterator_concept;
+};
+}
+
 ///\brief A simple wrapper of a pair of iterator and some value.
 ///
 /// This behaves as a wrapped iterator but has attached data.
+/// If the wrapped iterator is bidirectional or random access the adaptor
+/// provides the same set of operators, so std::distance(), std::lower_bound()
+/// and other algorithms do not fall back to linear traversal.
 /// \tparam ItrTy Type of a wrapped iterator.
 /// \tparam DataTy Type of attached data.
 /// \tparam Ty Type of a value wrapper points to. It should be constructible
 /// from *ItrTy, DataTy pair.
-/// \tparam PtrTy Type of a pointer to a type of a value wrapper points to.
-/// Note, that there is no `operator->` method and `operator*` return a value
-/// instead of a reference.
+/// \tparam PtrTy Unused, it is preserved for compatibility.
+/// Note, that `operator*` returns a value instead of a reference because
+/// values are constructed on the fly, `operator->` returns a proxy which
+/// holds such a value and `pointer` is the type of this proxy. So, the adaptor can not be a contiguous iterator and
+/// its C++ 20 `iterator_concept` is at most random access.
 template<class ItrTy, class DataTy, class Ty, class PtrTy = Ty *>
-struct IteratorDataAdaptor : public std::iterator<
-      typename std::iterator_traits<ItrTy>::iterator_category,
-      typename std::iterator_traits<ItrTy>::difference_type, Ty, PtrTy, Ty> {
+struct IteratorDataAdaptor {
   static_assert(std::is_constructible<Ty,
     typename std::iterator_traits<ItrTy>::reference, DataTy>::value,
     "Wrapper must point to a value which is constructible from (*ItrTy, DataTy)!");
 
+  using iterator_category =
+    typename std::iterator_traits<ItrTy>::iterator_category;
+  using iterator_concept = typename detail::MinIteratorTag<
+    typename detail::IteratorConcept<ItrTy>::type,
+    std::random_access_iterator_tag>::type;
+  using difference_type =
+    typename std::iterator_traits<ItrTy>::difference_type;
+  using value_type = Ty;
+  using reference = Ty;
+
+  /// This holds a value wrapper points to and provides access to its members.
+  class arrow_proxy {
+  public:
+    explicit arrow_proxy(Ty &&V) : mValue(std::move(V)) {}
+    Ty * operator->() noexcept { return &mValue; }
+    const Ty * operator->() const noexcept { return &mValue; }
+  private:
+    Ty mValue;
+  };
+
+  using pointer = arrow_proxy;
+
+  IteratorDataAdaptor() = default;
   IteratorDataAdaptor(const ItrTy &I, const DataTy &D) : mItr(I), mData(D) {}
 
   bool operator==(const IteratorDataAdaptor &RHS) const {
@@ -63,6 +121,87 @@ struct IteratorDataAdaptor : public std::iterator<
   }
 
   Ty operator*() const { return Ty(*mItr, mData); }
+  arrow_proxy operator->() const { return arrow_proxy(operator*()); }
+
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsBidirectionalIterator<T>::value>::type>
+  IteratorDataAdaptor & operator--() { --mItr; return *this; }
+
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsBidirectionalIterator<T>::value>::type>
+  IteratorDataAdaptor operator--(int) {
+    auto Tmp = *this; --*this; return Tmp;
+  }
+
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsRandomAccessIterator<T>::value>::type>
+  IteratorDataAdaptor & operator+=(difference_type N) {
+    mItr += N; return *this;
+  }
+
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsRandomAccessIterator<T>::value>::type>
+  IteratorDataAdaptor & operator-=(difference_type N) {
+    mItr -= N; return *this;
+  }
+
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsRandomAccessIterator<T>::value>::type>
+  IteratorDataAdaptor operator+(difference_type N) const {
+    return IteratorDataAdaptor(mItr + N, mData);
+  }
+
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsRandomAccessIterator<T>::value>::type>
+  friend IteratorDataAdaptor operator+(difference_type N,
+      const IteratorDataAdaptor &I) {
+    return I + N;
+  }
+
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsRandomAccessIterator<T>::value>::type>
+  IteratorDataAdaptor operator-(difference_type N) const {
+    return IteratorDataAdaptor(mItr - N, mData);
+  }
+
+  /// Returns distance between iterators, attached data is not considered.
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsRandomAccessIterator<T>::value>::type>
+  difference_type operator-(const IteratorDataAdaptor &RHS) const {
+    return mItr - RHS.mItr;
+  }
+
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsRandomAccessIterator<T>::value>::type>
+  Ty operator[](difference_type N) const { return Ty(mItr[N], mData); }
+
+  /// Compares positions of iterators, attached data is not considered.
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsRandomAccessIterator<T>::value>::type>
+  bool operator<(const IteratorDataAdaptor &RHS) const {
+    return mItr < RHS.mItr;
+  }
+
+  /// Compares positions of iterators, attached data is not considered.
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsRandomAccessIterator<T>::value>::type>
+  bool operator>(const IteratorDataAdaptor &RHS) const {
+    return RHS.mItr < mItr;
+  }
+
+  /// Compares positions of iterators, attached data is not considered.
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsRandomAccessIterator<T>::value>::type>
+  bool operator<=(const IteratorDataAdaptor &RHS) const {
+    return !(RHS.mItr < mItr);
+  }
+
+  /// Compares positions of iterators, attached data is not considered.
+  template<class T = ItrTy, class = typename std::enable_if<
+    detail::IsRandomAccessIterator<T>::value>::type>
+  bool operator>=(const IteratorDataAdaptor &RHS) const {
+    return !(mItr < RHS.mItr);
+  }
 
   ItrTy & getIterator() noexcept { return mItr; }
   const ItrTy & getIterator() const noexcept { return mItr; }
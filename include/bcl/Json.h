@@ -132,6 +132,11 @@
 //       std::cerr << "json error: " << P.errors().internal_size() <<
 //       " internal errors\n";
 //   }
+// \endcode
+// Errors are recorded as json::ErrorRecord (a code and a position) and
+// messages are formatted when errors() is called for the first time. So, use
+// P.errorRecords() if messages are not necessary.
+//
 // 6. To unparse JSON object O use the following code:
 // \code
 //   // Do not add identifier ("name": "Human") to the result.
@@ -219,23 +224,50 @@
 // \endcode
 // The previous code defines some JSON object ExmpaleObject with a single field
 // Text.
+//
+// 9. Enumerations are represented as strings. Names of enumerators are
+// registered with JSON_ENUM_TRAITS, conversions do not allocate memory.
+// \code
+//   enum class Color { Red, Green, Blue };
+//   JSON_ENUM_TRAITS(::, Color,
+//     {Color::Red, "red"}, {Color::Green, "green"}, {Color::Blue, "blue"})
+// \endcode
 //===----------------------------------------------------------------------===//
 
 #ifndef BCL_JSON_H
 #define BCL_JSON_H
 
+#include "Base64.h"
 #include "cell.h"
 #include "Diagnostic.h"
+#include "Trace.h"
 #include "utility.h"
+#include <algorithm>
+#include <array>
 #include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
 #include <set>
+#include <shared_mutex>
 #include <stack>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #define JSON_ERROR_1 "unexpected end of string"
@@ -287,7 +319,8 @@ struct Object_ : \
 #define JSON_INIT(Object_, ...) json_::Object_##Impl::Base(__VA_ARGS__)
 
 /// Initializes top-level object.
-#define JSON_INIT_ROOT ::json::Object(name())
+#define JSON_INIT_ROOT \
+::json::Object(::json::Object::id<std::remove_pointer_t<decltype(this)>>())
 
 /// Type of a value with name Name_ in a name-value pair inside object Object_.
 #define JSON_VALUE_TYPE(Object_, Name_) \
@@ -303,6 +336,18 @@ template<> struct Traits<namespace_ Object_> : \
   public Traits<namespace_ json_::Object_##Impl::Base> {}; \
 }
 
+/// \brief Specifies that an enumeration should be parsed/unparsed as
+/// a string.
+///
+/// Each variadic argument is a pair {Enum_::Enumerator, "name"}.
+#define JSON_ENUM_TRAITS(namespace_, Enum_, ...) \
+namespace json { \
+template<> struct Traits<namespace_ Enum_> : \
+  public EnumTraits<Traits<namespace_ Enum_>, namespace_ Enum_> { \
+  static constexpr EnumName<namespace_ Enum_> Names[] = { __VA_ARGS__ }; \
+}; \
+}
+
 namespace json {
 /// This is a base class for all JSON objects which can be obtained when
 /// a string represented JSON is parsed.
@@ -311,11 +356,92 @@ namespace json {
 /// method `static ObjectName name()`.
 class Object {
 public:
-  /// Identifier of an object.
+  /// Name of an object.
   typedef std::string ObjectName;
 
-  /// Default constructor.
-  explicit Object(const ObjectName &Name) : mName(Name) {}
+  /// \brief Identifier of an object.
+  ///
+  /// Names of objects are interned, so an identifier is an address of
+  /// an interned name. Objects with equal names have equal identifiers and
+  /// comparison of identifiers is a comparison of pointers.
+  class Id {
+  public:
+    /// Creates invalid identifier.
+    constexpr Id() noexcept = default;
+
+    /// Returns true if identifier is valid.
+    constexpr explicit operator bool() const noexcept { return mName; }
+
+    /// Returns name of an object, identifier must be valid.
+    const ObjectName & name() const noexcept {
+      assert(mName && "Identifier must be valid!");
+      return *mName;
+    }
+
+    constexpr bool operator==(Id RHS) const noexcept {
+      return mName == RHS.mName;
+    }
+    constexpr bool operator!=(Id RHS) const noexcept {
+      return mName != RHS.mName;
+    }
+    constexpr bool operator<(Id RHS) const noexcept {
+      return std::less<const ObjectName *>()(mName, RHS.mName);
+    }
+
+  private:
+    friend class Object;
+    constexpr explicit Id(const ObjectName *Name) noexcept : mName(Name) {}
+    const ObjectName *mName = nullptr;
+  };
+
+  /// \brief Returns identifier of a specified name.
+  ///
+  /// The name is interned on the first request, interned names are never
+  /// released. An exclusive lock is acquired only if the name has not been
+  /// interned yet.
+  static Id intern(const ObjectName &Name) {
+    if (auto NameId = lookup(Name))
+      return NameId;
+    std::unique_lock<std::shared_mutex> Lock(names().Mutex);
+    return Id(&*names().Names.insert(Name).first);
+  }
+
+  /// Returns identifier of a specified name or invalid identifier if the
+  /// name has not been interned yet.
+  static Id lookup(std::string_view Name) {
+    std::shared_lock<std::shared_mutex> Lock(names().Mutex);
+    auto I = names().Names.find(Name);
+    return I == names().Names.end() ? Id() : Id(&*I);
+  }
+
+  /// \brief Returns identifier of a type from a list Tys which has
+  /// a specified name or invalid identifier if there is no such type.
+  ///
+  /// Identifiers of types are cached (see id()), so the table of names
+  /// is not accessed.
+  template<class... Tys> static Id find(std::string_view Name) {
+    Id NameId;
+    (static_cast<void>(!NameId && id<Tys>().name() == Name &&
+      (NameId = id<Tys>())), ...);
+    return NameId;
+  }
+
+  /// \brief Returns identifier of a specified type Ty.
+  ///
+  /// The type must implement a static method `name()`, the name is interned
+  /// once and subsequent calls do not access the table of names.
+  template<class Ty> static Id id() {
+    static const Id TypeId(intern(Ty::name()));
+    return TypeId;
+  }
+
+  /// Creates object with a specified identifier.
+  explicit Object(Id ObjId) noexcept : mId(ObjId) {
+    assert(ObjId && "Identifier must be valid!");
+  }
+
+  /// Creates object with a specified name.
+  explicit Object(const ObjectName &Name) : mId(intern(Name)) {}
 
   /// Virtual destructor.
   virtual ~Object() {}
@@ -326,10 +452,13 @@ public:
   Object & operator=(Object &&) = default;
 
   /// Returns identifier of an object.
-  const ObjectName & getName() const noexcept { return mName; }
+  Id getId() const noexcept { return mId; }
+
+  /// Returns name of an object.
+  const ObjectName & getName() const noexcept { return mId.name(); }
 
   /// Returns true if this object has a specified type Ty.
-  template<class Ty> bool is() const { return Ty::name() == mName; }
+  template<class Ty> bool is() const { return id<Ty>() == mId; }
 
   /// \brief Casts object to a specified type.
   ///
@@ -345,7 +474,19 @@ public:
     return static_cast<const Ty &>(*this);
   }
 private:
-  ObjectName mName;
+  /// Table of interned names, nodes of std::set are never moved, so
+  /// addresses of names remain valid.
+  struct NameTable {
+    std::shared_mutex Mutex;
+    std::set<ObjectName, std::less<>> Names;
+  };
+
+  static NameTable & names() {
+    static NameTable Table;
+    return Table;
+  }
+
+  Id mId;
 };
 
 /// Type of tokens which may occur in a JSON string.
@@ -357,7 +498,7 @@ enum class Token : char {
   COMMA = ',',
   COLON = ':',
   QUOTE = '"',
-  ESCAPE = '/',
+  ESCAPE = '\\',
   DOT = '.',
   PLUS = '+',
   MINUS = '-',
@@ -385,12 +526,169 @@ inline std::string_view toString(Keyword K) noexcept {
   return KeywordTable[static_cast<std::underlying_type_t<Keyword>>(K)];
 }
 
+/// Errors which may occur when a JSON string is parsed.
+///
+/// Values are equal to codes of appropriate diagnostics (see JSON_ERROR_1,
+/// ..., JSON_ERROR_9).
+enum class Error : uint8_t {
+  NONE = 0,
+  UNEXPECTED_END = 1,
+  UNEXPECTED_CHARACTER = 2,
+  UNKNOWN_IDENTIFIER = 3,
+  IDENTIFIER_EXPECTED = 4,
+  VALUE_EXPECTED = 5,
+  CONVERSION = 6,
+  UNINITIALIZED_ELEMENTS = 7,
+  DUPLICATE_KEY = 8,
+  ILLEGAL_VALUE = 9,
+};
+
+/// \brief Compact description of an error.
+///
+/// A description of an error is stored by a lexer when the error occurs,
+/// the diagnostic message is formatted on demand only (see Lexer::errors()).
+struct ErrorRecord {
+  /// Kind of an error.
+  Error Code;
+
+  /// Unexpected character.
+  char Found;
+
+  /// Expected character (Error::UNEXPECTED_CHARACTER only).
+  char Expected;
+
+  /// Position of an error in a JSON string.
+  std::string::size_type Pos;
+
+  /// Identifier which is not found (Error::UNKNOWN_IDENTIFIER only).
+  const char *Name;
+};
+
 /// Representation of a JSON string.
 typedef std::string String;
 
 /// Position in a JSON string.
 typedef std::string::size_type Position;
 
+class SymbolPool;
+
+namespace detail {
+/// String which is stored in a pool of symbols.
+struct SymbolEntry {
+  std::pmr::string Value;
+  std::size_t Hash;
+  const SymbolPool *Pool;
+};
+}
+
+/// \brief Interned string value.
+///
+/// A symbol refers to a string which is stored in a pool (see SymbolPool),
+/// each pool stores a single copy of equal strings. So, symbols from the same
+/// pool are compared by addresses and hash values are computed once when
+/// strings are interned. Symbols from different pools are compared by
+/// content. A symbol must not outlive its pool.
+///
+/// Strings in a JSON document are interned if they are parsed as symbols,
+/// a pool must be set explicitly (see Parser::setSymbolPool()).
+class Symbol {
+public:
+  /// Creates an empty symbol which does not belong to any pool.
+  constexpr Symbol() noexcept = default;
+
+  /// Returns interned string.
+  std::string_view str() const noexcept {
+    return mEntry ? std::string_view(mEntry->Value) : std::string_view();
+  }
+
+  operator std::string_view() const noexcept { return str(); }
+
+  bool empty() const noexcept { return str().empty(); }
+
+  /// Returns pool which stores this symbol or nullptr for an empty symbol
+  /// which has been created with a default constructor.
+  const SymbolPool * pool() const noexcept {
+    return mEntry ? mEntry->Pool : nullptr;
+  }
+
+  /// Returns hash value of the interned string, it is equal to hash value
+  /// of std::string_view with the same content.
+  std::size_t hash() const noexcept {
+    return mEntry ? mEntry->Hash : std::hash<std::string_view>()({});
+  }
+
+  friend bool operator==(Symbol LHS, Symbol RHS) noexcept {
+    if (LHS.mEntry == RHS.mEntry)
+      return true;
+    if (LHS.mEntry && RHS.mEntry && LHS.mEntry->Pool == RHS.mEntry->Pool)
+      return false;
+    return LHS.str() == RHS.str();
+  }
+
+  friend bool operator!=(Symbol LHS, Symbol RHS) noexcept {
+    return !(LHS == RHS);
+  }
+
+  /// Symbols are ordered by content.
+  friend bool operator<(Symbol LHS, Symbol RHS) noexcept {
+    return LHS.mEntry != RHS.mEntry && LHS.str() < RHS.str();
+  }
+
+private:
+  friend class SymbolPool;
+  constexpr explicit Symbol(const detail::SymbolEntry *Entry) noexcept :
+    mEntry(Entry) {}
+
+  const detail::SymbolEntry *mEntry = nullptr;
+};
+
+/// \brief Pool of interned strings.
+///
+/// Strings are never removed from a pool until it is destroyed. A pool is
+/// thread-safe, so a single pool can be shared between parsers.
+class SymbolPool : private bcl::Uncopyable {
+public:
+  /// \brief Returns pool which is shared between all parsers that select it.
+  ///
+  /// Strings are never removed from this pool, so it should not be used
+  /// to parse untrusted input.
+  static SymbolPool & shared() {
+    static SymbolPool Pool;
+    return Pool;
+  }
+
+  /// Creates a pool which allocates memory from a specified resource.
+  explicit SymbolPool(
+      std::pmr::memory_resource *R = std::pmr::get_default_resource()) :
+    mEntries(R), mIndex(R) {}
+
+  /// Returns symbol for a specified string, the string is copied to the pool
+  /// only if it has not been interned yet.
+  Symbol intern(std::string_view Str) {
+    std::lock_guard<std::mutex> Lock(mMutex);
+    auto I = mIndex.find(Str);
+    if (I != mIndex.end())
+      return Symbol(I->second);
+    auto &E = mEntries.emplace_back(detail::SymbolEntry{
+      std::pmr::string(Str, mEntries.get_allocator().resource()),
+      std::hash<std::string_view>()(Str), this});
+    mIndex.emplace(std::string_view(E.Value), &E);
+    return Symbol(&E);
+  }
+
+  /// Returns number of interned strings.
+  std::size_t size() const {
+    std::lock_guard<std::mutex> Lock(mMutex);
+    return mEntries.size();
+  }
+
+private:
+  mutable std::mutex mMutex;
+  std::pmr::deque<detail::SymbolEntry> mEntries;
+  std::pmr::unordered_map<std::string_view, const detail::SymbolEntry *>
+    mIndex;
+};
+
 /// This is a lexer for a JSON string.
 class Lexer: private bcl::Uncopyable {
   /// Checks whether a specified character Ch is a quote.
@@ -447,8 +745,19 @@ class Lexer: private bcl::Uncopyable {
   };
 
 public:
-  /// Constructs a lexer for a specified JSON string.
-  explicit Lexer(const String &JSON) : mJSON(JSON), mErrors("json error") {}
+  /// \brief Constructs a lexer for a specified JSON string.
+  ///
+  /// Diagnostics and internal state of the lexer are allocated from
+  /// a specified memory resource.
+  explicit Lexer(const String &JSON,
+      std::pmr::memory_resource *R = std::pmr::get_default_resource()) :
+    mJSON(JSON), mErrors("json error", R), mErrorRecords(R),
+    mStates(std::pmr::polymorphic_allocator<State>(R)) {}
+
+  /// Returns memory resource which is used by the lexer.
+  std::pmr::memory_resource * resource() const noexcept {
+    return mErrors.resource();
+  }
 
   /// Goes to a next token in a JSON string.
   ///
@@ -461,20 +770,25 @@ public:
     for (; mNext < mJSON.size() && std::isspace(mJSON[mNext]); ++mNext);
     mToken = Token::INVALID;
     if (mNext >= mJSON.size()) {
-      mErrors.insert(JSON_ERROR(1), mNext);
+      addError(Error::UNEXPECTED_END, mNext);
       mStart = mEnd = mNext = mJSON.size();
       return false;
     }
     mStart = mEnd = mNext;
     if (isQuote(mJSON[mNext])) {
       for (++mNext; mNext < mJSON.size(); ++mNext) {
-        if (isQuote(mJSON[mNext]) && !isEscape(mJSON[mNext - 1])) {
+        // Skip an escaped character, it may be a quote or an escape.
+        if (isEscape(mJSON[mNext])) {
+          ++mNext;
+          continue;
+        }
+        if (isQuote(mJSON[mNext])) {
           mEnd = mNext++;
           mToken = Token::IDENTIFIER;
           return true;
         }
       }
-      mErrors.insert(JSON_ERROR(1), mStart);
+      addError(Error::UNEXPECTED_END, mStart);
       mStart = mEnd = mNext = mJSON.size();
       return false;
     } else if (std::isdigit(mJSON[mNext]) || isSign(mJSON[mNext])) {
@@ -525,7 +839,8 @@ public:
   bool checkSpecial(Token Ch) {
     if (is(Ch))
       return true;
-    mErrors.insert(JSON_ERROR(2), mStart, mJSON[mStart], Ch);
+    addError(Error::UNEXPECTED_CHARACTER, mStart, mJSON[mStart],
+      static_cast<char>(Ch));
     return false;
   }
 
@@ -536,7 +851,7 @@ public:
   bool checkIdentifier() {
     if (is(Token::IDENTIFIER))
       return true;
-    mErrors.insert(JSON_ERROR(4), mStart, mJSON[mStart]);
+    addError(Error::IDENTIFIER_EXPECTED, mStart, mJSON[mStart]);
     return false;
   }
 
@@ -551,7 +866,7 @@ public:
         isKeyword(Keyword::TRUE) || isKeyword(Keyword::FALSE) ||
         isKeyword(Keyword::NO_VALUE))
       return true;
-    mErrors.insert(JSON_ERROR(5), mStart, mJSON[mStart]);
+    addError(Error::VALUE_EXPECTED, mStart, mJSON[mStart]);
     return false;
   }
 
@@ -635,16 +950,45 @@ public:
     return is(Token::KEYWORD) && mKeyword == K;
   }
 
-  /// Returns container of errors.
-  bcl::Diagnostic & errors() noexcept { return mErrors; }
+  /// \brief Records an error which has been occurred at a specified position.
+  ///
+  /// The diagnostic message is not formatted until errors() is called, so
+  /// this is cheap enough to be used on each rejected input.
+  void addError(Error Code, Position Pos, char Found = '\0',
+      char Expected = '\0') {
+    mErrorRecords.push_back(ErrorRecord{ Code, Found, Expected, Pos, nullptr });
+  }
+
+  /// \brief Records an error which refers to a specified identifier.
+  ///
+  /// The identifier is not copied, so it must outlive the lexer.
+  void addError(Error Code, Position Pos, const char *Name) {
+    mErrorRecords.push_back(ErrorRecord{ Code, '\0', '\0', Pos, Name });
+  }
 
-  /// Returns container of errors.
-  const bcl::Diagnostic & errors() const noexcept { return mErrors; }
+  /// Returns all recorded errors in order of their occurrence, messages
+  /// are not formatted.
+  const std::pmr::vector<ErrorRecord> & errorRecords() const noexcept {
+    return mErrorRecords;
+  }
+
+  /// Returns container of errors, recorded errors are formatted on demand.
+  bcl::Diagnostic & errors() {
+    formatErrors();
+    return mErrors;
+  }
+
+  /// Returns container of errors, recorded errors are formatted on demand.
+  const bcl::Diagnostic & errors() const {
+    formatErrors();
+    return mErrors;
+  }
 
   /// Returns true if errors have been occurred, internal errors are
   /// also considered.
-  bool hasErrors() const {
-    return !errors().empty() || errors().internal_size() > 0;
+  bool hasErrors() const noexcept {
+    return !mErrorRecords.empty() || !mErrors.empty() ||
+      mErrors.internal_size() > 0;
   }
 
   /// Discards limiting quotes of the current token, if it is an identifier, or
@@ -658,16 +1002,52 @@ public:
   /// Returns a JSON string.
   const String & json() const noexcept { return mJSON; }
 
+  /// Sets pool which is used to intern strings which are parsed as symbols,
+  /// symbols can not be parsed if a specified pool is null.
+  void setSymbolPool(SymbolPool *Pool) noexcept { mSymbols = Pool; }
+
+  /// Returns pool which is used to intern strings or nullptr.
+  SymbolPool * symbolPool() const noexcept { return mSymbols; }
+
 private:
+  /// Formats diagnostics for recorded errors which have not been formatted
+  /// yet.
+  void formatErrors() const {
+    for (; mFormatted < mErrorRecords.size(); ++mFormatted) {
+      auto &E = mErrorRecords[mFormatted];
+      switch (E.Code) {
+      case Error::UNEXPECTED_END:
+        mErrors.insert(JSON_ERROR(1), E.Pos); break;
+      case Error::UNEXPECTED_CHARACTER:
+        mErrors.insert(JSON_ERROR(2), E.Pos, E.Found, E.Expected); break;
+      case Error::UNKNOWN_IDENTIFIER:
+        mErrors.insert(JSON_ERROR(3), E.Pos, E.Name ? E.Name : ""); break;
+      case Error::IDENTIFIER_EXPECTED:
+        mErrors.insert(JSON_ERROR(4), E.Pos, E.Found); break;
+      case Error::VALUE_EXPECTED:
+        mErrors.insert(JSON_ERROR(5), E.Pos, E.Found); break;
+      case Error::CONVERSION: mErrors.insert(JSON_ERROR(6), E.Pos); break;
+      case Error::UNINITIALIZED_ELEMENTS:
+        mErrors.insert(JSON_ERROR(7), E.Pos); break;
+      case Error::DUPLICATE_KEY: mErrors.insert(JSON_ERROR(8), E.Pos); break;
+      case Error::ILLEGAL_VALUE: mErrors.insert(JSON_ERROR(9), E.Pos); break;
+      case Error::NONE: break;
+      }
+    }
+  }
+
   String mJSON;
-  bcl::Diagnostic mErrors;
+  mutable bcl::Diagnostic mErrors;
+  std::pmr::vector<ErrorRecord> mErrorRecords;
+  mutable std::size_t mFormatted = 0;
   Position mStart = 0;
   Position mEnd = 0;
   Position mNext = 0;
   Token mToken;
   bool mIsIntegral = false;
   Keyword mKeyword = Keyword::NO_VALUE;
-  std::stack<State> mStates;
+  std::stack<State, std::pmr::deque<State>> mStates;
+  SymbolPool *mSymbols = nullptr;
 };
 
 /// \brief This implements methods to convert value in a JSON string to
@@ -738,6 +1118,19 @@ template<class CellKey> struct CellTraits {
   }
 };
 
+namespace detail {
+/// Checks whether traits of a vector provide a static method
+/// unparseElement(String &, const value_type &), so parts of a vector can be
+/// unparsed independently.
+template<class TraitsTy, class = void>
+struct HasElementUnparse : public std::false_type {};
+
+template<class TraitsTy>
+struct HasElementUnparse<TraitsTy,
+  std::void_t<decltype(&TraitsTy::unparseElement)>> :
+  public std::true_type {};
+}
+
 /// \brief This class parses a string which represents JSON and converts it to
 /// an appropriate representation.
 ///
@@ -755,32 +1148,36 @@ template<class... Objects> class Parser {
   /// passed to a bcl::TypeList::for_each() method. In the last case
   /// bcl::TypeList should comprise different target types and appropriate type
   /// will be determined by name. Note that in this case all target type must
-  /// propose a static `Object::ObjectName name()` method.
+  /// propose a static `Object::ObjectName name()` method, types are compared
+  /// by identifiers of interned names (see Object::Id).
   class ParseFunctor {
   public:
     /// Converts JSON string to a specified Ty.
     template<class Ty> static bool parse(Ty &Obj, Lexer &Lex) {
-      Lex.resetPosition();
-      Lex.goToNext();
-      if (!Traits<Ty>::parse(Obj, Lex)) {
-        Lex.errors().insert(JSON_ERROR(6), Lex.start());
-        return false;
-      }
-      if (Lex.next() < Lex.json().size()) {
-        Lex.goToNext();
-        Lex.checkSpecial(Token::COMMA);
-        return false;
-      }
-      return true;
+      return convert(Obj, Lex, [](Ty &Obj, Lexer &Lex) {
+        return Traits<Ty>::parse(Obj, Lex);
+      });
+    }
+
+    /// Applies JSON string to an existing instance of a specified Ty
+    /// (see Traits<bcl::StaticMap<...>>::merge()).
+    template<class Ty> static bool merge(Ty &Obj, Lexer &Lex) {
+      return convert(Obj, Lex, [](Ty &Obj, Lexer &Lex) {
+        return Traits<Ty>::merge(Obj, Lex);
+      });
     }
 
+    /// Creates functor to convert JSON string to a type with a specified
+    /// identifier.
+    ParseFunctor(Object::Id Id, Lexer &Lex) : mId(Id), mLex(Lex) {}
+
     /// Creates functor to convert JSON string to a type with a specified name.
-    ParseFunctor(Object::ObjectName Name, Lexer &Lex) :
-      mName(Name), mLex(Lex) {}
+    ParseFunctor(const Object::ObjectName &Name, Lexer &Lex) :
+      ParseFunctor(Object::lookup(Name), Lex) {}
 
     /// Converts JSON string to a specified Ty if it has an appropriate name.
     template<class Ty> void operator()() {
-      if (Ty::name() != mName)
+      if (!mId || Object::id<Ty>() != mId)
         return;
       auto Obj = std::unique_ptr<Ty>(new Ty);
       if (!parse(*Obj, mLex))
@@ -794,7 +1191,24 @@ template<class... Objects> class Parser {
     }
 
   private:
-    Object::ObjectName mName;
+    /// Converts the whole JSON string with a specified function.
+    template<class Ty, class Function>
+    static bool convert(Ty &Obj, Lexer &Lex, Function &&F) {
+      Lex.resetPosition();
+      Lex.goToNext();
+      if (!F(Obj, Lex)) {
+        Lex.addError(Error::CONVERSION, Lex.start());
+        return false;
+      }
+      if (Lex.next() < Lex.json().size()) {
+        Lex.goToNext();
+        Lex.checkSpecial(Token::COMMA);
+        return false;
+      }
+      return true;
+    }
+
+    Object::Id mId;
     Lexer &mLex;
     std::unique_ptr<Object> mObject;
   };
@@ -806,7 +1220,8 @@ template<class... Objects> class Parser {
   /// passed to a bcl::TypeList::for_each() method. In the last case
   /// bcl::TypeList should comprise different target types and appropriate type
   /// will be determined by name. Note that in this case all target type must
-  /// propose a static `Object::ObjectName name()` method.
+  /// propose a static `Object::ObjectName name()` method. A name is
+  /// materialized when the object is written only.
   class UnparseFunctor {
   public:
     /// Unparses JSON object of a specified type.
@@ -927,6 +1342,7 @@ public:
   /// in a JSON string.
   static String unparse(const Object &Obj, const char *NameKey = "name") {
     assert(NameKey && "Identifier of a JSON object must not be null!");
+    BCL_TRACE_SCOPE("json::Parser::unparse");
     UnparseFunctor F(Obj, NameKey);
     ObjectTypeList::for_each_type(F);
     return F.getString();
@@ -951,25 +1367,148 @@ public:
     class = typename std::enable_if<
       !std::is_same<typename std::decay<Ty>::type, Object>::value>::type>
     static String unparse(const Ty &Obj) {
+    BCL_TRACE_SCOPE("json::Parser::unparse");
     return UnparseFunctor::unparse(Obj);
   }
 
+  /// \brief Unparses a specified vector in parallel and returns consecutive
+  /// parts of a JSON string.
+  ///
+  /// Elements are split into at most Threads chunks (0 means
+  /// std::thread::hardware_concurrency()) of at least MinChunk elements.
+  /// Each chunk is unparsed into a separate buffer in a separate thread.
+  /// Concatenation of parts is equal to unparse(Obj), so parts can be
+  /// written with a scatter-gather output without copying. Elements are
+  /// unparsed with Traits<std::vector<Ty, Allocator>>::unparseElement(),
+  /// if traits do not provide it (for example, a vector of bytes is
+  /// represented as a single base64 string) a single part is returned.
+  template<class Ty, class Allocator>
+  static std::vector<String> unparseChunks(
+      const std::vector<Ty, Allocator> &Obj,
+      unsigned Threads = 0, std::size_t MinChunk = 1024) {
+    BCL_TRACE_SCOPE("json::Parser::unparseChunks");
+    using VecTraits = Traits<std::vector<Ty, Allocator>>;
+    if constexpr (!detail::HasElementUnparse<VecTraits>::value) {
+      // The whole vector has a specialized representation (for example,
+      // bytes are unparsed as a base64 string), so it is not split.
+      std::vector<String> Chunks(1);
+      VecTraits::unparse(Chunks.front(), Obj);
+      return Chunks;
+    } else {
+      if (Threads == 0)
+        Threads = std::max(1u, std::thread::hardware_concurrency());
+      MinChunk = std::max<std::size_t>(MinChunk, 1);
+      auto NumChunks = std::min<std::size_t>(Threads,
+        (Obj.size() + MinChunk - 1) / MinChunk);
+      std::vector<String> Chunks(std::max<std::size_t>(NumChunks, 1));
+      if (NumChunks <= 1) {
+        VecTraits::unparse(Chunks.front(), Obj);
+        return Chunks;
+      }
+      // Do not use std::vector<bool> because it is accessed from different
+      // threads.
+      std::vector<char> HasEmpty(NumChunks, false);
+      std::vector<std::exception_ptr> Errors(NumChunks);
+      auto Unparse = [&Obj, &Chunks, &HasEmpty, &Errors, NumChunks](
+          std::size_t C) {
+        BCL_TRACE_SCOPE("json::Parser::unparseChunk");
+        try {
+          auto I = Obj.size() * C / NumChunks;
+          auto EI = Obj.size() * (C + 1) / NumChunks;
+          auto &JSON = Chunks[C];
+          for (; I < EI; ++I) {
+            JSON += I == 0 ? '[' : ',';
+            auto Size = JSON.size();
+            VecTraits::unparseElement(JSON, Obj[I]);
+            HasEmpty[C] |= JSON.size() == Size;
+          }
+          if (C + 1 == NumChunks)
+            JSON += ']';
+        } catch (...) {
+          Errors[C] = std::current_exception();
+        }
+      };
+      std::vector<std::thread> Workers;
+      Workers.reserve(NumChunks - 1);
+      for (std::size_t C = 1; C < NumChunks; ++C) {
+        try {
+          Workers.emplace_back(Unparse, C);
+        } catch (const std::system_error &) {
+          Unparse(C);
+        }
+      }
+      Unparse(0);
+      for (auto &W : Workers)
+        W.join();
+      for (auto &E : Errors)
+        if (E)
+          std::rethrow_exception(E);
+      // Elements without representation are unparsed as a map, this is rare
+      // so the whole vector is unparsed again in this case.
+      if (std::find(HasEmpty.begin(), HasEmpty.end(), true) !=
+          HasEmpty.end()) {
+        Chunks.resize(1);
+        Chunks.front().clear();
+        VecTraits::unparse(Chunks.front(), Obj);
+      }
+      return Chunks;
+    }
+  }
+
+  /// Unparses a specified vector in parallel (see unparseChunks()) and
+  /// concatenates parts of a JSON string with a single allocation.
+  template<class Ty, class Allocator>
+  static String unparseParallel(const std::vector<Ty, Allocator> &Obj,
+      unsigned Threads = 0, std::size_t MinChunk = 1024) {
+    auto Chunks = unparseChunks(Obj, Threads, MinChunk);
+    if (Chunks.size() == 1)
+      return std::move(Chunks.front());
+    std::size_t Size = 0;
+    for (auto &C : Chunks)
+      Size += C.size();
+    String JSON;
+    JSON.reserve(Size);
+    for (auto &C : Chunks)
+      JSON += C;
+    return JSON;
+  }
+
+  /// \brief Unparses values of a specified JSON object which differ from
+  /// values of a previous instance.
+  ///
+  /// The result can be applied to the previous instance with merge().
+  template<class Ty>
+  static String unparse(const Ty &Obj, const Ty &Prev) {
+    BCL_TRACE_SCOPE("json::Parser::unparseDelta");
+    String JSON;
+    Traits<Ty>::unparse(JSON, Obj, Prev);
+    return JSON;
+  }
+
   /// \brief Constructs a lexer for a specified JSON string.
   ///
   /// NameKey parameter is a key for a field which marks JSON object identifier
-  /// in a JSON string.
-  explicit Parser(const String &JSON, const char *NameKey = "name")
-    : mLex(JSON), mNameKey(NameKey) {
+  /// in a JSON string. Diagnostics and internal state of the parser are
+  /// allocated from a specified memory resource, a destination object
+  /// uses its own allocators.
+  explicit Parser(const String &JSON, const char *NameKey = "name",
+      std::pmr::memory_resource *R = std::pmr::get_default_resource())
+    : mLex(JSON, R), mNameKey(NameKey) {
     assert(NameKey && "Identifier of a JSON object must not be null!");
   }
 
   /// Parses JSON string and returns appropriate JSON object or
   /// nullptr if errors have occurred.
   std::unique_ptr<Object> parse() {
+    BCL_TRACE_SCOPE("json::Parser::parse");
     if (!parseName())
       return nullptr;
-    ParseFunctor F(
-      mLex.json().substr(mNameStart + 1, mNameEnd - mNameStart - 1), mLex);
+    BCL_TRACE_SCOPE("json::Parser::parseObject");
+    auto Id = Object::find<Objects...>(std::string_view(mLex.json()).substr(
+      mNameStart + 1, mNameEnd - mNameStart - 1));
+    if (!Id)
+      return nullptr;
+    ParseFunctor F(Id, mLex);
     ObjectTypeList::for_each_type(F);
     return F.stealObject();
   }
@@ -977,20 +1516,41 @@ public:
   /// Parses JSON string and converts it to a specified type,
   /// returns true on success.
   template<class Ty> bool parse(Ty &Obj) {
+    BCL_TRACE_SCOPE("json::Parser::parse");
     return ParseFunctor::parse(Obj, mLex);
   }
 
+  /// Parses JSON string which contains a part of an object and applies it
+  /// to a specified instance, returns true on success. Values of keys
+  /// which are not mentioned in JSON string are preserved.
+  template<class Ty> bool merge(Ty &Obj) {
+    BCL_TRACE_SCOPE("json::Parser::merge");
+    return ParseFunctor::merge(Obj, mLex);
+  }
+
   /// Key stored in a JSON string which marks identifier of an JSON object.
   const char *getNameKey() noexcept {
     return mNameKey;
   }
 
-  /// Returns container of errors.
-  const bcl::Diagnostic & errors() const noexcept { return mLex.errors(); }
+  /// \brief Sets pool which is used to intern strings which are parsed as
+  /// symbols.
+  ///
+  /// There is no default pool, because a pool grows with each distinct
+  /// string. So, symbols can not be parsed if a specified pool is null.
+  void setSymbolPool(SymbolPool *Pool) noexcept { mLex.setSymbolPool(Pool); }
+
+  /// Returns container of errors, messages are formatted on demand.
+  const bcl::Diagnostic & errors() const { return mLex.errors(); }
+
+  /// Returns all recorded errors, messages are not formatted.
+  const std::pmr::vector<ErrorRecord> & errorRecords() const noexcept {
+    return mLex.errorRecords();
+  }
 
   /// Returns true if errors have been occurred, internal errors are
   /// also considered.
-  bool hasErrors() const { return mLex.hasErrors(); }
+  bool hasErrors() const noexcept { return mLex.hasErrors(); }
 
 private:
   /// \brief Determines identifier to build appropriate JSONObject object.
@@ -999,6 +1559,7 @@ private:
   /// in the range [mNameStart, mNameEnd].
   /// \return True in success, false if some errors have been occurred.
   bool parseName() {
+    BCL_TRACE_SCOPE("json::Parser::parseName");
     mLex.resetPosition();
     if (!mLex.goToNext() || !mLex.checkSpecial(Token::LEFT_BRACE))
       return false;
@@ -1028,7 +1589,7 @@ private:
       if (!mLex.checkSpecial(Token::COMMA))
         return false;
       }
-    mLex.errors().insert(JSON_ERROR(3), mLex.json().size(), getNameKey());
+    mLex.addError(Error::UNKNOWN_IDENTIFIER, mLex.json().size(), getNameKey());
     return false;
   }
 private:
@@ -1038,32 +1599,219 @@ private:
   const char *mNameKey;
 };
 
-template<> struct Traits<std::string> {
-  inline static String unescape(const String &Str) {
-    if (Str.size() < 2)
-      return Str;
-    std::string Res;
-    Res.reserve(Str.length());
-    auto I = Str.begin(), EI = Str.end() - 1;
-    while (I != EI) {
+namespace detail {
+/// Returns value of the current token without limiting quotes.
+inline std::string_view tokenValue(const Lexer &Lex) noexcept {
+  auto Value = Lex.discardQuote();
+  return std::string_view(Lex.json()).substr(
+    Value.first, Value.second + 1 - Value.first);
+}
+
+/// Converts a number in a specified string without memory allocation.
+///
+/// Leading spaces and a plus sign are ignored, trailing characters which are
+/// not a part of a number are also ignored.
+template<class Ty>
+inline bool parseNumber(std::string_view Str, Ty &Dest) noexcept {
+  auto *I = Str.data(), *EI = Str.data() + Str.size();
+  for (; I != EI && std::isspace(*I); ++I);
+  if (I != EI && *I == static_cast<char>(Token::PLUS))
+    ++I;
+  return std::from_chars(I, EI, Dest).ec == std::errc();
+}
+
+/// Converts the current token to a number without memory allocation.
+template<class Ty>
+inline bool parseNumber(Ty &Dest, Lexer &Lex) noexcept {
+  return parseNumber(tokenValue(Lex), Dest);
+}
+
+/// \brief Converts key of an element in an array to its index.
+///
+/// The Key parameter is a key passed to Traits::parse() by Parser::traverse().
+/// Note that the key will be successfully converted because this check has
+/// been performed when memory for the array has been allocated.
+inline Position arrayIndex(const Lexer &Lex,
+    std::pair<Position, Position> Key) noexcept {
+  if (Key.first == 0)
+    return Key.second;
+  unsigned long long Idx = 0;
+  parseNumber(std::string_view(Lex.json()).substr(
+    Key.first + 1, Key.second - Key.first - 1), Idx);
+  return static_cast<Position>(Idx);
+}
+
+/// \brief Checks that keys of an array representation are 0, ..., MaxIdx.
+///
+/// User of JSON serializer can not determine if there is some uninitialized
+/// elements in an array without manual parsing of a JSON string. So do not
+/// parse such arrays. This array should be parsed as a map.
+inline bool checkArrayKeys(Position Count, Position MaxIdx, Lexer &Lex) {
+  if (Count == 0)
+    return true;
+  if (Count < MaxIdx + 1) {
+    Lex.addError(Error::UNINITIALIZED_ELEMENTS, Lex.start());
+    return false;
+  }
+  if (Count > MaxIdx + 1) {
+    Lex.addError(Error::DUPLICATE_KEY, Lex.start());
+    return false;
+  }
+  return true;
+}
+
+/// This is true if Ty is an arithmetic type which is represented as
+/// a JSON number.
+template<class Ty> struct is_number : public std::disjunction<
+  std::is_same<Ty, int>, std::is_same<Ty, long>, std::is_same<Ty, long long>,
+  std::is_same<Ty, unsigned>, std::is_same<Ty, unsigned long>,
+  std::is_same<Ty, unsigned long long>, std::is_same<Ty, float>,
+  std::is_same<Ty, double>> {};
+
+/// \brief Scans an array of numbers [N1, ..., NK] which starts at
+/// a specified position.
+///
+/// Each number must match a number token of a lexer and is passed to
+/// a specified function, the function returns false to stop scanning.
+/// \return Position of the closing bracket or String::npos if the array has
+/// another representation or scanning has been stopped.
+template<class Function>
+inline Position scanNumbers(std::string_view JSON, Position Start,
+    Function &&F) {
+  assert(JSON[Start] == static_cast<char>(Token::LEFT_BRACKET) &&
+    "Array must start with a left bracket!");
+  // Characters are classified without locale-dependent functions which
+  // are not inlined.
+  auto isSpace = [](char C) {
+    return C == ' ' || (C >= '\t' && C <= '\r');
+  };
+  auto isDigit = [](char C) { return C >= '0' && C <= '9'; };
+  auto I = Start + 1, E = JSON.size();
+  for (; I < E && isSpace(JSON[I]); ++I);
+  if (I < E && JSON[I] == static_cast<char>(Token::RIGHT_BRACKET))
+    return I;
+  for (;;) {
+    for (; I < E && isSpace(JSON[I]); ++I);
+    if (I == E || !(isDigit(JSON[I]) ||
+          JSON[I] == static_cast<char>(Token::MINUS) ||
+          JSON[I] == static_cast<char>(Token::PLUS)))
+      return String::npos;
+    auto NumberStart = I;
+    bool HasDot = false;
+    for (++I; I < E; ++I) {
+      if (isDigit(JSON[I]))
+        continue;
+      if (JSON[I] != static_cast<char>(Token::DOT) || HasDot)
+        break;
+      HasDot = true;
+    }
+    if (!F(JSON.substr(NumberStart, I - NumberStart)))
+      return String::npos;
+    for (; I < E && isSpace(JSON[I]); ++I);
+    if (I == E)
+      return String::npos;
+    if (JSON[I] == static_cast<char>(Token::RIGHT_BRACKET))
+      return I;
+    if (JSON[I] != static_cast<char>(Token::COMMA))
+      return String::npos;
+    ++I;
+  }
+}
+
+/// \brief Parses an array of numbers [N1, ..., NK] without tokenization of
+/// each number.
+///
+/// This is a fast path for homogeneous numeric arrays. At first, numbers are
+/// validated and counted. Then a specified function is called to allocate
+/// storage for a known number of elements (it returns pointer to the first
+/// element) and numbers are converted straight into this storage.
+/// On success, the lexer points to the closing bracket. If the array has
+/// another representation or it is malformed, this returns false and does not
+/// change state of the lexer, so the generic way should be used to parse
+/// the array and to diagnose errors.
+template<class Ty, class Function>
+inline bool parseNumberArray(Lexer &Lex, Function &&Allocate) {
+  static_assert(is_number<Ty>::value, "Type of elements must be a number!");
+  if (!Lex.is(Token::LEFT_BRACKET))
+    return false;
+  std::string_view JSON(Lex.json());
+  Position Count = 0;
+  auto Last = scanNumbers(JSON, Lex.start(),
+    [&Count](std::string_view) { ++Count; return true; });
+  if (Last == String::npos)
+    return false;
+  Ty *Dest = Allocate(Count);
+  if (Count != 0 && scanNumbers(JSON, Lex.start(),
+        [&Dest](std::string_view N) { return parseNumber(N, *Dest++); }) ==
+      String::npos)
+    return false;
+  Lex.setPosition(Last);
+  return true;
+}
+
+/// \brief Appends a specified number to a JSON string.
+///
+/// This does not create temporary strings and produces the same
+/// representation as std::to_string() which is used by Traits<Ty>::unparse().
+template<class Ty> inline void appendNumber(String &JSON, Ty Value) {
+  static_assert(is_number<Ty>::value, "Type must be a number!");
+  if constexpr (std::is_floating_point<Ty>::value) {
+    // Sign, integral digits, point and 6 fractional digits.
+    char Buf[std::numeric_limits<Ty>::max_exponent10 + 10];
+    auto Res = std::to_chars(Buf, Buf + sizeof(Buf), Value,
+      std::chars_format::fixed, 6);
+    assert(Res.ec == std::errc() && "Buffer is too small!");
+    JSON.append(Buf, Res.ptr);
+  } else {
+    char Buf[std::numeric_limits<Ty>::digits10 + 3];
+    auto Res = std::to_chars(Buf, Buf + sizeof(Buf), Value);
+    assert(Res.ec == std::errc() && "Buffer is too small!");
+    JSON.append(Buf, Res.ptr);
+  }
+}
+}
+
+/// Specialization of JSON serialization traits for strings.
+///
+/// Strings with any allocator are supported, so a std::pmr::string is
+/// filled using its own memory resource.
+template<class Allocator>
+struct Traits<std::basic_string<char, std::char_traits<char>, Allocator>> {
+  typedef std::basic_string<char, std::char_traits<char>, Allocator> StrTy;
+
+  /// Unescapes characters in a range [I, EI) and appends them to Res.
+  template<class ResTy>
+  inline static void unescape(const char *I, const char *EI, ResTy &Res) {
+    if (EI - I < 2) {
+      Res.append(I, EI);
+      return;
+    }
+    Res.reserve(Res.size() + (EI - I));
+    auto Last = EI - 1;
+    // Note, that an escape sequence at the end moves I beyond Last.
+    while (I < Last) {
       if (*I != '\\') {
         Res += *I;
         ++I;
         continue;
       }
       switch (*(++I)) {
-        case 'n': Res += "\n"; break;
-        case 't': Res += "\t"; break;
-        case 'v': Res += "\v"; break;
-        case 'f': Res += "\f"; break;
-        case 'r': Res += "\r"; break;
+        case 'n': Res += '\n'; break;
+        case 't': Res += '\t'; break;
+        case 'v': Res += '\v'; break;
+        case 'f': Res += '\f'; break;
+        case 'r': Res += '\r'; break;
         case '"': case '\\': Res += *I; break;
         default: continue;
       }
       ++I;
     }
-    if (I == EI)
-      Res += Str.back();
+    if (I == Last)
+      Res += *Last;
+  }
+  inline static String unescape(const String &Str) {
+    String Res;
+    unescape(Str.data(), Str.data() + Str.size(), Res);
     return Res;
   }
   inline static Position escape(String &JSON, Position Pos) {
@@ -1079,20 +1827,23 @@ template<> struct Traits<std::string> {
     JSON.insert(Pos, "\\");
     return Pos + 1;
   }
-  inline static bool parse(std::string &Dest, Lexer &Lex) noexcept {
+  inline static bool parse(StrTy &Dest, Lexer &Lex) noexcept {
     try {
       auto Value = Lex.discardQuote();
-      Dest = unescape(
-        Lex.json().substr(Value.first, Value.second - Value.first + 1));
+      Dest.clear();
+      auto *Data = Lex.json().data();
+      unescape(Data + Value.first, Data + Value.second + 1, Dest);
     }
     catch (...) {
       return false;
     }
     return true;
   }
-  inline static void unparse(String &JSON, const std::string &Obj) {
+  inline static void unparse(String &JSON, const StrTy &Obj) {
     auto I = JSON.size() + 1;
-    JSON += '"' + Obj + '"';
+    JSON += '"';
+    JSON.append(Obj.data(), Obj.size());
+    JSON += '"';
     for (; I < JSON.size() - 1; ++I)
       I = escape(JSON, I);
   }
@@ -1100,12 +1851,16 @@ template<> struct Traits<std::string> {
 
 template<> struct Traits<char> {
   inline static bool parse(char &Dest, Lexer &Lex) noexcept {
-    auto Value = Lex.discardQuote();
-    auto Tmp = Traits<std::string>::unescape(
-      Lex.json().substr(Value.first, Value.second - Value.first + 1));
+    auto Str = detail::tokenValue(Lex);
+    // A single character may be escaped, so it occupies at most two
+    // characters in a JSON string. The short result does not allocate memory.
+    if (Str.empty() || Str.size() > 2)
+      return false;
+    std::string Tmp;
+    Traits<std::string>::unescape(Str.data(), Str.data() + Str.size(), Tmp);
     if (Tmp.size() != 1)
       return false;
-    Dest = Lex.json()[Tmp.front()];
+    Dest = Tmp.front();
     return true;
   }
   inline static void unparse(String &JSON, char Obj) {
@@ -1115,18 +1870,204 @@ template<> struct Traits<char> {
   }
 };
 
-template<> struct Traits<int> {
-  inline static bool parse(int &Dest, Lexer &Lex) noexcept {
-    try {
-      std::string Str;
-      Traits<std::string>::parse(Str, Lex);
-      Dest = std::stoi(Str);
-    }
-    catch (...) {
+/// \brief Specialization of JSON serialization traits for interned strings.
+///
+/// A string is interned in the pool of a lexer (see Lexer::symbolPool()),
+/// memory is allocated only if the string has not been interned yet or if
+/// it contains escaped characters. If the lexer has no pool, the value is
+/// illegal.
+template<> struct Traits<Symbol> {
+  inline static bool parse(Symbol &Dest, Lexer &Lex) {
+    auto *Pool = Lex.symbolPool();
+    if (!Pool) {
+      Lex.addError(Error::ILLEGAL_VALUE, Lex.start());
       return false;
     }
+    auto Str = detail::tokenValue(Lex);
+    if (Str.find('\\') == std::string_view::npos) {
+      Dest = Pool->intern(Str);
+      return true;
+    }
+    std::string Unescaped;
+    Traits<std::string>::unescape(Str.data(), Str.data() + Str.size(),
+      Unescaped);
+    Dest = Pool->intern(Unescaped);
     return true;
   }
+  inline static void unparse(String &JSON, Symbol Obj) {
+    auto Str = Obj.str();
+    auto I = JSON.size() + 1;
+    JSON += '"';
+    JSON.append(Str.data(), Str.size());
+    JSON += '"';
+    for (; I < JSON.size() - 1; ++I)
+      I = Traits<std::string>::escape(JSON, I);
+  }
+};
+
+namespace detail {
+/// Computes FNV-1a hash of a specified string.
+constexpr std::uint32_t hashName(std::string_view Str) noexcept {
+  std::uint32_t Hash = 2166136261u;
+  for (char C : Str) {
+    Hash ^= static_cast<unsigned char>(C);
+    Hash *= 16777619u;
+  }
+  return Hash;
+}
+}
+
+/// Name of an enumerator.
+template<class EnumTy> struct EnumName {
+  EnumTy Value;
+  std::string_view Name;
+};
+
+/// \brief Implements JSON serialization traits for enumerations which are
+/// represented as strings.
+///
+/// A derived class must define an array of enumerators
+/// `static constexpr EnumName<EnumTy> Names[]`, use JSON_ENUM_TRAITS macro to
+/// define it. The following tables are built at compile time:
+/// - an open addressing hash table which maps names to enumerators,
+///   a name is compared only with names which have the same hash value;
+/// - if values of enumerators are dense, a table which maps values to names,
+///   otherwise enumerators are searched linearly when they are unparsed.
+/// Names must not contain characters which are escaped in JSON.
+template<class Derived, class EnumTy> struct EnumTraits {
+  static_assert(std::is_enum<EnumTy>::value, "Type must be an enumeration!");
+
+  inline static bool parse(EnumTy &Dest, Lexer &Lex) noexcept {
+    if (auto V = value(detail::tokenValue(Lex))) {
+      Dest = *V;
+      return true;
+    }
+    Lex.addError(Error::ILLEGAL_VALUE, Lex.start());
+    return false;
+  }
+
+  /// Unparses a specified enumerator, an unknown value is not unparsed.
+  inline static void unparse(String &JSON, EnumTy Obj) {
+    auto Name = name(Obj);
+    if (Name.empty())
+      return;
+    JSON += '"';
+    JSON.append(Name.data(), Name.size());
+    JSON += '"';
+  }
+
+  /// Returns an enumerator with a specified name or std::nullopt if the name
+  /// is unknown.
+  static constexpr std::optional<EnumTy> value(std::string_view Name) noexcept {
+    auto &Table = Tables<>::Hash;
+    auto Hash = detail::hashName(Name);
+    for (auto I = Hash & (Table.size() - 1); Table[I].Index != Empty;
+         I = (I + 1) & (Table.size() - 1))
+      if (Table[I].Hash == Hash && Derived::Names[Table[I].Index].Name == Name)
+        return Derived::Names[Table[I].Index].Value;
+    return std::nullopt;
+  }
+
+  /// Returns name of a specified enumerator or an empty string if it is
+  /// unknown.
+  static constexpr std::string_view name(EnumTy Obj) noexcept {
+    if constexpr (isDense()) {
+      auto &Table = Tables<>::Value;
+      auto Offset = static_cast<long long>(Obj) - minValue();
+      if (Offset < 0 || Offset >= static_cast<long long>(Table.size()) ||
+          Table[Offset] == Empty)
+        return std::string_view();
+      return Derived::Names[Table[Offset]].Name;
+    } else {
+      for (auto &N : Derived::Names)
+        if (N.Value == Obj)
+          return N.Name;
+      return std::string_view();
+    }
+  }
+
+private:
+  static constexpr std::size_t size() noexcept {
+    return sizeof(Derived::Names) / sizeof(Derived::Names[0]);
+  }
+
+  /// Index of a name which marks an empty element of a table.
+  static constexpr std::uint16_t Empty = UINT16_MAX;
+
+  struct HashEntry {
+    std::uint32_t Hash = 0;
+    std::uint16_t Index = Empty;
+  };
+
+  /// Returns the smallest power of two which is not less than twice number
+  /// of names.
+  static constexpr std::size_t hashTableSize() noexcept {
+    std::size_t Size = 1;
+    for (; Size < 2 * size(); Size *= 2);
+    return Size;
+  }
+
+  static constexpr auto makeHashTable() noexcept {
+    static_assert(size() > 0 && size() < Empty,
+      "Number of names must be in range [1, UINT16_MAX)!");
+    std::array<HashEntry, hashTableSize()> Table{};
+    for (std::size_t N = 0; N < size(); ++N) {
+      auto Hash = detail::hashName(Derived::Names[N].Name);
+      auto I = Hash & (Table.size() - 1);
+      for (; Table[I].Index != Empty; I = (I + 1) & (Table.size() - 1));
+      Table[I].Hash = Hash;
+      Table[I].Index = static_cast<std::uint16_t>(N);
+    }
+    return Table;
+  }
+
+  static constexpr long long minValue() noexcept {
+    auto Min = static_cast<long long>(Derived::Names[0].Value);
+    for (auto &N : Derived::Names)
+      Min = std::min(Min, static_cast<long long>(N.Value));
+    return Min;
+  }
+
+  static constexpr long long maxValue() noexcept {
+    auto Max = static_cast<long long>(Derived::Names[0].Value);
+    for (auto &N : Derived::Names)
+      Max = std::max(Max, static_cast<long long>(N.Value));
+    return Max;
+  }
+
+  /// Returns true if a table which maps values to names is not much larger
+  /// than a list of names.
+  static constexpr bool isDense() noexcept {
+    return static_cast<unsigned long long>(maxValue() - minValue()) <
+      4 * size() + 16;
+  }
+
+  /// Returns a table which maps an offset of a value from the minimum value
+  /// to index of its name, the first name is used for duplicate values.
+  static constexpr auto makeValueTable() noexcept {
+    std::array<std::uint16_t, isDense() ? maxValue() - minValue() + 1 : 1>
+      Table{};
+    for (auto &I : Table)
+      I = Empty;
+    if constexpr (isDense())
+      for (std::size_t N = size(); N > 0; --N)
+        Table[static_cast<long long>(Derived::Names[N - 1].Value) -
+          minValue()] = static_cast<std::uint16_t>(N - 1);
+    return Table;
+  }
+
+  /// Tables are built when they are used for the first time, so names
+  /// are already defined in a derived class.
+  template<class D = Derived> struct Tables {
+    static constexpr auto Hash = makeHashTable();
+    static constexpr auto Value = makeValueTable();
+  };
+};
+
+template<> struct Traits<int> {
+  inline static bool parse(int &Dest, Lexer &Lex) noexcept {
+    return detail::parseNumber(Dest, Lex);
+  }
   inline static void unparse(String &JSON, int Obj) {
     JSON += std::to_string(Obj);
   }
@@ -1134,15 +2075,7 @@ template<> struct Traits<int> {
 
 template<> struct Traits<long> {
   inline static bool parse(long &Dest, Lexer &Lex) noexcept {
-    try {
-      std::string Str;
-      Traits<std::string>::parse(Str, Lex);
-      Dest = std::stol(Str);
-    }
-    catch (...) {
-      return false;
-    }
-    return true;
+    return detail::parseNumber(Dest, Lex);
   }
   inline static void unparse(String &JSON, long Obj) {
     JSON += std::to_string(Obj);
@@ -1151,15 +2084,7 @@ template<> struct Traits<long> {
 
 template<> struct Traits<long long> {
   inline static bool parse(long long &Dest, Lexer &Lex) noexcept {
-    try {
-      std::string Str;
-      Traits<std::string>::parse(Str, Lex);
-      Dest = std::stoll(Str);
-    }
-    catch (...) {
-      return false;
-    }
-    return true;
+    return detail::parseNumber(Dest, Lex);
   }
   inline static void unparse(String &JSON, long long Obj) {
     JSON += std::to_string(Obj);
@@ -1168,15 +2093,7 @@ template<> struct Traits<long long> {
 
 template<> struct Traits<unsigned> {
   inline static bool parse(unsigned &Dest, Lexer &Lex) noexcept {
-    try {
-      std::string Str;
-      Traits<std::string>::parse(Str, Lex);
-      Dest = static_cast<unsigned>(std::stoul(Str));
-    }
-    catch (...) {
-      return false;
-    }
-    return true;
+    return detail::parseNumber(Dest, Lex);
   }
   inline static void unparse(String &JSON, unsigned Obj) {
     JSON += std::to_string(Obj);
@@ -1185,15 +2102,7 @@ template<> struct Traits<unsigned> {
 
 template<> struct Traits<unsigned long> {
   inline static bool parse(unsigned long &Dest, Lexer &Lex) noexcept {
-    try {
-      std::string Str;
-      Traits<std::string>::parse(Str, Lex);
-      Dest = std::stoul(Str);
-    }
-    catch (...) {
-      return false;
-    }
-    return true;
+    return detail::parseNumber(Dest, Lex);
   }
   inline static void unparse(String &JSON, unsigned long Obj) {
     JSON += std::to_string(Obj);
@@ -1202,15 +2111,7 @@ template<> struct Traits<unsigned long> {
 
 template<> struct Traits<unsigned long long> {
   inline static bool parse(unsigned long long &Dest, Lexer &Lex) noexcept {
-    try {
-      std::string Str;
-      Traits<std::string>::parse(Str, Lex);
-      Dest = std::stoull(Str);
-    }
-    catch (...) {
-      return false;
-    }
-    return true;
+    return detail::parseNumber(Dest, Lex);
   }
   inline static void unparse(String &JSON, unsigned long long Obj) {
     JSON += std::to_string(Obj);
@@ -1219,15 +2120,7 @@ template<> struct Traits<unsigned long long> {
 
 template<> struct Traits<float> {
   inline static bool parse(float &Dest, Lexer &Lex) noexcept {
-    try {
-      std::string Str;
-      Traits<std::string>::parse(Str, Lex);
-      Dest = std::stof(Str);
-    }
-    catch (...) {
-      return false;
-    }
-    return true;
+    return detail::parseNumber(Dest, Lex);
   }
   inline static void unparse(String &JSON, float Obj) {
     JSON += std::to_string(Obj);
@@ -1236,15 +2129,7 @@ template<> struct Traits<float> {
 
 template<> struct Traits<double> {
   inline static bool parse(double &Dest, Lexer &Lex) noexcept {
-    try {
-      std::string Str;
-      Traits<std::string>::parse(Str, Lex);
-      Dest = std::stod(Str);
-    }
-    catch (...) {
-      return false;
-    }
-    return true;
+    return detail::parseNumber(Dest, Lex);
   }
   inline static void unparse(String &JSON, double Obj) {
     JSON += std::to_string(Obj);
@@ -1253,21 +2138,15 @@ template<> struct Traits<double> {
 
 template<> struct Traits<bool> {
   inline static bool parse(bool &Dest, Lexer &Lex) noexcept {
-    try {
-      if (Lex.isKeyword(Keyword::TRUE)) {
-        return Dest = true;
-      } else if (Lex.isKeyword(Keyword::FALSE)) {
-        return !(Dest = false);
-      }
-      std::string Str;
-      Traits<std::string>::parse(Str, Lex);
-      Dest = Str == toString(Keyword::TRUE);
-      return (Str == toString(Keyword::TRUE) ||
-              Str == toString(Keyword::FALSE));
-    }
-    catch (...) {
-      return false;
+    if (Lex.isKeyword(Keyword::TRUE)) {
+      return Dest = true;
+    } else if (Lex.isKeyword(Keyword::FALSE)) {
+      return !(Dest = false);
     }
+    auto Str = detail::tokenValue(Lex);
+    Dest = Str == toString(Keyword::TRUE);
+    return (Str == toString(Keyword::TRUE) ||
+            Str == toString(Keyword::FALSE));
   }
   inline static void unparse(String &JSON, bool Obj) {
     JSON += Obj ? toString(Keyword::TRUE) : toString(Keyword::FALSE);
@@ -1276,67 +2155,34 @@ template<> struct Traits<bool> {
 
 template<> struct Traits<char *> {
   inline static bool parse(char *&Dest, Lexer &Lex) {
-    char *TmpDest = nullptr;
     if (Lex.is(Token::LEFT_BRACE) || Lex.is(Token::LEFT_BRACKET)) {
-      try {
-        Position MaxIdx, Count;
-        bool Ok;
-        std::tie(Count, MaxIdx, Ok) = Parser<>::numberOfKeys(Lex);
-        if (!Ok)
-          return false;
-        if (Count != 0) {
-          if (Count < MaxIdx + 1) {
-            /// User of JSON serializer can not determine if there is some
-            /// uninitialized elements in an array without manual parsing of
-            /// a JSON string. So do not parse such arrays. This array
-            /// should be parsed as a map.
-            Lex.errors().insert(JSON_ERROR(7), Lex.start());
-            throw 0;
-          } else if (Count > MaxIdx + 1) {
-            Lex.errors().insert(JSON_ERROR(8), Lex.start());
-
-            throw 0;
-          }
-          TmpDest = new char[MaxIdx + 1];
-        }
-        // Note, in case of empty array traverse also should be called to move
-        // lexer position to the end of this array.
-        if (!Parser<>::traverse<Traits<char *>>(TmpDest, Lex))
-          throw 0;
-      }
-      catch (...) {
-        if (TmpDest) { try { delete TmpDest; } catch (...) {} }
+      Position MaxIdx, Count;
+      bool Ok;
+      std::tie(Count, MaxIdx, Ok) = Parser<>::numberOfKeys(Lex);
+      if (!Ok || !detail::checkArrayKeys(Count, MaxIdx, Lex))
         return false;
-      }
-    } else {
-      try {
-        auto Value = Lex.discardQuote();
-        auto Unescaped = Traits<std::string>::unescape(
-          Lex.json().substr(Value.first, Value.second - Value.first + 1));
-        TmpDest = new char[Unescaped.length() + 1];
-        Unescaped.copy(TmpDest, Unescaped.length());
-        TmpDest[Unescaped.length()] = '\0';
-      }
-      catch (...) {
-        if (TmpDest) { try { delete TmpDest; } catch (...) {} }
+      std::unique_ptr<char[]> TmpDest(
+        Count != 0 ? new char[MaxIdx + 1] : nullptr);
+      // Note, in case of empty array traverse also should be called to move
+      // lexer position to the end of this array.
+      auto *Ptr = TmpDest.get();
+      if (!Parser<>::traverse<Traits<char *>>(Ptr, Lex))
         return false;
-      }
+      Dest = TmpDest.release();
+      return true;
     }
-    Dest = TmpDest;
+    std::string Unescaped;
+    auto Str = detail::tokenValue(Lex);
+    Traits<std::string>::unescape(Str.data(), Str.data() + Str.size(),
+      Unescaped);
+    Dest = new char[Unescaped.length() + 1];
+    Unescaped.copy(Dest, Unescaped.length());
+    Dest[Unescaped.length()] = '\0';
     return true;
   }
   inline static bool parse(char *&Dest, Lexer &Lex,
       std::pair<Position, Position> Key) {
-    if (Key.first != 0) {
-      // Note that Idx will be successfully converted because this check has
-      // been performed when memory for the Dest array has been allocated.
-      // This also implies that Dest[Idx] can not produce out of range exception.
-      auto Idx = std::stoull(
-        Lex.json().substr(Key.first + 1, Key.second - Key.first - 1));
-      return Traits<char>::parse(Dest[Idx], Lex);
-    } else {
-      return Traits<char>::parse(Dest[Key.second], Lex);
-    }
+    return Traits<char>::parse(Dest[detail::arrayIndex(Lex, Key)], Lex);
   }
   inline static void unparse(String &JSON, const char *Obj) {
     if (!Obj)
@@ -1352,65 +2198,41 @@ template<> struct Traits<char *> {
 
 template<class Ty> struct Traits<Ty *> {
   inline static bool parse(Ty *&Dest, Lexer &Lex) {
-    Ty *TmpDest = nullptr;
     if (Lex.is(Token::LEFT_BRACE) || Lex.is(Token::LEFT_BRACKET)) {
-      try {
-        Position MaxIdx, Count;
-        bool Ok;
-        std::tie(Count, MaxIdx, Ok) = Parser<>::numberOfKeys(Lex);
-        if (!Ok)
-          return false;
-        if (Count != 0) {
-          if (Count < MaxIdx + 1) {
-            /// User of JSON serializer can not determine if there is some
-            /// uninitialized elements in an array without manual parsing of
-            /// a JSON string. So do not parse such arrays. This array
-            /// should be parsed as a map.
-            Lex.errors().insert(JSON_ERROR(7), Lex.start());
-            throw 0;
-          } else if (Count > MaxIdx + 1) {
-            Lex.errors().insert(JSON_ERROR(8), Lex.start());
-
-            throw 0;
-          }
-          TmpDest = new Ty[MaxIdx + 1];
+      if constexpr (detail::is_number<Ty>::value) {
+        std::unique_ptr<Ty[]> TmpDest;
+        if (detail::parseNumberArray<Ty>(Lex, [&TmpDest](Position Count) {
+              TmpDest.reset(Count != 0 ? new Ty[Count] : nullptr);
+              return TmpDest.get();
+            })) {
+          Dest = TmpDest.release();
+          return true;
         }
-        // Note, in case of empty array traverse also should be called to move
-        // lexer position to the end of this array.
-        if (!Parser<>::traverse<Traits<Ty *>>(TmpDest, Lex))
-          throw 0;
       }
-      catch (...) {
-        if (TmpDest) { try { delete TmpDest; } catch (...) {} }
+      Position MaxIdx, Count;
+      bool Ok;
+      std::tie(Count, MaxIdx, Ok) = Parser<>::numberOfKeys(Lex);
+      if (!Ok || !detail::checkArrayKeys(Count, MaxIdx, Lex))
         return false;
-      }
-    } else {
-      try {
-        auto Value = Lex.discardQuote();
-        TmpDest = new Ty;
-        if (!Traits<Ty>::parse(*TmpDest, Lex))
-          throw 0;
-      }
-      catch (...) {
-        if (TmpDest) { try { delete TmpDest; } catch (...) {} }
+      std::unique_ptr<Ty[]> TmpDest(
+        Count != 0 ? new Ty[MaxIdx + 1] : nullptr);
+      // Note, in case of empty array traverse also should be called to move
+      // lexer position to the end of this array.
+      auto *Ptr = TmpDest.get();
+      if (!Parser<>::traverse<Traits<Ty *>>(Ptr, Lex))
         return false;
-      }
+      Dest = TmpDest.release();
+      return true;
     }
-    Dest = TmpDest;
+    std::unique_ptr<Ty> TmpDest(new Ty);
+    if (!Traits<Ty>::parse(*TmpDest, Lex))
+      return false;
+    Dest = TmpDest.release();
     return true;
   }
   inline static bool parse(Ty *&Dest, Lexer &Lex,
       std::pair<Position, Position> Key) {
-    if (Key.first != 0) {
-      // Note that Idx will be successfully converted because this check has
-      // been performed when memory for the Dest array has been allocated.
-      // This also implies that Dest[Idx] can not produce out of range exception.
-      auto Idx = std::stoull(
-        Lex.json().substr(Key.first + 1, Key.second - Key.first - 1));
-      return Traits<Ty>::parse(Dest[Idx], Lex);
-    } else {
-      return Traits<Ty>::parse(Dest[Key.second], Lex);
-    }
+    return Traits<Ty>::parse(Dest[detail::arrayIndex(Lex, Key)], Lex);
   }
   inline static void unparse(String &JSON, const Ty* Obj) {
     if (Obj)
@@ -1432,27 +2254,38 @@ template<class Ty> struct Traits<const Ty *> {
   }
 };
 
+namespace detail {
+/// \brief Creates a default value of a specified type using uses-allocator
+/// construction.
+///
+/// This allows elements which are parsed before insertion into a container to
+/// be allocated with the allocator of the container.
+template<class Ty, class Allocator>
+inline Ty makeUsingAllocator(const Allocator &A) {
+  if constexpr (!std::uses_allocator<Ty, Allocator>::value)
+    return Ty();
+  else if constexpr (
+      std::is_constructible<Ty, std::allocator_arg_t, const Allocator &>::value)
+    return Ty(std::allocator_arg, A);
+  else
+    return Ty(A);
+}
+}
+
 template<class Ty, class Allocator>
 struct Traits<std::vector<Ty, Allocator>> {
   inline static bool parse(std::vector<Ty, Allocator> &Dest, Lexer &Lex) {
+    if constexpr (detail::is_number<Ty>::value)
+      if (detail::parseNumberArray<Ty>(Lex, [&Dest](Position Count) {
+            Dest.resize(Count);
+            return Dest.data();
+          }))
+        return true;
     Position MaxIdx, Count;
     bool Ok;
     std::tie(Count, MaxIdx, Ok) = Parser<>::numberOfKeys(Lex);
-    if (!Ok)
+    if (!Ok || !detail::checkArrayKeys(Count, MaxIdx, Lex))
       return false;
-    if (Count != 0) {
-      if (Count < MaxIdx + 1) {
-        /// User of JSON serializer can not determine if there is some
-        /// uninitialized elements in an array without manual parsing of
-        /// a JSON string. So do not parse such arrays. This array
-        /// should be parsed as a map.
-        Lex.errors().insert(JSON_ERROR(7), Lex.start());
-        return false;
-      } else if (Count > MaxIdx + 1) {
-        Lex.errors().insert(JSON_ERROR(8), Lex.start());
-        return false;
-      }
-    }
     Dest.resize(Count);
     // Note, in case of empty array traverse also should be called to move
     // lexer position to the end of this array.
@@ -1461,20 +2294,32 @@ struct Traits<std::vector<Ty, Allocator>> {
   }
   inline static bool parse(std::vector<Ty, Allocator> &Dest, Lexer &Lex,
       std::pair<Position, Position> Key) {
-    if (Key.first != 0) {
-      // Note that Idx will be successfully converted because this check has
-      // been performed when memory for the Dest array has been allocated.
-      // This also implies that Dest[Idx] can not produce out of range exception.
-      auto Idx = std::stoull(
-        Lex.json().substr(Key.first + 1, Key.second - Key.first - 1));
-      return Traits<Ty>::parse(Dest[Idx], Lex);
-    } else {
-      return Traits<Ty>::parse(Dest[Key.second], Lex);
-    }
+    return Traits<Ty>::parse(Dest[detail::arrayIndex(Lex, Key)], Lex);
+  }
+  /// Unparses a single element in the same way as unparse() does, an empty
+  /// string is produced for an element which does not have representation.
+  inline static void unparseElement(String &JSON, const Ty &Obj) {
+    if constexpr (detail::is_number<Ty>::value)
+      detail::appendNumber(JSON, Obj);
+    else
+      Traits<Ty>::unparse(JSON, Obj);
   }
   inline static void unparse(String &JSON,
       const std::vector<Ty, Allocator> &Obj) {
     typedef std::vector<Ty, Allocator> VecTy;
+    if constexpr (detail::is_number<Ty>::value) {
+      // Numbers are never empty, so the array representation is used.
+      JSON += '[';
+      for (auto &V : Obj) {
+        unparseElement(JSON, V);
+        JSON += ',';
+      }
+      if (Obj.empty())
+        JSON += ']';
+      else
+        JSON.back() = ']';
+      return;
+    }
     if (!Obj.empty()) {
       std::vector<String> Values(Obj.size());
       bool HasEmpty = false;
@@ -1508,6 +2353,59 @@ struct Traits<std::vector<Ty, Allocator>> {
   }
 };
 
+namespace detail {
+/// \brief Implements conversion of a sequence of bytes to a base64 string.
+///
+/// A sequence is decoded directly into the destination, a temporary string is
+/// used only if the JSON string contains escaped characters.
+template<class BytesTy> struct BytesTraits {
+  inline static bool parse(BytesTy &Dest, Lexer &Lex) {
+    if (!Lex.checkIdentifier())
+      return false;
+    auto Str = tokenValue(Lex);
+    if (Str.find('\\') == std::string_view::npos)
+      return decode(Dest, Str, Lex);
+    std::string Unescaped;
+    Traits<std::string>::unescape(Str.data(), Str.data() + Str.size(),
+      Unescaped);
+    return decode(Dest, Unescaped, Lex);
+  }
+  inline static void unparse(String &JSON, const BytesTy &Obj) {
+    auto Pos = JSON.size();
+    JSON.resize(Pos + bcl::base64EncodedSize(Obj.size()) + 2);
+    JSON[Pos] = '"';
+    bcl::base64Encode(Obj.data(), Obj.size(), &JSON[Pos + 1]);
+    JSON.back() = '"';
+  }
+private:
+  inline static bool decode(BytesTy &Dest, std::string_view Str, Lexer &Lex) {
+    Dest.resize(bcl::base64DecodedSize(Str));
+    if (bcl::base64Decode(Str, Dest.data()))
+      return true;
+    Lex.addError(Error::ILLEGAL_VALUE, Lex.start());
+    return false;
+  }
+};
+}
+
+/// Specialization of JSON serialization traits for binary data, which is
+/// represented as a base64 string.
+template<class Allocator>
+struct Traits<std::vector<std::byte, Allocator>> :
+  public detail::BytesTraits<std::vector<std::byte, Allocator>> {};
+
+/// Specialization of JSON serialization traits for binary data, which is
+/// represented as a base64 string.
+template<class Allocator>
+struct Traits<std::vector<std::uint8_t, Allocator>> :
+  public detail::BytesTraits<std::vector<std::uint8_t, Allocator>> {};
+
+/// Specialization of JSON serialization traits for binary data, which is
+/// represented as a base64 string.
+template<class Allocator>
+struct Traits<bcl::basic_bytes<Allocator>> :
+  public detail::BytesTraits<bcl::basic_bytes<Allocator>> {};
+
 template<class KeyTy, class Compare, class Allocator>
 struct Traits<std::set<KeyTy, Compare, Allocator>> {
   typedef std::set<KeyTy, Compare, Allocator> SetTy;
@@ -1518,12 +2416,13 @@ struct Traits<std::set<KeyTy, Compare, Allocator>> {
   }
   inline static bool parse(SetTy &Dest, Lexer &Lex,
       std::pair<Position, Position> Key) {
-    KeyTy KeyValue;
+    auto KeyValue =
+      detail::makeUsingAllocator<KeyTy>(Dest.get_allocator());
     if (!Traits<KeyTy>::parse(KeyValue, Lex))
       return false;
     auto Pair = Dest.insert(std::move(KeyValue));
     if (!Pair.second) {
-      Lex.errors().insert(JSON_ERROR(8), Lex.start());
+      Lex.addError(Error::DUPLICATE_KEY, Lex.start());
       return false;
     }
     return true;
@@ -1559,12 +2458,16 @@ struct Traits<std::map<KeyTy, Ty, Compare, Allocator>> {
       std::pair<Position, Position> Key) {
     Lex.storePosition();
     Lex.setPosition(Key.first);
-    KeyTy KeyValue;
+    auto KeyValue =
+      detail::makeUsingAllocator<KeyTy>(Dest.get_allocator());
     Traits<KeyTy>::parse(KeyValue, Lex);
     Lex.restorePosition();
-    auto Pair = Dest.emplace(KeyValue, Ty());
+    // Piecewise construction allows the container to pass its allocator
+    // to the mapped value.
+    auto Pair = Dest.emplace(std::piecewise_construct,
+      std::forward_as_tuple(std::move(KeyValue)), std::forward_as_tuple());
     if (!Pair.second) {
-      Lex.errors().insert(JSON_ERROR(8), Lex.start());
+      Lex.addError(Error::DUPLICATE_KEY, Lex.start());
       return false;
     }
     if (!Traits<Ty>::parse(Pair.first->second, Lex)) {
@@ -1612,10 +2515,12 @@ struct Traits<std::multimap<KeyTy, Ty, Compare, Allocator>> {
     std::pair<Position, Position> Key) {
     Lex.storePosition();
     Lex.setPosition(Key.first);
-    KeyTy KeyValue;
+    auto KeyValue =
+      detail::makeUsingAllocator<KeyTy>(Dest.get_allocator());
     Traits<KeyTy>::parse(KeyValue, Lex);
     Lex.restorePosition();
-    auto Itr = Dest.emplace(KeyValue, Ty());
+    auto Itr = Dest.emplace(std::piecewise_construct,
+      std::forward_as_tuple(std::move(KeyValue)), std::forward_as_tuple());
     if (Itr == Dest.end())
       return false;
     if (!Traits<Ty>::parse(Itr->second, Lex)) {
@@ -1664,8 +2569,11 @@ public:
   ///
   /// The Key parameter is necessary to identify destination which should be set
   /// on the parsed value.
-  ParseCellFunctor(std::pair<Position, Position> Key, Lexer &Lex) : mLex(Lex),
-    mKey(Key), mHasError(false) {}
+  /// If Reset is true, a value is reset to a default one before it is parsed.
+  /// In this case `null` is not parsed, it only resets a value.
+  ParseCellFunctor(std::pair<Position, Position> Key, Lexer &Lex,
+      bool Reset = false) : mLex(Lex), mKey(Key), mHasError(false),
+    mReset(Reset) {}
 
   /// \brief Parses a value specified by the last token evaluated by the
   /// lexer, converts it to an appropriate type and assigns to a currently
@@ -1679,6 +2587,11 @@ public:
           mKey.first + 1, mKey.second - mKey.first - 1 ,
           CellTraits<CellKey>::name()) != 0)
       return;
+    if (mReset) {
+      Cell->template value<CellKey>() = typename CellKey::ValueType();
+      if (mLex.isKeyword(Keyword::NO_VALUE))
+        return;
+    }
     mHasError = !CellTraits<CellKey>::parse(
       Cell->template value<CellKey>(), mLex);
   }
@@ -1689,6 +2602,7 @@ private:
   Lexer &mLex;
   std::pair<Position, Position> mKey;
   bool mHasError;
+  bool mReset;
 };
 
 /// This functor unparses JSON object represented as a bcl::StaticMap. It should
@@ -1696,15 +2610,22 @@ private:
 class UnparseCellFunctor {
 public:
   /// Creates functor which stores unparsed data in a specified JSON string.
-  explicit UnparseCellFunctor(String &JSON) : mIsFirst(true), mJSON(JSON) {}
+  ///
+  /// If UnparseEmpty is true, a value which has an empty representation
+  /// is unparsed as `null`, otherwise it is omitted.
+  explicit UnparseCellFunctor(String &JSON, bool UnparseEmpty = false) :
+    mIsFirst(true), mUnparseEmpty(UnparseEmpty), mJSON(JSON) {}
 
   /// Unparses a specified cell if it has a value.
   template<class CellTy> void operator()(CellTy *Cell) {
     typedef typename CellTy::CellKey CellKey;
     String Value;
     CellTraits<CellKey>::unparse(Value, Cell->template value<CellKey>());
-    if (Value.empty())
-      return;
+    if (Value.empty()) {
+      if (!mUnparseEmpty)
+        return;
+      Value = toString(Keyword::NO_VALUE);
+    }
     if (!mIsFirst)
       mJSON += ',';
     else
@@ -1718,8 +2639,48 @@ public:
   }
 private:
   bool mIsFirst;
+  bool mUnparseEmpty;
   String &mJSON;
 };
+
+/// Returns true if values of a field are equal.
+template<class Ty> inline bool fieldEqual(const Ty &LHS, const Ty &RHS) {
+  return LHS == RHS;
+}
+
+/// Returns true if C strings are equal, they are compared by content.
+inline bool fieldEqual(const char *LHS, const char *RHS) {
+  return LHS == RHS || (LHS && RHS && std::strcmp(LHS, RHS) == 0);
+}
+
+/// Returns true if C strings are equal, they are compared by content.
+inline bool fieldEqual(char *LHS, char *RHS) {
+  return fieldEqual(static_cast<const char *>(LHS),
+    static_cast<const char *>(RHS));
+}
+
+/// This functor unparses cells of a JSON object represented as
+/// a bcl::StaticMap which differ from cells of a previous instance.
+///
+/// A changed value which has an empty representation is unparsed as `null`.
+template<class MapTy> class UnparseDeltaFunctor {
+public:
+  /// Creates functor which stores unparsed data in a specified JSON string.
+  UnparseDeltaFunctor(String &JSON, const MapTy &Prev) :
+    mUnparse(JSON, true), mPrev(Prev) {}
+
+  /// Unparses a specified cell if it has been changed.
+  template<class CellTy> void operator()(CellTy *Cell) {
+    typedef typename CellTy::CellKey CellKey;
+    if (fieldEqual(Cell->template value<CellKey>(),
+          mPrev.template value<CellKey>()))
+      return;
+    mUnparse(Cell);
+  }
+private:
+  UnparseCellFunctor mUnparse;
+  const MapTy &mPrev;
+};
 }
 
 template<class... Args> struct Traits<bcl::StaticMap<Args...>> {
@@ -1741,6 +2702,41 @@ template<class... Args> struct Traits<bcl::StaticMap<Args...>> {
     Obj.for_each(Unparse);
     JSON += '}';
   }
+
+  /// \brief Parses a partial object and applies it to an existing instance.
+  ///
+  /// Values of keys which occur in JSON string are replaced, other values
+  /// are preserved. A value is reset to a default one if it is `null`.
+  inline static bool merge(bcl::StaticMap<Args...> &Dest, Lexer &Lex) {
+    if (!Lex.checkSpecial(Token::LEFT_BRACE))
+      return false;
+    return Parser<>::traverse<MergeCells>(Dest, Lex);
+  }
+
+  /// \brief Unparses values which differ from values of a previous instance.
+  ///
+  /// Values are compared with operator==, C strings are compared by content
+  /// (see detail::fieldEqual()). A changed value which has an empty
+  /// representation (for example, a null pointer) is unparsed as `null`,
+  /// so merge() resets it.
+  inline static void unparse(String &JSON, const bcl::StaticMap<Args...> &Obj,
+      const bcl::StaticMap<Args...> &Prev) {
+    detail::UnparseDeltaFunctor<bcl::StaticMap<Args...>> Unparse(JSON, Prev);
+    JSON += '{';
+    Obj.for_each(Unparse);
+    JSON += '}';
+  }
+
+private:
+  /// Parses values which should replace existing ones.
+  struct MergeCells {
+    inline static bool parse(bcl::StaticMap<Args...> &Dest, Lexer &Lex,
+        std::pair<Position, Position> Key) {
+      detail::ParseCellFunctor Parse(Key, Lex, true);
+      Dest.for_each(Parse);
+      return !Parse.hasError();
+    }
+  };
 };
 
 template<class... Objects> std::tuple<Position, Position, bool>
@@ -1794,6 +2790,63 @@ Parser<Objects...>::numberOfKeys(Lexer &Lex) {
     Count, Last == Token::RIGHT_BRACE ? MaxIdx : Count - 1, true);
 }
 
+namespace detail {
+/// Output which counts characters instead of storing them, it is used
+/// to determine size of an unescaped string and whether it contains null
+/// characters.
+class CharCounter {
+public:
+  void reserve(std::size_t) noexcept {}
+  void append(const char *I, const char *EI) noexcept {
+    mHasNull |= std::memchr(I, '\0', EI - I) != nullptr;
+    mSize += EI - I;
+  }
+  std::size_t size() const noexcept { return mSize; }
+  bool hasNull() const noexcept { return mHasNull; }
+  CharCounter & operator+=(char C) noexcept {
+    mHasNull |= C == '\0';
+    ++mSize;
+    return *this;
+  }
+private:
+  std::size_t mSize = 0;
+  bool mHasNull = false;
+};
+
+/// Output which writes characters to a preallocated buffer.
+class CharWriter {
+public:
+  explicit CharWriter(char *Buf) noexcept : mBuf(Buf), mPtr(Buf) {}
+  void reserve(std::size_t) noexcept {}
+  void append(const char *I, const char *EI) noexcept {
+    std::memcpy(mPtr, I, EI - I);
+    mPtr += EI - I;
+  }
+  std::size_t size() const noexcept { return mPtr - mBuf; }
+  CharWriter & operator+=(char C) noexcept {
+    *mPtr++ = C;
+    return *this;
+  }
+private:
+  char *mBuf;
+  char *mPtr;
+};
+}
+
+/// \brief Specialization of JSON serialization traits for diagnostics.
+///
+/// Each diagnostic is represented as an object
+/// {"Kind":"error","Code":101,"Position":100,"Message":"..."}, Kind is
+/// optional when a diagnostic is parsed, however it must be equal to the kind
+/// of the destination container. A message is unescaped directly into the
+/// container storage without temporary buffers. A message which contains
+/// null characters is rejected with Error::ILLEGAL_VALUE.
+/// The legacy representation of a diagnostic as a string
+/// "<Kind> C<Code>(<Pos>): <Message>" can be also parsed.
+///
+/// Releases before the object representation can parse the legacy one
+/// only. Define BCL_JSON_LEGACY_DIAGNOSTIC to unparse diagnostics in the
+/// legacy representation, or use unparseLegacy() for a single container.
 template<> struct Traits<bcl::Diagnostic> {
   inline static bool parse(bcl::Diagnostic &Dest, Lexer &Lex) {
     return Parser<>::
@@ -1801,37 +2854,148 @@ template<> struct Traits<bcl::Diagnostic> {
   }
   inline static bool parse(bcl::Diagnostic &Dest, Lexer &Lex,
     std::pair<Position, Position>) {
-    const char *Msg;
-    if (!Traits<const char *>::parse(Msg, Lex))
+    if (Lex.is(Token::LEFT_BRACE))
+      return parseObject(Dest, Lex);
+    if (!Lex.checkIdentifier())
       return false;
-    char *Kind = new char[std::strlen(Msg) + 1];
-    char *Buf = new char[std::strlen(Msg) + 1];
-    std::size_t Code;
-    std::uintmax_t Pos;
-    auto ArgNum = std::sscanf(Msg, "%s C%zu(%ju): %s", Kind, &Code, &Pos, Buf);
-    if (ArgNum != 4 || std::strcmp(Kind, Dest.getKind()) != 0 ||
-        !Dest.insert(Code, "%s", Pos, Buf)) {
-      Lex.errors().insert(JSON_ERROR(9), Lex.start());
-      delete[]Kind;
-      delete[]Buf;
-      return false;
-    }
-    delete[]Kind;
-    delete[]Buf;
-    return true;
+    auto Str = detail::tokenValue(Lex);
+    if (Str.find('\\') == std::string_view::npos)
+      return insert(Dest, Lex, Str);
+    std::string Unescaped;
+    Traits<std::string>::unescape(Str.data(), Str.data() + Str.size(),
+      Unescaped);
+    return insert(Dest, Lex, Unescaped);
   }
   inline static void unparse(String &JSON, const bcl::Diagnostic &Obj) {
+#ifdef BCL_JSON_LEGACY_DIAGNOSTIC
+    unparseLegacy(JSON, Obj);
+#else
     JSON += '[';
-    if (!Obj.empty()) {
-      auto I = Obj.begin(), EI = Obj.end();
-      bcl::Diagnostic::size_type Idx = 0;
-      for (--EI; I != EI; ++I, ++Idx) {
-        Traits<bcl::Diagnostic::value_type>::unparse(JSON, *I);
-        JSON += ',';
+    for (auto *D : Obj) {
+      bcl::Diagnostic::Components C;
+      if (!bcl::Diagnostic::split(D, C)) {
+        Traits<bcl::Diagnostic::value_type>::unparse(JSON, D);
+      } else {
+        JSON += "{\"Kind\":";
+        appendString(JSON, C.Kind);
+        JSON += ",\"Code\":";
+        detail::appendNumber(JSON, C.Code);
+        JSON += ",\"Position\":";
+        detail::appendNumber(JSON, C.Pos);
+        JSON += ",\"Message\":";
+        appendString(JSON, C.Message);
+        JSON += '}';
       }
-      Traits<bcl::Diagnostic::value_type>::unparse(JSON, *I);
+      JSON += ',';
     }
-    JSON += ']';
+    if (Obj.empty())
+      JSON += ']';
+    else
+      JSON.back() = ']';
+#endif
+  }
+
+  /// Unparses each diagnostic as a string "<Kind> C<Code>(<Pos>): <Message>".
+  inline static void unparseLegacy(String &JSON, const bcl::Diagnostic &Obj) {
+    JSON += '[';
+    for (auto *D : Obj) {
+      Traits<bcl::Diagnostic::value_type>::unparse(JSON, D);
+      JSON += ',';
+    }
+    if (Obj.empty())
+      JSON += ']';
+    else
+      JSON.back() = ']';
+  }
+private:
+  /// Components of a diagnostic which are stored in a JSON string.
+  struct Fields {
+    std::string_view Kind;
+    bcl::Diagnostic::size_type Code = 0;
+    std::uintmax_t Pos = 0;
+    std::string_view Message;
+    bool HasCode = false;
+    bool HasPos = false;
+    bool HasMessage = false;
+  };
+
+  /// Parses a value of a field of a diagnostic, unknown fields are ignored.
+  struct FieldTraits {
+    inline static bool parse(Fields &Dest, Lexer &Lex,
+        std::pair<Position, Position> Key) {
+      auto Name = std::string_view(Lex.json()).substr(
+        Key.first + 1, Key.second - Key.first - 1);
+      if (Name == "Code" || Name == "Position") {
+        bool Ok = Name == "Code" ?
+          (Dest.HasCode = detail::parseNumber(Dest.Code, Lex)) :
+          (Dest.HasPos = detail::parseNumber(Dest.Pos, Lex));
+        if (!Ok)
+          Lex.addError(Error::CONVERSION, Lex.start());
+        return Ok;
+      }
+      if (Name == "Kind" || Name == "Message") {
+        if (!Lex.checkIdentifier())
+          return false;
+        (Name == "Kind" ? Dest.Kind : Dest.Message) = detail::tokenValue(Lex);
+        Dest.HasMessage |= Name == "Message";
+        return true;
+      }
+      if (Lex.is(Token::LEFT_BRACE) || Lex.is(Token::LEFT_BRACKET))
+        return Lex.skipInternal();
+      return true;
+    }
+  };
+
+  inline static bool parseObject(bcl::Diagnostic &Dest, Lexer &Lex) {
+    auto Start = Lex.start();
+    Fields F;
+    if (!Parser<>::traverse<FieldTraits>(F, Lex))
+      return false;
+    // Kinds are not expected to contain escaped characters, so Kind is
+    // compared as is.
+    if (!F.HasCode || !F.HasPos || !F.HasMessage ||
+        (!F.Kind.empty() && F.Kind != Dest.getKind())) {
+      Lex.addError(Error::ILLEGAL_VALUE, Start);
+      return false;
+    }
+    auto *I = F.Message.data(), *EI = I + F.Message.size();
+    detail::CharCounter Counter;
+    Traits<std::string>::unescape(I, EI, Counter);
+    if (Counter.hasNull()) {
+      Lex.addError(Error::ILLEGAL_VALUE, Start);
+      return false;
+    }
+    if (!Dest.insert_text(F.Code, F.Pos, Counter.size(),
+          [I, EI](char *Buf) noexcept {
+            detail::CharWriter Writer(Buf);
+            Traits<std::string>::unescape(I, EI, Writer);
+          })) {
+      Lex.addError(Error::ILLEGAL_VALUE, Start);
+      return false;
+    }
+    return true;
+  }
+
+  /// Inserts a diagnostic in the legacy representation.
+  inline static bool insert(bcl::Diagnostic &Dest, Lexer &Lex,
+      std::string_view Str) {
+    bcl::Diagnostic::Components C;
+    if (!bcl::Diagnostic::split(Str, C) || C.Kind != Dest.getKind() ||
+        C.Message.find('\0') != std::string_view::npos ||
+        !Dest.insert_text(C.Code, C.Pos, C.Message)) {
+      Lex.addError(Error::ILLEGAL_VALUE, Lex.start());
+      return false;
+    }
+    return true;
+  }
+
+  inline static void appendString(String &JSON, std::string_view Str) {
+    auto I = JSON.size() + 1;
+    JSON += '"';
+    JSON.append(Str.data(), Str.size());
+    JSON += '"';
+    for (; I < JSON.size() - 1; ++I)
+      I = Traits<std::string>::escape(JSON, I);
   }
 };
 
@@ -1843,22 +3007,16 @@ template<class T> struct Traits<std::optional<T>> {
     "Underlining type must be default constructible!");
   static_assert(std::is_copy_assignable<T>::value,
     "Underlining type must be copy assignable!");
-  static bool parse(std::optional<T> &Dest, ::json::Lexer &Lex) noexcept {
-    try {
-      std::string Str;
-      if (Lex.isKeyword(Keyword::NO_VALUE) ||
-          Traits<std::string>::parse(Str, Lex) &&
-              Str == toString(Keyword::NO_VALUE)) {
-        Dest.reset();
-      } else {
-        T Tmp;
-        Traits<T>::parse(Tmp, Lex);
-        Dest = std::move(Tmp);
-      }
+  static bool parse(std::optional<T> &Dest, ::json::Lexer &Lex) {
+    if (Lex.isKeyword(Keyword::NO_VALUE) ||
+        detail::tokenValue(Lex) == toString(Keyword::NO_VALUE)) {
+      Dest.reset();
+      return true;
     }
-    catch (...) {
+    T Tmp;
+    if (!Traits<T>::parse(Tmp, Lex))
       return false;
-    }
+    Dest = std::move(Tmp);
     return true;
   }
   static void unparse(String &JSON, const std::optional<T> &Obj) {
@@ -1868,6 +3026,127 @@ template<class T> struct Traits<std::optional<T>> {
       JSON += toString(Keyword::NO_VALUE);
   }
 };
+
+/// \brief Describes representation of a std::variant in a JSON string.
+///
+/// A variant is represented as an object of its current alternative with
+/// an additional discriminator {"name":"Alternative", ...}. This class can be
+/// specialized to change the discriminator key.
+template<class VariantTy> struct VariantTraits {
+  /// Returns key of a discriminator.
+  static const char * key() noexcept { return "name"; }
+};
+
+/// \brief Specialization of JSON serialization traits for std::variant type.
+///
+/// Each alternative must be default constructible, its representation must
+/// be a JSON object and it must propose a static `name()` method which
+/// identifies the alternative (for example, it may be defined with
+/// JSON_OBJECT_ROOT). A value is constructed in-place inside a variant,
+/// so neither heap allocation nor virtual dispatch are necessary to parse
+/// a value of an unknown type.
+///
+/// Alternatives are unparsed with a leading discriminator. If a discriminator
+/// is the first key in a JSON string, only this key is traversed twice.
+/// Otherwise, all preceding keys are skipped to find a discriminator and
+/// then they are traversed again when the alternative is parsed.
+template<class... Ts> struct Traits<std::variant<Ts...>> {
+  using VariantTy = std::variant<Ts...>;
+
+  static_assert(std::conjunction<std::is_default_constructible<Ts>...>::value,
+    "Alternatives must be default constructible!");
+
+  static bool parse(VariantTy &Dest, Lexer &Lex) {
+    auto Begin = Lex.start();
+    if (!Lex.checkSpecial(Token::LEFT_BRACE))
+      return false;
+    const char *Key = VariantTraits<VariantTy>::key();
+    auto NumErrors = Lex.errorRecords().size();
+    while (Lex.goToNext()) {
+      if (Lex.is(Token::RIGHT_BRACE) || !Lex.checkIdentifier())
+        break;
+      bool IsKey = Lex.json().compare(
+        Lex.start() + 1, Lex.end() - Lex.start() - 1, Key) == 0;
+      if (!Lex.goToNext() || !Lex.checkSpecial(Token::COLON) ||
+          !Lex.goToNext())
+        return false;
+      if (IsKey) {
+        if (!Lex.checkIdentifier())
+          return false;
+        if (!emplace(Dest, detail::tokenValue(Lex),
+              std::index_sequence_for<Ts...>())) {
+          Lex.addError(Error::ILLEGAL_VALUE, Lex.start());
+          return false;
+        }
+        Lex.setPosition(Begin);
+        return std::visit([&Lex](auto &Alt) {
+          return Traits<std::decay_t<decltype(Alt)>>::parse(Alt, Lex);
+        }, Dest);
+      }
+      if (Lex.is(Token::LEFT_BRACE) || Lex.is(Token::LEFT_BRACKET)) {
+        if (!Lex.skipInternal())
+          return false;
+      } else if (!Lex.checkValue()) {
+        return false;
+      }
+      if (!Lex.goToNext())
+        return false;
+      if (Lex.is(Token::RIGHT_BRACE) || !Lex.checkSpecial(Token::COMMA))
+        break;
+    }
+    if (Lex.errorRecords().size() == NumErrors)
+      Lex.addError(Error::UNKNOWN_IDENTIFIER, Lex.start(), Key);
+    return false;
+  }
+
+  /// \brief Unparses the current alternative.
+  ///
+  /// A valueless variant can not be parsed back, so std::bad_variant_access
+  /// is thrown in this case.
+  static void unparse(String &JSON, const VariantTy &Obj) {
+    if (Obj.valueless_by_exception())
+      throw std::bad_variant_access();
+    auto Begin = JSON.size();
+    std::visit([&JSON](const auto &Alt) {
+      Traits<std::decay_t<decltype(Alt)>>::unparse(JSON, Alt);
+    }, Obj);
+    assert(Begin < JSON.size() && JSON[Begin] == '{' &&
+      "Alternative of a variant must be represented as a JSON object!");
+    // The name may be returned by value, so it is copied.
+    String Name = std::visit([](const auto &Alt) {
+      return String(std::decay_t<decltype(Alt)>::name());
+    }, Obj);
+    std::string_view Key = VariantTraits<VariantTy>::key();
+    bool IsEmpty = JSON[Begin + 1] == '}';
+    String Discriminator;
+    Discriminator.reserve(Key.size() + Name.size() + 6);
+    Discriminator += '"';
+    Discriminator += Key;
+    Discriminator += "\":\"";
+    Discriminator += Name;
+    Discriminator += '"';
+    if (!IsEmpty)
+      Discriminator += ',';
+    JSON.insert(Begin + 1, Discriminator);
+  }
+
+private:
+  /// Constructs an alternative with a specified name, returns false if
+  /// there is no such alternative.
+  template<std::size_t... Is>
+  static bool emplace(VariantTy &Dest, std::string_view Name,
+      std::index_sequence<Is...>) {
+    return ((Name == std::string_view(
+      std::variant_alternative_t<Is, VariantTy>::name()) &&
+        (Dest.template emplace<Is>(), true)) || ...);
+  }
+};
+}
+
+namespace std {
+template<> struct hash<json::Symbol> {
+  std::size_t operator()(json::Symbol S) const noexcept { return S.hash(); }
+};
 }
 
 //===- Definition of macros which simplifies definition of a JSON-object --===//
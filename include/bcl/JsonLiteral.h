@@ -0,0 +1,520 @@
+//===--- JsonLiteral.h ---- Compile-Time JSON Literals ----------*- C++ -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements json::Literal, a view of a constant JSON string which
+// can be checked and converted to values at compile time. This is useful for
+// configurations and test fixtures which are embedded as string literals:
+// they are not parsed at startup and a malformed literal is a compile error.
+// \code
+//   constexpr json::Literal Config(R"j({"Port": 8080, "Host": "localhost"})j");
+//   constexpr auto Port = Config["Port"].get<unsigned>();
+//   constexpr auto Host = Config["Host"].get<std::string_view>();
+// \endcode
+//
+// Conversions are implemented in specializations of json::LiteralTraits.
+// Built-in specializations support bool, integral and floating-point types,
+// std::string_view, std::optional, std::array and enumerations registered
+// with JSON_ENUM_TRAITS. Only literal types can be created at compile time,
+// so objects which store dynamically allocated data (for example,
+// std::string) should be parsed with json::Parser at run time.
+//
+// If an error occurs json::LiteralError is thrown, so the error stops
+// compilation if a literal is evaluated in a constant expression.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef BCL_JSON_LITERAL_H
+#define BCL_JSON_LITERAL_H
+
+#include "Json.h"
+#include <array>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace json {
+/// Exception which is thrown if a JSON literal is malformed or can not be
+/// converted to a requested type.
+class LiteralError : public std::invalid_argument {
+public:
+  LiteralError(Error Code, Position Pos) :
+    std::invalid_argument(message(Code)), mCode(Code), mPos(Pos) {}
+
+  /// Returns kind of an error.
+  Error code() const noexcept { return mCode; }
+
+  /// Returns position of an error in a JSON literal.
+  Position position() const noexcept { return mPos; }
+
+private:
+  static const char * message(Error Code) noexcept {
+    switch (Code) {
+    case Error::UNEXPECTED_END: return "json literal: unexpected end";
+    case Error::UNEXPECTED_CHARACTER:
+      return "json literal: unexpected character";
+    case Error::UNKNOWN_IDENTIFIER: return "json literal: unknown key";
+    case Error::IDENTIFIER_EXPECTED: return "json literal: key expected";
+    case Error::VALUE_EXPECTED: return "json literal: value expected";
+    case Error::CONVERSION: return "json literal: conversion error";
+    default: return "json literal: illegal value";
+    }
+  }
+
+  Error mCode;
+  Position mPos;
+};
+
+/// Kind of a value in a JSON literal.
+enum class LiteralKind : uint8_t {
+  NO_VALUE = 0,
+  BOOL,
+  NUMBER,
+  STRING,
+  ARRAY,
+  OBJECT,
+};
+
+namespace detail {
+constexpr void literalExpect(bool Cond, Error Code, Position Pos) {
+  if (!Cond)
+    throw LiteralError(Code, Pos);
+}
+
+constexpr bool isLiteralSpace(char C) noexcept {
+  return C == ' ' || C == '\t' || C == '\n' || C == '\r';
+}
+
+constexpr bool isLiteralDigit(char C) noexcept {
+  return C >= '0' && C <= '9';
+}
+
+constexpr bool isLiteralHexDigit(char C) noexcept {
+  return isLiteralDigit(C) || (C >= 'a' && C <= 'f') || (C >= 'A' && C <= 'F');
+}
+
+constexpr Position literalSkipSpaces(std::string_view S, Position I) noexcept {
+  for (; I < S.size() && isLiteralSpace(S[I]); ++I);
+  return I;
+}
+
+/// Skips a string which starts at a specified position (at the opening quote)
+/// and returns position after the closing quote.
+constexpr Position literalSkipString(std::string_view S, Position I) {
+  for (++I;; ++I) {
+    literalExpect(I < S.size(), Error::UNEXPECTED_END, I);
+    if (S[I] == '"')
+      return I + 1;
+    literalExpect(static_cast<unsigned char>(S[I]) >= 0x20,
+      Error::UNEXPECTED_CHARACTER, I);
+    if (S[I] != '\\')
+      continue;
+    ++I;
+    literalExpect(I < S.size(), Error::UNEXPECTED_END, I);
+    switch (S[I]) {
+    case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r':
+    case 't':
+      break;
+    case 'u':
+      for (unsigned D = 0; D < 4; ++D) {
+        ++I;
+        literalExpect(I < S.size(), Error::UNEXPECTED_END, I);
+        literalExpect(isLiteralHexDigit(S[I]), Error::UNEXPECTED_CHARACTER, I);
+      }
+      break;
+    default:
+      literalExpect(false, Error::UNEXPECTED_CHARACTER, I);
+    }
+  }
+}
+
+/// Skips a number which starts at a specified position and returns position
+/// after the number.
+constexpr Position literalSkipNumber(std::string_view S, Position I) {
+  auto skipDigits = [S](Position I) {
+    literalExpect(I < S.size(), Error::UNEXPECTED_END, I);
+    literalExpect(isLiteralDigit(S[I]), Error::UNEXPECTED_CHARACTER, I);
+    for (; I < S.size() && isLiteralDigit(S[I]); ++I);
+    return I;
+  };
+  if (S[I] == '-')
+    ++I;
+  literalExpect(I < S.size(), Error::UNEXPECTED_END, I);
+  if (S[I] == '0')
+    ++I;
+  else
+    I = skipDigits(I);
+  if (I < S.size() && S[I] == '.')
+    I = skipDigits(I + 1);
+  if (I < S.size() && (S[I] == 'e' || S[I] == 'E')) {
+    ++I;
+    if (I < S.size() && (S[I] == '+' || S[I] == '-'))
+      ++I;
+    I = skipDigits(I);
+  }
+  return I;
+}
+
+/// Skips a value which starts at a specified position and returns position
+/// after the value. The value is checked.
+constexpr Position literalSkipValue(std::string_view S, Position I) {
+  literalExpect(I < S.size(), Error::UNEXPECTED_END, I);
+  switch (S[I]) {
+  case '"':
+    return literalSkipString(S, I);
+  case '[':
+    I = literalSkipSpaces(S, I + 1);
+    if (I < S.size() && S[I] == ']')
+      return I + 1;
+    for (;;) {
+      I = literalSkipSpaces(S, literalSkipValue(S, I));
+      literalExpect(I < S.size(), Error::UNEXPECTED_END, I);
+      if (S[I] == ']')
+        return I + 1;
+      literalExpect(S[I] == ',', Error::UNEXPECTED_CHARACTER, I);
+      I = literalSkipSpaces(S, I + 1);
+    }
+  case '{':
+    I = literalSkipSpaces(S, I + 1);
+    if (I < S.size() && S[I] == '}')
+      return I + 1;
+    for (;;) {
+      literalExpect(I < S.size(), Error::UNEXPECTED_END, I);
+      literalExpect(S[I] == '"', Error::IDENTIFIER_EXPECTED, I);
+      I = literalSkipSpaces(S, literalSkipString(S, I));
+      literalExpect(I < S.size(), Error::UNEXPECTED_END, I);
+      literalExpect(S[I] == ':', Error::UNEXPECTED_CHARACTER, I);
+      I = literalSkipSpaces(S, I + 1);
+      I = literalSkipSpaces(S, literalSkipValue(S, I));
+      literalExpect(I < S.size(), Error::UNEXPECTED_END, I);
+      if (S[I] == '}')
+        return I + 1;
+      literalExpect(S[I] == ',', Error::UNEXPECTED_CHARACTER, I);
+      I = literalSkipSpaces(S, I + 1);
+    }
+  default:
+    if (S[I] == '-' || isLiteralDigit(S[I]))
+      return literalSkipNumber(S, I);
+    // KeywordTable is not constexpr, so keywords are duplicated here.
+    constexpr std::string_view Keywords[] = {"true", "false", "null"};
+    for (auto Name : Keywords)
+      if (S.substr(I, Name.size()) == Name)
+        return I + Name.size();
+    literalExpect(false, Error::VALUE_EXPECTED, I);
+    return I;
+  }
+}
+}
+
+/// \brief Conversion of a JSON literal to a value.
+///
+/// A specialization should define `static constexpr Ty get(const Literal &)`
+/// which throws json::LiteralError if a literal can not be converted.
+template<class Ty, class Enable = void> struct LiteralTraits;
+
+/// \brief View of a value in a constant JSON string.
+///
+/// The whole string is checked when a literal is constructed, so a view of
+/// its nested value does not check it again. Elements of arrays and objects
+/// are found with a linear search, keys are compared with escape sequences
+/// as is.
+class Literal {
+public:
+  /// Checks a specified JSON string, throws json::LiteralError if it is
+  /// malformed.
+  constexpr explicit Literal(std::string_view JSON) :
+      mJSON(JSON), mBegin(detail::literalSkipSpaces(JSON, 0)), mEnd(0) {
+    mEnd = detail::literalSkipValue(JSON, mBegin);
+    detail::literalExpect(detail::literalSkipSpaces(JSON, mEnd) == JSON.size(),
+      Error::UNEXPECTED_CHARACTER, detail::literalSkipSpaces(JSON, mEnd));
+  }
+
+  /// Returns kind of this value.
+  constexpr LiteralKind kind() const noexcept {
+    switch (mJSON[mBegin]) {
+    case '{': return LiteralKind::OBJECT;
+    case '[': return LiteralKind::ARRAY;
+    case '"': return LiteralKind::STRING;
+    case 't': case 'f': return LiteralKind::BOOL;
+    case 'n': return LiteralKind::NO_VALUE;
+    default: return LiteralKind::NUMBER;
+    }
+  }
+
+  /// Returns text of this value.
+  constexpr std::string_view str() const noexcept {
+    return mJSON.substr(mBegin, mEnd - mBegin);
+  }
+
+  /// Returns position of this value in a JSON string.
+  constexpr Position position() const noexcept { return mBegin; }
+
+  /// Returns number of elements in an array or an object, other values
+  /// do not have elements.
+  constexpr std::size_t size() const noexcept {
+    std::size_t Size = 0;
+    for (auto I = first(); I != mEnd; I = next(I), ++Size);
+    return Size;
+  }
+
+  constexpr bool empty() const noexcept { return first() == mEnd; }
+
+  /// Returns an element of an array or a value of a member of an object
+  /// with a specified index.
+  constexpr Literal operator[](std::size_t Idx) const {
+    auto I = first();
+    for (; I != mEnd && Idx > 0; I = next(I), --Idx);
+    detail::literalExpect(I != mEnd, Error::ILLEGAL_VALUE, mBegin);
+    return kind() == LiteralKind::OBJECT ? valueOf(I) : element(I);
+  }
+
+  /// Returns a value of a member of an object with a specified key.
+  constexpr Literal operator[](std::string_view Key) const {
+    auto I = find(Key);
+    detail::literalExpect(I != mEnd, Error::UNKNOWN_IDENTIFIER, mBegin);
+    return valueOf(I);
+  }
+
+  /// Returns true if this is an object which contains a specified key.
+  constexpr bool contains(std::string_view Key) const noexcept {
+    return find(Key) != mEnd;
+  }
+
+  /// Returns a key of a member of an object with a specified index.
+  constexpr std::string_view key(std::size_t Idx) const {
+    detail::literalExpect(kind() == LiteralKind::OBJECT,
+      Error::ILLEGAL_VALUE, mBegin);
+    auto I = first();
+    for (; I != mEnd && Idx > 0; I = next(I), --Idx);
+    detail::literalExpect(I != mEnd, Error::ILLEGAL_VALUE, mBegin);
+    return keyOf(I);
+  }
+
+  /// Converts this value to a specified type (see json::LiteralTraits).
+  template<class Ty> constexpr Ty get() const {
+    return LiteralTraits<Ty>::get(*this);
+  }
+
+private:
+  constexpr Literal(std::string_view JSON, Position Begin, Position End)
+    noexcept : mJSON(JSON), mBegin(Begin), mEnd(End) {}
+
+  /// Returns position of the first element of an array or an object or
+  /// the end of this value if there are no elements.
+  constexpr Position first() const noexcept {
+    if (mJSON[mBegin] != '[' && mJSON[mBegin] != '{')
+      return mEnd;
+    auto I = detail::literalSkipSpaces(mJSON, mBegin + 1);
+    return I + 1 == mEnd ? mEnd : I;
+  }
+
+  /// Returns position of an element which follows an element at a specified
+  /// position or the end of this value.
+  constexpr Position next(Position I) const noexcept {
+    if (mJSON[mBegin] == '{')
+      I = detail::literalSkipSpaces(mJSON, valueOf(I).mEnd);
+    else
+      I = detail::literalSkipSpaces(mJSON, detail::literalSkipValue(mJSON, I));
+    return mJSON[I] == ',' ? detail::literalSkipSpaces(mJSON, I + 1) : mEnd;
+  }
+
+  constexpr Literal element(Position I) const noexcept {
+    return Literal(mJSON, I, detail::literalSkipValue(mJSON, I));
+  }
+
+  constexpr std::string_view keyOf(Position I) const noexcept {
+    auto E = detail::literalSkipString(mJSON, I);
+    return mJSON.substr(I + 1, E - I - 2);
+  }
+
+  constexpr Literal valueOf(Position I) const noexcept {
+    I = detail::literalSkipSpaces(mJSON, detail::literalSkipString(mJSON, I));
+    return element(detail::literalSkipSpaces(mJSON, I + 1));
+  }
+
+  constexpr Position find(std::string_view Key) const noexcept {
+    if (mJSON[mBegin] != '{')
+      return mEnd;
+    auto I = first();
+    for (; I != mEnd && keyOf(I) != Key; I = next(I));
+    return I;
+  }
+
+  std::string_view mJSON;
+  Position mBegin;
+  Position mEnd;
+};
+
+template<> struct LiteralTraits<bool> {
+  static constexpr bool get(const Literal &L) {
+    detail::literalExpect(L.kind() == LiteralKind::BOOL, Error::CONVERSION,
+      L.position());
+    return L.str() == "true";
+  }
+};
+
+/// Numbers with a fraction or an exponent can not be converted to integers.
+template<class Ty>
+struct LiteralTraits<Ty, typename std::enable_if<
+    std::is_integral<Ty>::value && !std::is_same<Ty, bool>::value>::type> {
+  static constexpr Ty get(const Literal &L) {
+    detail::literalExpect(L.kind() == LiteralKind::NUMBER, Error::CONVERSION,
+      L.position());
+    auto Str = L.str();
+    bool IsNegative = Str[0] == '-';
+    detail::literalExpect(!IsNegative || std::is_signed<Ty>::value,
+      Error::CONVERSION, L.position());
+    // Accumulate a negative value to represent the minimum value.
+    Ty Value = 0;
+    for (std::size_t I = IsNegative ? 1 : 0; I < Str.size(); ++I) {
+      detail::literalExpect(detail::isLiteralDigit(Str[I]), Error::CONVERSION,
+        L.position() + I);
+      Ty D = Str[I] - '0';
+      if (IsNegative) {
+        detail::literalExpect(
+          Value >= (std::numeric_limits<Ty>::min() + D) / 10,
+          Error::CONVERSION, L.position());
+        Value = Value * 10 - D;
+      } else {
+        detail::literalExpect(
+          Value <= (std::numeric_limits<Ty>::max() - D) / 10,
+          Error::CONVERSION, L.position());
+        Value = Value * 10 + D;
+      }
+    }
+    return Value;
+  }
+};
+
+/// \brief Conversion of a number to a floating-point value.
+///
+/// Up to 19 significant digits are taken into account. The result is
+/// computed in long double: the digits are scaled by powers of ten which do
+/// not exceed 1e22, such powers are exact even if long double is double, so
+/// each step rounds once. For a number N * 10^E, where N has at most 19
+/// digits, the error before the conversion to Ty is at most
+/// ceil(|E| / 22) + 1 units in the last place of long double. So, if long
+/// double is wider than Ty (for example, x87 extended precision and double)
+/// the result differs from std::from_chars() at most in the last bit, and if
+/// long double is double (MSVC, many ARM targets) it may differ in several
+/// last bits for large exponents. Subnormal results may be less precise.
+template<class Ty>
+struct LiteralTraits<Ty, typename std::enable_if<
+    std::is_floating_point<Ty>::value>::type> {
+  static constexpr Ty get(const Literal &L) {
+    detail::literalExpect(L.kind() == LiteralKind::NUMBER, Error::CONVERSION,
+      L.position());
+    auto Str = L.str();
+    std::size_t I = Str[0] == '-' ? 1 : 0;
+    unsigned long long Mantissa = 0;
+    long long Exp = 0;
+    unsigned Digits = 0;
+    for (bool IsFraction = false; I < Str.size(); ++I) {
+      if (Str[I] == '.') {
+        IsFraction = true;
+        continue;
+      }
+      if (!detail::isLiteralDigit(Str[I]))
+        break;
+      if (Digits < 19) {
+        Mantissa = Mantissa * 10 + (Str[I] - '0');
+        Digits += Mantissa != 0;
+        Exp -= IsFraction;
+      } else {
+        Exp += !IsFraction;
+      }
+    }
+    if (I < Str.size()) {
+      bool IsNegativeExp = Str[++I] == '-';
+      I += Str[I] == '-' || Str[I] == '+';
+      long long E = 0;
+      for (; I < Str.size() && E < 100000; ++I)
+        E = E * 10 + (Str[I] - '0');
+      Exp += IsNegativeExp ? -E : E;
+    }
+    long double Value = Mantissa;
+    for (auto E = Exp < 0 ? -Exp : Exp; E > 0 && Value != 0;) {
+      auto Step = E < 22 ? E : 22;
+      E -= Step;
+      long double Scale = 1;
+      for (; Step > 0; --Step)
+        Scale *= 10;
+      if (Exp < 0) {
+        Value /= Scale;
+      } else {
+        detail::literalExpect(
+          Value <= std::numeric_limits<long double>::max() / Scale,
+          Error::CONVERSION, L.position());
+        Value *= Scale;
+      }
+    }
+    detail::literalExpect(Value <= std::numeric_limits<Ty>::max(),
+      Error::CONVERSION, L.position());
+    return static_cast<Ty>(Str[0] == '-' ? -Value : Value);
+  }
+};
+
+/// Strings which contain escape sequences can not be represented without
+/// a copy, so they can not be converted to std::string_view.
+template<> struct LiteralTraits<std::string_view> {
+  static constexpr std::string_view get(const Literal &L) {
+    detail::literalExpect(L.kind() == LiteralKind::STRING, Error::CONVERSION,
+      L.position());
+    auto Str = L.str().substr(1, L.str().size() - 2);
+    detail::literalExpect(Str.find('\\') == std::string_view::npos,
+      Error::CONVERSION, L.position() + 1 + Str.find('\\'));
+    return Str;
+  }
+};
+
+/// Null is converted to std::nullopt.
+template<class Ty> struct LiteralTraits<std::optional<Ty>> {
+  static constexpr std::optional<Ty> get(const Literal &L) {
+    if (L.kind() == LiteralKind::NO_VALUE)
+      return std::nullopt;
+    return L.get<Ty>();
+  }
+};
+
+/// An array must contain exactly N elements.
+template<class Ty, std::size_t N> struct LiteralTraits<std::array<Ty, N>> {
+  static constexpr std::array<Ty, N> get(const Literal &L) {
+    detail::literalExpect(L.kind() == LiteralKind::ARRAY && L.size() == N,
+      Error::CONVERSION, L.position());
+    std::array<Ty, N> Value{};
+    for (std::size_t I = 0; I < N; ++I)
+      Value[I] = L[I].get<Ty>();
+    return Value;
+  }
+};
+
+/// Enumerations must be registered with JSON_ENUM_TRAITS.
+template<class Ty>
+struct LiteralTraits<Ty,
+    typename std::enable_if<std::is_enum<Ty>::value>::type> {
+  static constexpr Ty get(const Literal &L) {
+    auto V = Traits<Ty>::value(L.get<std::string_view>());
+    detail::literalExpect(V.has_value(), Error::ILLEGAL_VALUE, L.position());
+    return *V;
+  }
+};
+}
+#endif//BCL_JSON_LITERAL_H
@@ -0,0 +1,342 @@
+//===------- Nullable.h ------- Nullable Values -----------------*- C++ -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines bcl::Nullable<T>, a std::optional-like value which may be
+// undefined. It replaces legacy Utility::Value<T, Utility::True> (see
+// legacy/adapter.h for compatibility adapters).
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef BCL_NULLABLE_H
+#define BCL_NULLABLE_H
+
+#include <cassert>
+#include <functional>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace bcl {
+/// \brief Customization point which allows bcl::Nullable<T> to store
+/// an undefined value in-band.
+///
+/// A specialization should define `static constexpr T value() noexcept` which
+/// returns a sentinel and `static constexpr bool is_null(const T &) noexcept`.
+/// If a specialization is available, bcl::Nullable<T> has the same size as T.
+/// Pointers use nullptr as a sentinel.
+template<class T, class Enable = void> struct null_value {};
+
+template<class T> struct null_value<T *> {
+  static constexpr T * value() noexcept { return nullptr; }
+  static constexpr bool is_null(T *V) noexcept { return V == nullptr; }
+};
+
+/// This is true if a sentinel is defined for type T (see bcl::null_value).
+template<class T, class Enable = void>
+struct has_null_value : public std::false_type {};
+
+template<class T>
+struct has_null_value<T, std::void_t<decltype(null_value<T>::value())>> :
+  public std::true_type {};
+
+template<class T> class Nullable;
+
+/// This is true if T is a specialization of bcl::Nullable.
+template<class T> struct is_nullable : public std::false_type {};
+template<class T> struct is_nullable<Nullable<T>> : public std::true_type {};
+
+namespace detail {
+/// Storage of a value which is neither trivially copyable nor has a sentinel.
+template<class T, class Enable = void> class NullableStorage {
+public:
+  constexpr NullableStorage() noexcept = default;
+
+  template<class... ArgT>
+  constexpr explicit NullableStorage(std::in_place_t, ArgT &&... Args) :
+    mValue(std::in_place, std::forward<ArgT>(Args)...) {}
+
+  constexpr bool has_value() const noexcept { return mValue.has_value(); }
+  constexpr T & get() noexcept { return *mValue; }
+  constexpr const T & get() const noexcept { return *mValue; }
+  void reset() noexcept { mValue.reset(); }
+
+  template<class... ArgT> T & emplace(ArgT &&... Args) {
+    return mValue.emplace(std::forward<ArgT>(Args)...);
+  }
+
+private:
+  std::optional<T> mValue;
+};
+
+/// Storage which represents an undefined value with a sentinel.
+template<class T>
+class NullableStorage<T,
+    typename std::enable_if<has_null_value<T>::value>::type> {
+public:
+  constexpr NullableStorage() noexcept = default;
+
+  template<class... ArgT>
+  constexpr explicit NullableStorage(std::in_place_t, ArgT &&... Args) :
+    mValue(std::forward<ArgT>(Args)...) {}
+
+  constexpr bool has_value() const noexcept {
+    return !null_value<T>::is_null(mValue);
+  }
+  constexpr T & get() noexcept { return mValue; }
+  constexpr const T & get() const noexcept { return mValue; }
+  void reset() noexcept { mValue = null_value<T>::value(); }
+
+  template<class... ArgT> T & emplace(ArgT &&... Args) {
+    return mValue = T(std::forward<ArgT>(Args)...);
+  }
+
+private:
+  T mValue = null_value<T>::value();
+};
+
+/// Storage of a trivially copyable value which does not have a sentinel.
+///
+/// The value is stored in a union, so T is not constructed if the value is
+/// undefined and the storage remains trivially copyable.
+template<class T>
+class NullableStorage<T,
+    typename std::enable_if<!has_null_value<T>::value &&
+      std::is_trivially_copyable<T>::value>::type> {
+public:
+  constexpr NullableStorage() noexcept = default;
+
+  template<class... ArgT>
+  constexpr explicit NullableStorage(std::in_place_t, ArgT &&... Args) :
+    mValue(std::forward<ArgT>(Args)...), mHasValue(true) {}
+
+  constexpr bool has_value() const noexcept { return mHasValue; }
+  constexpr T & get() noexcept { return mValue; }
+  constexpr const T & get() const noexcept { return mValue; }
+  void reset() noexcept { mHasValue = false; }
+
+  template<class... ArgT> T & emplace(ArgT &&... Args) {
+    mHasValue = false;
+    ::new (static_cast<void *>(&mValue)) T(std::forward<ArgT>(Args)...);
+    mHasValue = true;
+    return mValue;
+  }
+
+private:
+  union {
+    char mDummy = 0;
+    T mValue;
+  };
+  bool mHasValue = false;
+};
+}
+
+/// \brief Value which may be undefined.
+///
+/// This is similar to std::optional<T>, however the layout is chosen
+/// to be as compact as possible:
+/// - if bcl::null_value<T> is specialized (for example, T is a pointer),
+///   the undefined value is represented with a sentinel and
+///   sizeof(Nullable<T>) == sizeof(T);
+/// - otherwise, if T is trivially copyable, Nullable<T> is trivially copyable
+///   too, so it can be passed in registers and copied with memcpy().
+/// Note, that if a sentinel is used, construction from the sentinel produces
+/// an undefined value.
+template<class T> class Nullable {
+  static_assert(!std::is_reference<T>::value,
+    "Nullable reference is not supported!");
+
+  template<class U> using enable_if_forward_t = typename std::enable_if<
+    std::is_constructible<T, U &&>::value &&
+    !std::is_same<typename std::decay<U>::type, Nullable>::value &&
+    !std::is_same<typename std::decay<U>::type, std::nullopt_t>::value &&
+    !std::is_same<typename std::decay<U>::type, std::in_place_t>::value>::type;
+
+public:
+  using value_type = T;
+
+  /// Creates an undefined value.
+  constexpr Nullable() noexcept = default;
+
+  /// Creates an undefined value.
+  constexpr Nullable(std::nullopt_t) noexcept {}
+
+  /// Creates a value which is initialized with a specified one.
+  template<class U = T, class = enable_if_forward_t<U>>
+  constexpr Nullable(U &&V) : mStorage(std::in_place, std::forward<U>(V)) {}
+
+  /// Creates a value in-place.
+  template<class... ArgT>
+  constexpr explicit Nullable(std::in_place_t, ArgT &&... Args) :
+    mStorage(std::in_place, std::forward<ArgT>(Args)...) {}
+
+  /// Creates a value from a standard optional value.
+  Nullable(const std::optional<T> &V) {
+    if (V)
+      mStorage.emplace(*V);
+  }
+
+  /// Makes this value undefined.
+  Nullable & operator=(std::nullopt_t) noexcept {
+    reset();
+    return *this;
+  }
+
+  /// Assigns a specified value.
+  template<class U = T, class = enable_if_forward_t<U>>
+  Nullable & operator=(U &&V) {
+    mStorage.emplace(std::forward<U>(V));
+    return *this;
+  }
+
+  /// Returns true if the value is defined.
+  constexpr bool has_value() const noexcept { return mStorage.has_value(); }
+
+  /// Returns true if the value is defined.
+  constexpr explicit operator bool() const noexcept { return has_value(); }
+
+  /// Returns stored value, the value must be defined.
+  constexpr T & operator*() noexcept {
+    assert(has_value() && "Value must be defined!");
+    return mStorage.get();
+  }
+
+  /// Returns stored value, the value must be defined.
+  constexpr const T & operator*() const noexcept {
+    assert(has_value() && "Value must be defined!");
+    return mStorage.get();
+  }
+
+  constexpr T * operator->() noexcept { return &operator*(); }
+  constexpr const T * operator->() const noexcept { return &operator*(); }
+
+  /// Returns stored value, throws std::bad_optional_access if the value
+  /// is undefined.
+  constexpr T & value() {
+    if (!has_value())
+      throw std::bad_optional_access();
+    return mStorage.get();
+  }
+
+  /// Returns stored value, throws std::bad_optional_access if the value
+  /// is undefined.
+  constexpr const T & value() const {
+    if (!has_value())
+      throw std::bad_optional_access();
+    return mStorage.get();
+  }
+
+  /// Returns stored value if it is defined or a specified default value.
+  template<class U> constexpr T value_or(U &&Default) const {
+    return has_value() ? mStorage.get() :
+      static_cast<T>(std::forward<U>(Default));
+  }
+
+  /// Makes this value undefined.
+  void reset() noexcept { mStorage.reset(); }
+
+  /// Constructs a new value in-place.
+  template<class... ArgT> T & emplace(ArgT &&... Args) {
+    return mStorage.emplace(std::forward<ArgT>(Args)...);
+  }
+
+  /// Converts this value to a standard optional value.
+  std::optional<T> toOptional() const {
+    return has_value() ? std::optional<T>(mStorage.get()) : std::nullopt;
+  }
+
+private:
+  detail::NullableStorage<T> mStorage;
+};
+
+template<class T, class U>
+constexpr bool operator==(const Nullable<T> &LHS, const Nullable<U> &RHS) {
+  return LHS.has_value() == RHS.has_value() && (!LHS || *LHS == *RHS);
+}
+
+template<class T, class U>
+constexpr bool operator!=(const Nullable<T> &LHS, const Nullable<U> &RHS) {
+  return !(LHS == RHS);
+}
+
+/// Undefined value is less than any defined value.
+template<class T, class U>
+constexpr bool operator<(const Nullable<T> &LHS, const Nullable<U> &RHS) {
+  return RHS && (!LHS || *LHS < *RHS);
+}
+
+template<class T>
+constexpr bool operator==(const Nullable<T> &LHS, std::nullopt_t) noexcept {
+  return !LHS;
+}
+
+template<class T>
+constexpr bool operator==(std::nullopt_t, const Nullable<T> &RHS) noexcept {
+  return !RHS;
+}
+
+template<class T>
+constexpr bool operator!=(const Nullable<T> &LHS, std::nullopt_t) noexcept {
+  return static_cast<bool>(LHS);
+}
+
+template<class T>
+constexpr bool operator!=(std::nullopt_t, const Nullable<T> &RHS) noexcept {
+  return static_cast<bool>(RHS);
+}
+
+/// Undefined value is not equal to any defined value.
+template<class T, class U,
+  class = typename std::enable_if<!is_nullable<U>::value>::type,
+  class = decltype(std::declval<const T &>() == std::declval<const U &>())>
+constexpr bool operator==(const Nullable<T> &LHS, const U &RHS) {
+  return LHS && *LHS == RHS;
+}
+
+template<class T, class U,
+  class = typename std::enable_if<!is_nullable<U>::value>::type,
+  class = decltype(std::declval<const U &>() == std::declval<const T &>())>
+constexpr bool operator==(const U &LHS, const Nullable<T> &RHS) {
+  return RHS && LHS == *RHS;
+}
+
+template<class T, class U,
+  class = typename std::enable_if<!is_nullable<U>::value>::type,
+  class = decltype(std::declval<const T &>() == std::declval<const U &>())>
+constexpr bool operator!=(const Nullable<T> &LHS, const U &RHS) {
+  return !(LHS == RHS);
+}
+
+template<class T, class U,
+  class = typename std::enable_if<!is_nullable<U>::value>::type,
+  class = decltype(std::declval<const U &>() == std::declval<const T &>())>
+constexpr bool operator!=(const U &LHS, const Nullable<T> &RHS) {
+  return !(LHS == RHS);
+}
+}
+
+namespace std {
+template<class T> struct hash<bcl::Nullable<T>> {
+  std::size_t operator()(const bcl::Nullable<T> &V) const {
+    return V ? std::hash<T>()(*V) : static_cast<std::size_t>(0);
+  }
+};
+}
+#endif//BCL_NULLABLE_H
@@ -0,0 +1,225 @@
+//===----- SmallString.h ----- Inline String Storage ------------*- C++ -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a string with inline storage and functions which convert
+// values to text without heap allocation. It replaces legacy Base::Text and
+// Base::ToText() in code which builds short texts (for example, error
+// messages). Strings which are not modified should be passed as
+// std::string_view.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef BCL_SMALL_STRING_H
+#define BCL_SMALL_STRING_H
+
+#include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace bcl {
+/// \brief String which stores up to N characters inline.
+///
+/// The string is trivially copyable and never allocates memory. Characters
+/// which do not fit into the storage are dropped, so methods which append
+/// characters return false if the string has been truncated.
+/// The string is always null-terminated.
+template<std::size_t N> class SmallString {
+  using SizeT = typename std::conditional<(N <= UINT8_MAX), std::uint8_t,
+    typename std::conditional<(N <= UINT16_MAX), std::uint16_t,
+      std::size_t>::type>::type;
+
+public:
+  using value_type = char;
+  using size_type = std::size_t;
+  using iterator = char *;
+  using const_iterator = const char *;
+
+  /// Returns maximum number of characters.
+  static constexpr size_type capacity() noexcept { return N; }
+
+  /// Creates an empty string.
+  SmallString() noexcept { mData[0] = '\0'; }
+
+  /// Creates a string which contains a specified text, the text is truncated
+  /// if it does not fit into the storage.
+  SmallString(std::string_view S) noexcept : SmallString() { append(S); }
+
+  /// Creates a string which contains a specified text, the text is truncated
+  /// if it does not fit into the storage.
+  SmallString(const char *S) noexcept : SmallString(std::string_view(S)) {}
+
+  /// Appends a specified text and returns false if it has been truncated.
+  bool append(std::string_view S) noexcept {
+    auto Count = S.size() < N - mSize ? S.size() : N - mSize;
+    std::memcpy(mData + mSize, S.data(), Count);
+    mSize += static_cast<SizeT>(Count);
+    mData[mSize] = '\0';
+    return Count == S.size();
+  }
+
+  /// Appends a specified character and returns false if there is no space.
+  bool push_back(char C) noexcept {
+    if (mSize == N)
+      return false;
+    mData[mSize++] = C;
+    mData[mSize] = '\0';
+    return true;
+  }
+
+  SmallString & operator+=(std::string_view S) noexcept {
+    append(S);
+    return *this;
+  }
+
+  SmallString & operator+=(char C) noexcept {
+    push_back(C);
+    return *this;
+  }
+
+  /// Removes all characters.
+  void clear() noexcept {
+    mSize = 0;
+    mData[0] = '\0';
+  }
+
+  size_type size() const noexcept { return mSize; }
+  size_type length() const noexcept { return mSize; }
+  bool empty() const noexcept { return mSize == 0; }
+
+  char * data() noexcept { return mData; }
+  const char * data() const noexcept { return mData; }
+  const char * c_str() const noexcept { return mData; }
+
+  char & operator[](size_type I) noexcept {
+    assert(I < mSize && "Index is out of range!");
+    return mData[I];
+  }
+
+  const char & operator[](size_type I) const noexcept {
+    assert(I < mSize && "Index is out of range!");
+    return mData[I];
+  }
+
+  iterator begin() noexcept { return mData; }
+  iterator end() noexcept { return mData + mSize; }
+  const_iterator begin() const noexcept { return mData; }
+  const_iterator end() const noexcept { return mData + mSize; }
+
+  operator std::string_view() const noexcept {
+    return std::string_view(mData, mSize);
+  }
+
+  /// Returns a copy of this string which uses heap storage.
+  std::string str() const { return std::string(mData, mSize); }
+
+private:
+  char mData[N + 1];
+  SizeT mSize = 0;
+};
+
+template<std::size_t N>
+bool operator==(const SmallString<N> &LHS, std::string_view RHS) noexcept {
+  return std::string_view(LHS) == RHS;
+}
+
+template<std::size_t N>
+bool operator==(std::string_view LHS, const SmallString<N> &RHS) noexcept {
+  return LHS == std::string_view(RHS);
+}
+
+template<std::size_t N, std::size_t M>
+bool operator==(const SmallString<N> &LHS, const SmallString<M> &RHS) noexcept {
+  return std::string_view(LHS) == std::string_view(RHS);
+}
+
+template<std::size_t N>
+bool operator!=(const SmallString<N> &LHS, std::string_view RHS) noexcept {
+  return !(LHS == RHS);
+}
+
+template<std::size_t N>
+bool operator!=(std::string_view LHS, const SmallString<N> &RHS) noexcept {
+  return !(LHS == RHS);
+}
+
+template<std::size_t N, std::size_t M>
+bool operator!=(const SmallString<N> &LHS, const SmallString<M> &RHS) noexcept {
+  return !(LHS == RHS);
+}
+
+template<std::size_t N>
+std::ostream & operator<<(std::ostream &OS, const SmallString<N> &S) {
+  return OS.write(S.data(), S.size());
+}
+
+/// Maximum number of characters which are necessary to represent a value
+/// of an arithmetic type T.
+template<class T, class Enable = void> struct text_size {};
+
+template<class T>
+struct text_size<T, typename std::enable_if<std::is_integral<T>::value>::type> :
+  public std::integral_constant<std::size_t,
+    std::numeric_limits<T>::digits10 + 2> {};
+
+/// Sign, point, exponent marker, exponent sign and up to 5 exponent digits.
+template<class T>
+struct text_size<T,
+    typename std::enable_if<std::is_floating_point<T>::value>::type> :
+  public std::integral_constant<std::size_t,
+    std::numeric_limits<T>::max_digits10 + 9> {};
+
+/// \brief Converts a specified arithmetic value to text.
+///
+/// This is a replacement of Base::ToText() which does not allocate memory.
+/// Floating-point values use the shortest representation which can be read
+/// back exactly.
+template<class T, class = typename std::enable_if<
+  std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type>
+SmallString<text_size<T>::value> toText(T Value) noexcept {
+  char Buf[text_size<T>::value];
+  auto Res = std::to_chars(Buf, Buf + sizeof(Buf), Value);
+  assert(Res.ec == std::errc() && "Buffer is too small!");
+  return SmallString<text_size<T>::value>(
+    std::string_view(Buf, Res.ptr - Buf));
+}
+
+/// \brief Copies a specified string to a buffer of a specified size.
+///
+/// The copy is always null-terminated. This is a replacement of
+/// Base::CopyString() which does not throw: it returns false if the string
+/// has been truncated.
+inline bool copyString(char *To, std::size_t ToSize,
+    std::string_view From) noexcept {
+  if (ToSize == 0)
+    return From.empty();
+  auto Count = From.size() < ToSize ? From.size() : ToSize - 1;
+  std::memcpy(To, From.data(), Count);
+  To[Count] = '\0';
+  return Count == From.size();
+}
+}
+#endif//BCL_SMALL_STRING_H
@@ -0,0 +1,330 @@
+//===------ StablePool.h ---- Stable Object Pool ----------------*- C++ -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a pool of objects which are never moved after creation.
+// It can be used instead of a vector of bcl::ValuePtrWrapper<T> when external
+// references to stored objects have to be kept valid.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef BCL_STABLE_POOL_H
+#define BCL_STABLE_POOL_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bcl {
+/// \brief Pool of objects with stable addresses.
+///
+/// Objects are stored in chunks of `ChunkSize` slots. Chunks are never
+/// reallocated, so pointers and references to objects remain valid until
+/// objects are erased. Emplacement and erasure take O(1), released slots
+/// are reused through a free list.
+///
+/// Each object is identified by a handle. The handle stores a slot index and
+/// a generation of the slot, so it never requires update and it is possible
+/// to check whether an object a handle refers to is still alive.
+///
+/// Iteration visits live objects only, it does not scan released slots.
+/// Note, that erasure changes the order of iteration.
+/// \code
+/// bcl::StablePool<T> Pool;
+/// auto H = Pool.emplace(Arg1, ..., ArgN);
+/// T *Ptr = Pool.get(H);
+/// \endcode
+/// So, a new object T(Arg1, ..., ArgN) is stored in a Pool, and Ptr always
+/// points to this object until Pool.erase(H) is called.
+template<class T, std::size_t ChunkSize = 256>
+class StablePool {
+  static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0,
+    "Size of a chunk must be a power of two!");
+
+  using IndexT = std::uint32_t;
+
+  /// Storage for a single object.
+  ///
+  /// A slot is alive if its generation is odd. Released slots are linked
+  /// into the free list, and live slots store a position of an object in
+  /// the list of live objects.
+  struct Slot {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type mStorage;
+    IndexT mGeneration = 0;
+    IndexT mLink = 0;
+
+    T * get() noexcept { return reinterpret_cast<T *>(&mStorage); }
+    const T * get() const noexcept {
+      return reinterpret_cast<const T *>(&mStorage);
+    }
+    bool isAlive() const noexcept { return mGeneration & 1; }
+  };
+
+  static constexpr IndexT NoSlot = ~IndexT(0);
+
+  template<bool IsConst> class iterator_imp {
+    using PoolT =
+      typename std::conditional<IsConst, const StablePool, StablePool>::type;
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = typename std::conditional<IsConst, const T *, T *>::type;
+    using reference = typename std::conditional<IsConst, const T &, T &>::type;
+
+    iterator_imp() = default;
+    iterator_imp(PoolT &Pool, std::size_t Idx) noexcept :
+      mPool(&Pool), mIdx(Idx) {}
+
+    /// Implicit conversion from a mutable iterator to a constant one.
+    template<bool IsFromConst,
+      class = typename std::enable_if<IsConst && !IsFromConst>::type>
+    iterator_imp(const iterator_imp<IsFromConst> &From) noexcept :
+      mPool(From.mPool), mIdx(From.mIdx) {}
+
+    bool operator==(const iterator_imp &RHS) const noexcept {
+      return mIdx == RHS.mIdx;
+    }
+    bool operator!=(const iterator_imp &RHS) const noexcept {
+      return !operator==(RHS);
+    }
+
+    iterator_imp & operator++() noexcept { ++mIdx; return *this; }
+    iterator_imp operator++(int) noexcept {
+      auto Tmp = *this; ++*this; return Tmp;
+    }
+
+    reference operator*() const noexcept {
+      return *mPool->slot(mPool->mLive[mIdx]).get();
+    }
+    pointer operator->() const noexcept { return &operator*(); }
+
+    /// Returns handle of an object this iterator points to.
+    auto getHandle() const noexcept {
+      return mPool->makeHandle(mPool->mLive[mIdx]);
+    }
+
+  private:
+    template<bool> friend class iterator_imp;
+
+    PoolT *mPool = nullptr;
+    std::size_t mIdx = 0;
+  };
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using iterator = iterator_imp<false>;
+  using const_iterator = iterator_imp<true>;
+
+  /// Identifier of an object in a pool.
+  ///
+  /// Default constructed handle does not refer to any object.
+  class handle {
+  public:
+    handle() = default;
+
+    bool operator==(const handle &RHS) const noexcept {
+      return mIdx == RHS.mIdx && mGeneration == RHS.mGeneration;
+    }
+    bool operator!=(const handle &RHS) const noexcept {
+      return !operator==(RHS);
+    }
+
+    /// Returns true if this handle has been obtained from a pool.
+    explicit operator bool() const noexcept { return mIdx != NoSlot; }
+
+  private:
+    friend class StablePool;
+    handle(IndexT Idx, IndexT Generation) noexcept :
+      mIdx(Idx), mGeneration(Generation) {}
+
+    IndexT mIdx = NoSlot;
+    IndexT mGeneration = 0;
+  };
+
+  /// Creates an empty pool, no memory is allocated.
+  StablePool() = default;
+
+  StablePool(const StablePool &) = delete;
+  StablePool & operator=(const StablePool &) = delete;
+
+  /// Moves all objects to a new pool, objects do not change their addresses.
+  StablePool(StablePool &&From) noexcept :
+      mChunks(std::move(From.mChunks)), mLive(std::move(From.mLive)),
+      mFree(From.mFree) {
+    From.mChunks.clear();
+    From.mLive.clear();
+    From.mFree = NoSlot;
+  }
+
+  StablePool & operator=(StablePool &&From) noexcept {
+    if (this != &From) {
+      clear();
+      mChunks = std::move(From.mChunks);
+      mLive = std::move(From.mLive);
+      mFree = From.mFree;
+      From.mChunks.clear();
+      From.mLive.clear();
+      From.mFree = NoSlot;
+    }
+    return *this;
+  }
+
+  ~StablePool() { destroyAll(); }
+
+  /// Constructs a new object in a pool and returns its handle.
+  template<class... ArgT> handle emplace(ArgT &&... Args) {
+    if (mFree == NoSlot)
+      grow();
+    IndexT Idx = mFree;
+    auto &S = slot(Idx);
+    mLive.push_back(Idx);
+    try {
+      ::new (static_cast<void *>(&S.mStorage)) T(std::forward<ArgT>(Args)...);
+    } catch (...) {
+      mLive.pop_back();
+      throw;
+    }
+    mFree = S.mLink;
+    ++S.mGeneration;
+    S.mLink = static_cast<IndexT>(mLive.size() - 1);
+    return handle(Idx, S.mGeneration);
+  }
+
+  /// Destroys an object a specified handle refers to.
+  ///
+  /// The handle must refer to a live object.
+  void erase(handle H) {
+    assert(contains(H) && "Handle must refer to a live object!");
+    auto &S = slot(H.mIdx);
+    S.get()->~T();
+    auto Last = mLive.back();
+    mLive[S.mLink] = Last;
+    slot(Last).mLink = S.mLink;
+    mLive.pop_back();
+    ++S.mGeneration;
+    S.mLink = mFree;
+    mFree = H.mIdx;
+  }
+
+  /// Returns true if a specified handle refers to a live object.
+  bool contains(handle H) const noexcept {
+    if (H.mIdx == NoSlot || H.mIdx >= mChunks.size() * ChunkSize)
+      return false;
+    auto &S = slot(H.mIdx);
+    return S.isAlive() && S.mGeneration == H.mGeneration;
+  }
+
+  /// Returns object a specified handle refers to or nullptr if it has been
+  /// erased.
+  T * get(handle H) noexcept {
+    return contains(H) ? slot(H.mIdx).get() : nullptr;
+  }
+
+  /// Returns object a specified handle refers to or nullptr if it has been
+  /// erased.
+  const T * get(handle H) const noexcept {
+    return contains(H) ? slot(H.mIdx).get() : nullptr;
+  }
+
+  /// Returns object a specified handle refers to, the object must be alive.
+  T & operator[](handle H) noexcept {
+    assert(contains(H) && "Handle must refer to a live object!");
+    return *slot(H.mIdx).get();
+  }
+
+  /// Returns object a specified handle refers to, the object must be alive.
+  const T & operator[](handle H) const noexcept {
+    assert(contains(H) && "Handle must refer to a live object!");
+    return *slot(H.mIdx).get();
+  }
+
+  /// Returns number of live objects.
+  size_type size() const noexcept { return mLive.size(); }
+
+  /// Returns true if there are no live objects in a pool.
+  bool empty() const noexcept { return mLive.empty(); }
+
+  /// Returns number of objects which can be stored without allocation.
+  size_type capacity() const noexcept { return mChunks.size() * ChunkSize; }
+
+  /// Destroys all objects. Allocated memory is not released and all
+  /// previously obtained handles become invalid.
+  void clear() noexcept {
+    for (auto Idx : mLive) {
+      auto &S = slot(Idx);
+      S.get()->~T();
+      ++S.mGeneration;
+      S.mLink = mFree;
+      mFree = Idx;
+    }
+    mLive.clear();
+  }
+
+  iterator begin() noexcept { return iterator(*this, 0); }
+  iterator end() noexcept { return iterator(*this, mLive.size()); }
+  const_iterator begin() const noexcept { return const_iterator(*this, 0); }
+  const_iterator end() const noexcept {
+    return const_iterator(*this, mLive.size());
+  }
+
+private:
+  Slot & slot(IndexT Idx) noexcept {
+    return mChunks[Idx / ChunkSize][Idx % ChunkSize];
+  }
+  const Slot & slot(IndexT Idx) const noexcept {
+    return mChunks[Idx / ChunkSize][Idx % ChunkSize];
+  }
+
+  handle makeHandle(IndexT Idx) const noexcept {
+    return handle(Idx, slot(Idx).mGeneration);
+  }
+
+  /// Allocates a new chunk and links its slots into the free list.
+  void grow() {
+    assert(capacity() + ChunkSize <= NoSlot && "Too many objects in a pool!");
+    std::unique_ptr<Slot[]> Chunk(new Slot[ChunkSize]);
+    auto First = static_cast<IndexT>(capacity());
+    for (IndexT I = 0; I < ChunkSize - 1; ++I)
+      Chunk[I].mLink = First + I + 1;
+    Chunk[ChunkSize - 1].mLink = mFree;
+    mChunks.push_back(std::move(Chunk));
+    mFree = First;
+  }
+
+  void destroyAll() noexcept {
+    for (auto Idx : mLive)
+      slot(Idx).get()->~T();
+  }
+
+  std::vector<std::unique_ptr<Slot[]>> mChunks;
+  std::vector<IndexT> mLive;
+  IndexT mFree = NoSlot;
+};
+}
+#endif//BCL_STABLE_POOL_H
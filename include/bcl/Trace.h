@@ -0,0 +1,324 @@
+//===------- Trace.h ------- Built-in Tracepoints ---------------*- C++ -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements low-overhead tracepoints. Use BCL_TRACE_SCOPE(Name)
+// to record the beginning and the end of a scope:
+// \code
+//   void solve() {
+//     BCL_TRACE_SCOPE("solve");
+//     ...
+//   }
+//   ...
+//   std::ofstream OS("trace.json");
+//   bcl::trace::dump(OS);
+// \endcode
+// The resulting file uses the Chrome trace event format, so it can be loaded
+// in chrome://tracing or Perfetto.
+//
+// Tracepoints are enabled if BCL_TRACE is defined (see the BCL_TRACE option
+// in CMake), otherwise BCL_TRACE_SCOPE expands to nothing. Each thread writes
+// records to its own ring buffer of BCL_TRACE_BUFFER_SIZE records, so no locks
+// are acquired when a record is written. If a buffer overflows the oldest
+// records are overwritten. When a thread exits its records are moved to
+// a shared ring of the same size and its buffer is reused by the next thread,
+// so the number of buffers does not exceed the number of running threads.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef BCL_TRACE_H
+#define BCL_TRACE_H
+
+#include <bcl/bcl-config.h>
+
+#ifdef BCL_TRACE
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#ifndef BCL_TRACE_BUFFER_SIZE
+# define BCL_TRACE_BUFFER_SIZE 65536
+#endif
+
+namespace bcl {
+namespace trace {
+/// Kind of a trace record.
+enum class Phase : std::uint8_t { Begin, End };
+
+/// Single record in a trace.
+struct Record {
+  /// Time in nanoseconds.
+  std::uint64_t Time;
+
+  /// Identifier of a name of a traced scope (see registerName()).
+  std::uint32_t Id;
+
+  Phase Kind;
+};
+
+/// Ring buffer of records which are written by a single thread.
+class Buffer {
+  static_assert(BCL_TRACE_BUFFER_SIZE > 0 &&
+    (BCL_TRACE_BUFFER_SIZE & (BCL_TRACE_BUFFER_SIZE - 1)) == 0,
+    "Size of a trace buffer must be a power of two!");
+public:
+  static constexpr std::size_t Capacity = BCL_TRACE_BUFFER_SIZE;
+
+  explicit Buffer(std::uint32_t ThreadId) :
+    mRecords(new Record[Capacity]), mThreadId(ThreadId) {}
+
+  /// Removes all records and assigns the buffer to a new thread.
+  ///
+  /// This must not be called concurrently with push().
+  void reset(std::uint32_t ThreadId) noexcept {
+    mHead.store(0, std::memory_order_relaxed);
+    mTail.store(0, std::memory_order_release);
+    mThreadId = ThreadId;
+  }
+
+  /// Writes a new record, the oldest record is overwritten if the buffer
+  /// is full.
+  void push(std::uint32_t Id, Phase Kind) noexcept {
+    auto Head = mHead.load(std::memory_order_relaxed);
+    auto Time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+    mRecords[Head & (Capacity - 1)] =
+      Record{ static_cast<std::uint64_t>(Time), Id, Kind };
+    mHead.store(Head + 1, std::memory_order_release);
+  }
+
+  /// Applies a specified function to each available record starting from
+  /// the oldest one.
+  template<class Function> void for_each(Function &&F) const {
+    auto Head = mHead.load(std::memory_order_acquire);
+    auto Tail = mTail.load(std::memory_order_acquire);
+    if (Head > Capacity && Tail < Head - Capacity)
+      Tail = Head - Capacity;
+    for (auto I = Tail; I < Head; ++I)
+      F(mRecords[I & (Capacity - 1)]);
+  }
+
+  /// \brief Removes all records.
+  ///
+  /// Only the owner of the buffer changes its head, so this can be called
+  /// while the owner writes records.
+  void clear() noexcept {
+    mTail.store(mHead.load(std::memory_order_acquire),
+      std::memory_order_release);
+  }
+
+  /// Returns identifier of a thread which owns this buffer.
+  std::uint32_t getThreadId() const noexcept { return mThreadId; }
+
+private:
+  std::unique_ptr<Record[]> mRecords;
+  std::atomic<std::uint64_t> mHead{0};
+  std::atomic<std::uint64_t> mTail{0};
+  std::uint32_t mThreadId;
+};
+
+namespace detail {
+/// Record which has been written by a thread that has already exited.
+struct RetiredRecord {
+  Record Rec;
+  std::uint32_t ThreadId;
+};
+
+/// Storage of all buffers and names of traced scopes.
+struct Registry {
+  std::mutex Mutex;
+  std::vector<std::unique_ptr<Buffer>> Buffers;
+  std::vector<Buffer *> FreeBuffers;
+  std::deque<RetiredRecord> Retired;
+  std::vector<const char *> Names;
+  std::uint32_t NextThreadId = 0;
+
+  static Registry & get() {
+    static Registry R;
+    return R;
+  }
+};
+
+/// Owns a buffer of the current thread and returns it to the registry when
+/// the thread exits.
+class BufferOwner {
+public:
+  BufferOwner() : mRegistry(Registry::get()) {
+    std::lock_guard<std::mutex> Lock(mRegistry.Mutex);
+    auto ThreadId = mRegistry.NextThreadId++;
+    if (mRegistry.FreeBuffers.empty()) {
+      mRegistry.Buffers.emplace_back(new Buffer(ThreadId));
+      mBuffer = mRegistry.Buffers.back().get();
+    } else {
+      mBuffer = mRegistry.FreeBuffers.back();
+      mRegistry.FreeBuffers.pop_back();
+      mBuffer->reset(ThreadId);
+    }
+  }
+
+  ~BufferOwner() {
+    std::lock_guard<std::mutex> Lock(mRegistry.Mutex);
+    auto ThreadId = mBuffer->getThreadId();
+    mBuffer->for_each([this, ThreadId](const Record &Rec) {
+      if (mRegistry.Retired.size() == Buffer::Capacity)
+        mRegistry.Retired.pop_front();
+      mRegistry.Retired.push_back(RetiredRecord{ Rec, ThreadId });
+    });
+    mBuffer->clear();
+    mRegistry.FreeBuffers.push_back(mBuffer);
+  }
+
+  BufferOwner(const BufferOwner &) = delete;
+  BufferOwner & operator=(const BufferOwner &) = delete;
+
+  Buffer & get() noexcept { return *mBuffer; }
+
+private:
+  Registry &mRegistry;
+  Buffer *mBuffer;
+};
+
+inline Buffer & buffer() {
+  static thread_local BufferOwner Owner;
+  return Owner.get();
+}
+
+/// Writes a specified string as a JSON string.
+inline void escape(std::ostream &OS, const char *Str) {
+  OS << '"';
+  for (; *Str; ++Str) {
+    if (*Str == '"' || *Str == '\\')
+      OS << '\\';
+    OS << *Str;
+  }
+  OS << '"';
+}
+
+/// Writes a specified record in the Chrome trace event format.
+inline void print(std::ostream &OS, const char *Name, const Record &Rec,
+    std::uint32_t ThreadId) {
+  OS << "\n{\"name\":";
+  escape(OS, Name);
+  OS << ",\"ph\":\"" << (Rec.Kind == Phase::Begin ? 'B' : 'E')
+     << "\",\"ts\":" << Rec.Time / 1000 << "." << Rec.Time % 1000 / 100
+     << Rec.Time % 100 / 10 << Rec.Time % 10
+     << ",\"pid\":0,\"tid\":" << ThreadId << "}";
+}
+}
+
+/// \brief Registers name of a traced scope and returns its identifier.
+///
+/// The name is not copied, so it must live until the trace is dumped.
+inline std::uint32_t registerName(const char *Name) {
+  auto &R = detail::Registry::get();
+  std::lock_guard<std::mutex> Lock(R.Mutex);
+  R.Names.push_back(Name);
+  return static_cast<std::uint32_t>(R.Names.size() - 1);
+}
+
+/// Records the beginning and the end of a scope.
+class Scope {
+public:
+  explicit Scope(std::uint32_t Id) : mId(Id) {
+    detail::buffer().push(mId, Phase::Begin);
+  }
+  ~Scope() { detail::buffer().push(mId, Phase::End); }
+
+  Scope(const Scope &) = delete;
+  Scope & operator=(const Scope &) = delete;
+
+private:
+  std::uint32_t mId;
+};
+
+/// \brief Writes all collected records in the Chrome trace event format.
+///
+/// Records which are written concurrently with this function may be lost,
+/// so traced threads should be quiescent. Records of threads which have
+/// already exited are written first.
+inline void dump(std::ostream &OS) {
+  auto &R = detail::Registry::get();
+  std::lock_guard<std::mutex> Lock(R.Mutex);
+  OS << "{\"traceEvents\":[";
+  bool IsFirst = true;
+  for (auto &RR : R.Retired) {
+    if (!IsFirst)
+      OS << ",";
+    IsFirst = false;
+    detail::print(OS, R.Names[RR.Rec.Id], RR.Rec, RR.ThreadId);
+  }
+  for (auto &B : R.Buffers)
+    B->for_each([&OS, &R, &B, &IsFirst](const Record &Rec) {
+      if (!IsFirst)
+        OS << ",";
+      IsFirst = false;
+      detail::print(OS, R.Names[Rec.Id], Rec, B->getThreadId());
+    });
+  OS << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+/// \brief Removes all collected records.
+///
+/// This can be called while other threads write records.
+inline void clear() {
+  auto &R = detail::Registry::get();
+  std::lock_guard<std::mutex> Lock(R.Mutex);
+  R.Retired.clear();
+  for (auto &B : R.Buffers)
+    B->clear();
+}
+
+/// Returns number of buffers which have been allocated for traced threads.
+inline std::size_t getNumBuffers() {
+  auto &R = detail::Registry::get();
+  std::lock_guard<std::mutex> Lock(R.Mutex);
+  return R.Buffers.size();
+}
+}
+}
+
+#define BCL_TRACE_CONCAT_IMPL(X, Y) X##Y
+#define BCL_TRACE_CONCAT(X, Y) BCL_TRACE_CONCAT_IMPL(X, Y)
+
+#define BCL_TRACE_SCOPE_IMPL(Name, Suffix) \
+  static const std::uint32_t BCL_TRACE_CONCAT(BCLTraceId, Suffix) = \
+    bcl::trace::registerName(Name); \
+  bcl::trace::Scope BCL_TRACE_CONCAT(BCLTraceScope, Suffix)( \
+    BCL_TRACE_CONCAT(BCLTraceId, Suffix))
+
+/// \brief Records the beginning and the end of the current scope.
+///
+/// Names of local variables are made unique with __COUNTER__, so several
+/// scopes may be declared on the same line (for example, by another macro).
+/// If __COUNTER__ is not available, __LINE__ is used and only one scope may
+/// be declared on a line.
+#ifdef __COUNTER__
+#define BCL_TRACE_SCOPE(Name) BCL_TRACE_SCOPE_IMPL(Name, __COUNTER__)
+#else
+#define BCL_TRACE_SCOPE(Name) BCL_TRACE_SCOPE_IMPL(Name, __LINE__)
+#endif
+#else
+#define BCL_TRACE_SCOPE(Name) ((void)0)
+#endif//BCL_TRACE
+#endif//BCL_TRACE_H
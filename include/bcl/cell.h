@@ -37,6 +37,8 @@
 
 #include "utility.h"
 #include <cassert>
+#include <cstring>
+#include <functional>
 #include <type_traits>
 
 namespace bcl {
@@ -189,24 +191,22 @@ public:
 protected:
   /// \brief Returns a value from the specified cell.
   ///
-  /// Cells treated consistently from the beginning of the collection until the
-  /// desired cell is found.
+  /// The desired cell is a base of this map, so it is found by deduction of
+  /// template arguments of the cellOf() method. This does not instantiate
+  /// intermediate methods for each cell before the desired one.
   /// \tparam What Key of the accessed cell.
   template<class What> const typename What::ValueType & accessValue() const {
-    return accessValue<What>(std::is_same<What, CellKey>());
+    return cellOf<What>(*this).mValue;
   }
 
 private:
-  /// \brief Returns a value from the specified cell.
-  template<class What>
-  const typename What::ValueType & accessValue(std::true_type) const {
-    return mValue;
-  }
+  template<class... Keys> friend class StaticMap;
 
-  /// This is invoked to visit the next cell in the map.
-  template<class What>
-  const typename What::ValueType & accessValue(std::false_type) const {
-    return CellNext::template accessValue<What>();
+  /// Returns a cell with a specified key.
+  template<class What, class... Next>
+  static const StaticMap<What, Next...> & cellOf(
+      const StaticMap<What, Next...> &C) noexcept {
+    return C;
   }
 
   /// This is invoked to visit the next cell in the map.
@@ -502,6 +502,79 @@ private:
   MapType mMap;
 };
 
+/// An empty static map is trivially relocatable.
+template<> struct is_trivially_relocatable<StaticMap<>> :
+  public std::true_type {};
+
+/// A static map is trivially relocatable if values in all cells are trivially
+/// relocatable.
+template<class Head, class... Tail>
+struct is_trivially_relocatable<StaticMap<Head, Tail...>> :
+  public std::integral_constant<bool,
+    is_trivially_relocatable<typename Head::ValueType>::value &&
+    is_trivially_relocatable<StaticMap<Tail...>>::value> {};
+
+/// A static type map is trivially relocatable if values of all types are
+/// trivially relocatable.
+template<class... Types>
+struct is_trivially_relocatable<StaticTypeMap<Types...>> :
+  public is_trivially_relocatable<
+    typename StaticMapConstructor<StaticMapKeyConstructor, Types...>::Type> {};
+
+/// A static map is bitwise comparable if values in all cells are bitwise
+/// comparable and there is no padding between them.
+template<class... Keys>
+struct is_bitwise_comparable<StaticMap<Keys...>> :
+  public std::integral_constant<bool,
+    (is_bitwise_comparable<typename Keys::ValueType>::value && ...) &&
+    sizeof(StaticMap<Keys...>) ==
+      (sizeof(typename Keys::ValueType) + ... + 0)> {};
+
+/// A static type map is bitwise comparable if the underlying static map is
+/// bitwise comparable.
+template<class... Types>
+struct is_bitwise_comparable<StaticTypeMap<Types...>> :
+  public std::integral_constant<bool,
+    is_bitwise_comparable<typename StaticMapConstructor<
+      StaticMapKeyConstructor, Types...>::Type>::value &&
+    sizeof(StaticTypeMap<Types...>) == sizeof(typename StaticMapConstructor<
+      StaticMapKeyConstructor, Types...>::Type)> {};
+
+/// \brief Compares values in all cells of static maps.
+///
+/// Bitwise comparable maps are compared with a single memcmp().
+template<class... Keys> inline bool operator==(
+    const StaticMap<Keys...> &LHS, const StaticMap<Keys...> &RHS) {
+  if constexpr (is_bitwise_comparable<StaticMap<Keys...>>::value)
+    return std::memcmp(&LHS, &RHS, sizeof(StaticMap<Keys...>)) == 0;
+  else
+    return ((LHS.template value<Keys>() == RHS.template value<Keys>()) && ...);
+}
+
+/// Compares values in all cells of static maps.
+template<class... Keys> inline bool operator!=(
+    const StaticMap<Keys...> &LHS, const StaticMap<Keys...> &RHS) {
+  return !(LHS == RHS);
+}
+
+/// \brief Compares values of all types in static type maps.
+///
+/// Bitwise comparable maps are compared with a single memcmp().
+template<class... Types> inline bool operator==(
+    const StaticTypeMap<Types...> &LHS, const StaticTypeMap<Types...> &RHS) {
+  if constexpr (is_bitwise_comparable<StaticTypeMap<Types...>>::value)
+    return std::memcmp(&LHS, &RHS, sizeof(StaticTypeMap<Types...>)) == 0;
+  else
+    return ((LHS.template value<Types>() == RHS.template value<Types>()) &&
+      ...);
+}
+
+/// Compares values of all types in static type maps.
+template<class... Types> inline bool operator!=(
+    const StaticTypeMap<Types...> &LHS, const StaticTypeMap<Types...> &RHS) {
+  return !(LHS == RHS);
+}
+
 /// \brief Determines whether the cell exists in the collection.
 ///
 /// If there is no cell with the specified key in the collection this
@@ -773,6 +846,43 @@ private:
 };
 }
 
+namespace std {
+/// \brief Computes a hash value of a static map.
+///
+/// Bitwise comparable maps are hashed as a contiguous range of bytes,
+/// otherwise hash values of all cells are combined.
+template<class... Keys> struct hash<bcl::StaticMap<Keys...>> {
+  std::size_t operator()(const bcl::StaticMap<Keys...> &M) const {
+    if constexpr (bcl::is_bitwise_comparable<bcl::StaticMap<Keys...>>::value) {
+      return bcl::hash_bytes(&M, sizeof(M));
+    } else {
+      std::size_t Seed = 0;
+      ((Seed = bcl::hash_combine(Seed, hash<typename Keys::ValueType>()(
+        M.template value<Keys>()))), ...);
+      return Seed;
+    }
+  }
+};
+
+/// \brief Computes a hash value of a static type map.
+///
+/// Bitwise comparable maps are hashed as a contiguous range of bytes,
+/// otherwise hash values of all types are combined.
+template<class... Types> struct hash<bcl::StaticTypeMap<Types...>> {
+  std::size_t operator()(const bcl::StaticTypeMap<Types...> &M) const {
+    if constexpr (
+        bcl::is_bitwise_comparable<bcl::StaticTypeMap<Types...>>::value) {
+      return bcl::hash_bytes(&M, sizeof(M));
+    } else {
+      std::size_t Seed = 0;
+      ((Seed = bcl::hash_combine(Seed,
+        hash<Types>()(M.template value<Types>()))), ...);
+      return Seed;
+    }
+  }
+};
+}
+
 /// \page static_map_example Example of bcl::StaticMap usage. Workers and salary
 /// Let us create a record for a table reflecting the salary of workers:
 /// Name | Salary
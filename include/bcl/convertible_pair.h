@@ -26,6 +26,7 @@
 #ifndef BCL_CONVERTIBLE_PAIR_H
 #define BCL_CONVERTIBLE_PAIR_H
 
+#include "utility.h"
 #include <utility>
 
 namespace bcl {
@@ -61,5 +62,13 @@ struct convertible_pair : public std::pair<FirstTy, SecondTy> {
   operator const FirstTy & () const noexcept { return PairTy::first; }
   operator const SecondTy & () const noexcept { return PairTy::second; }
 };
+
+/// A convertible pair is trivially relocatable if both values are trivially
+/// relocatable.
+template<class FirstTy, class SecondTy>
+struct is_trivially_relocatable<convertible_pair<FirstTy, SecondTy>> :
+  public std::integral_constant<bool,
+    is_trivially_relocatable<FirstTy>::value &&
+    is_trivially_relocatable<SecondTy>::value> {};
 }
 #endif//BCL_CONVERTIBLE_PAIR_H
@@ -0,0 +1,144 @@
+//===---- adapter.h ----- Adapters For Legacy Values ------------*- C++ -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains adapters which simplify migration from legacy
+// Utility::Value<Type_, Nullable_> to bcl::Nullable<T>.
+//
+// There are two ways to migrate code:
+// - bcl::legacy::Value<Type_, Nullable_> has the same interface as
+//   Utility::Value<Type_, Nullable_> (construction from and comparison with
+//   undef, implicit conversion to Type_), so it is enough to replace
+//   the name of a type. Weak values are derived from bcl::Nullable<Type_>
+//   and strong values are plain Type_.
+// - toNullable() and toLegacy() convert values on the boundary between
+//   legacy and migrated code.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef BCL_ADAPTER_H
+#define BCL_ADAPTER_H
+
+#include "declaration.h"
+#include "value.h"
+#include "../Nullable.h"
+
+namespace bcl {
+template<class T>
+constexpr bool operator==(const Nullable<T> &LHS, Utility::Null) noexcept {
+  return !LHS;
+}
+
+template<class T>
+constexpr bool operator==(Utility::Null, const Nullable<T> &RHS) noexcept {
+  return !RHS;
+}
+
+template<class T>
+constexpr bool operator!=(const Nullable<T> &LHS, Utility::Null) noexcept {
+  return static_cast<bool>(LHS);
+}
+
+template<class T>
+constexpr bool operator!=(Utility::Null, const Nullable<T> &RHS) noexcept {
+  return static_cast<bool>(RHS);
+}
+
+/// Converts legacy value which may be undefined.
+template<class T>
+Nullable<T> toNullable(const Utility::Value<T, Utility::True> &V) {
+  return V == undef ? Nullable<T>() : Nullable<T>(static_cast<const T &>(V));
+}
+
+/// Converts legacy pointer, null pointer is an undefined value.
+///
+/// Note, that Utility::Value<T *, Utility::True>::operator==(Null) returns
+/// true for non-null pointers, so it is not used here.
+template<class T>
+Nullable<T *> toNullable(const Utility::Value<T *, Utility::True> &V) {
+  return Nullable<T *>(static_cast<T * const &>(V));
+}
+
+/// Converts legacy value which is always defined.
+template<class T>
+Nullable<T> toNullable(const Utility::Value<T, Utility::False> &V) {
+  return Nullable<T>(static_cast<const T &>(V));
+}
+
+/// Converts a value to legacy value which may be undefined.
+template<class T>
+Utility::Value<T, Utility::True> toLegacy(const Nullable<T> &V) {
+  if (!V)
+    return Utility::Value<T, Utility::True>(undef);
+  return Utility::Value<T, Utility::True>(*V);
+}
+
+namespace legacy {
+/// \brief Drop-in replacement for Utility::Value<Type_, Utility::True>.
+///
+/// This class does not add any data to bcl::Nullable<Type_>, so it has
+/// the same layout.
+template<class Type_> class WeakValue : public bcl::Nullable<Type_> {
+  using BaseT = bcl::Nullable<Type_>;
+public:
+  using Type = Type_;
+  using Nullable = Utility::True;
+
+  using BaseT::BaseT;
+  using BaseT::operator=;
+
+  constexpr WeakValue() noexcept = default;
+
+  /// Creates undefined value.
+  WeakValue(Utility::Null) noexcept {}
+
+  /// Makes this value undefined.
+  WeakValue & operator=(Utility::Null) noexcept {
+    this->reset();
+    return *this;
+  }
+
+  /// Returns stored value, the value must be defined.
+  operator Type & () noexcept { return **this; }
+
+  /// Returns stored value, the value must be defined.
+  operator const Type & () const noexcept { return **this; }
+};
+
+namespace detail {
+template<class Type_, class Nullable_> struct ValueImpl;
+template<class Type_> struct ValueImpl<Type_, Utility::True> {
+  using type = WeakValue<Type_>;
+};
+template<class Type_> struct ValueImpl<Type_, Utility::False> {
+  using type = Type_;
+};
+}
+
+/// Drop-in replacement for Utility::Value<Type_, Nullable_>.
+template<class Type_, class Nullable_>
+using Value = typename detail::ValueImpl<Type_, Nullable_>::type;
+}
+}
+
+namespace std {
+template<class T> struct hash<bcl::legacy::WeakValue<T>> :
+  public hash<bcl::Nullable<T>> {};
+}
+#endif//BCL_ADAPTER_H
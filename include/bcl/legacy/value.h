@@ -29,8 +29,8 @@
 
 namespace Utility
 {
-    using DataBase::Text;
-    using DataBase::Char;
+    using Base::Text;
+    using Base::Char;
 
     //! Класс-обертка для значений заданного типа.
     /*! \tparam Type_ Тип значения.
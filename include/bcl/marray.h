@@ -32,6 +32,10 @@
 
 #include <bcl/utility.h>
 #include <array>
+#include <cassert>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
 
 namespace bcl {
 template<typename Ty, std::size_t Size, typename marray>
@@ -66,10 +70,17 @@ private:
 ///
 /// \tparam Ty Type of each element.
 /// \tparam Size Number of dimensions.
-template<typename Ty, std::size_t Size>
+/// \tparam Allocator Allocator which is used to acquire memory for elements.
+/// Elements are constructed with uses-allocator construction, so elements of
+/// bcl::pmr::marray share a memory resource with the array.
+template<typename Ty, std::size_t Size,
+  typename Allocator = std::allocator<Ty>>
 class marray {
   template<typename T, std::size_t S, typename MA>
   friend class msubarray;
+
+  typedef std::allocator_traits<Allocator> AllocatorTraits;
+
   /// Allocate memory according to sizes stored in mDims.
   void allocate() {
     auto FullSize = mDims[Size - 1];
@@ -79,41 +90,83 @@ class marray {
       mOffset[I-1] = mOffset[I] * mDims[I];
     }
     FullSize *= mDims[0];
-    mData = new Ty [FullSize];
+    mData = AllocatorTraits::allocate(mAlloc, FullSize);
+    mSize = FullSize;
+    // Trivial elements are left uninitialized as with new Ty[].
+    if constexpr (!std::is_trivially_default_constructible<Ty>::value) {
+      std::size_t I = 0;
+      try {
+        for (; I < mSize; ++I)
+          AllocatorTraits::construct(mAlloc, mData + I);
+      } catch (...) {
+        mSize = I;
+        release();
+        throw;
+      }
+    }
   }
+
+  /// Destroy elements and release memory.
+  void release() noexcept {
+    if (!mData)
+      return;
+    if constexpr (!std::is_trivially_destructible<Ty>::value)
+      for (std::size_t I = 0; I < mSize; ++I)
+        AllocatorTraits::destroy(mAlloc, mData + I);
+    AllocatorTraits::deallocate(mAlloc, mData, mSize);
+    mData = nullptr;
+    mSize = 0;
+  }
+
 public:
+  typedef Allocator allocator_type;
+
  /// Create an array with specified sizes of dimensions.
-  explicit inline marray(const std::array<std::size_t, Size> &Dims)
-      BCL_ALWAYS_INLINE : mDims(Dims) {
+  explicit inline marray(const std::array<std::size_t, Size> &Dims,
+      const Allocator &Alloc = Allocator())
+      BCL_ALWAYS_INLINE : mAlloc(Alloc), mDims(Dims) {
     allocate();
   }
 
   /// Create an array with specified sizes of dimensions.
-  explicit inline marray(std::array<std::size_t, Size> &&Dims)
-      BCL_ALWAYS_INLINE : mDims(std::move(Dims)) {
+  explicit inline marray(std::array<std::size_t, Size> &&Dims,
+      const Allocator &Alloc = Allocator())
+      BCL_ALWAYS_INLINE : mAlloc(Alloc), mDims(std::move(Dims)) {
    allocate();
   }
 
   marray(const marray &) = delete;
   marray & operator=(const marray &) = delete;
 
-  inline marray(marray &&From) BCL_ALWAYS_INLINE :
+  inline marray(marray &&From) noexcept BCL_ALWAYS_INLINE :
+      mData(From.mData), mSize(From.mSize),
+      mAlloc(std::move(From.mAlloc)),
       mDims(std::move(From.mDims)),
-      mOffset(std::move(From.mOffset)),
-      mData(From.mData) {
+      mOffset(std::move(From.mOffset)) {
     From.mData = nullptr;
+    From.mSize = 0;
   }
 
-  inline marray & operator=(marray &&From) BCL_ALWAYS_INLINE {
+  /// Move assignment, allocators must compare equal.
+  inline marray & operator=(marray &&From) noexcept BCL_ALWAYS_INLINE {
+    if (this == &From)
+      return *this;
+    assert(mAlloc == From.mAlloc &&
+      "Memory can not be moved between different allocators!");
+    release();
     mDims = std::move(From.mDims);
     mOffset = std::move(From.mOffset);
     mData = From.mData;
+    mSize = From.mSize;
     From.mData = nullptr;
+    From.mSize = 0;
+    return *this;
   }
 
-  inline ~marray() BCL_ALWAYS_INLINE {
-    delete [] mData;
-  }
+  inline ~marray() BCL_ALWAYS_INLINE { release(); }
+
+  /// Return allocator associated with the array.
+  allocator_type get_allocator() const noexcept { return mAlloc; }
 
   /// Return a subarray with Size - 1 number of dimensions.
   msubarray <Ty, Size - 1, marray> operator[](std::size_t I) {
@@ -121,9 +174,17 @@ public:
   }
 
 private:
-  Ty *mData;
+  Ty *mData = nullptr;
+  std::size_t mSize = 0;
+  Allocator mAlloc;
   std::array<std::size_t, Size> mDims;
   std::array<std::size_t, Size - 1> mOffset;
 };
+
+namespace pmr {
+/// Multidimensional array which uses a polymorphic allocator.
+template<typename Ty, std::size_t Size>
+using marray = bcl::marray<Ty, Size, std::pmr::polymorphic_allocator<Ty>>;
+}
 }
 #endif//BCL_MARRAY_H
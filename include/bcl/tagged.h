@@ -48,6 +48,8 @@
 
 #include "cell.h"
 #include "utility.h"
+#include <cstring>
+#include <functional>
 #include <tuple>
 #include <utility>
 
@@ -114,6 +116,15 @@ struct add_alias_list<tagged<Args...>, TypeList<NewAliasTy...>> {
 template<class TagTy, class Tagged> struct is_alias :
   public IsTypeExist<TagTy, typename Tagged::alias> {};
 
+namespace detail {
+/// Returns index of the first tagged structure associated with a specified
+/// tag or number of structures if there is no such structure.
+template<class TagTy, class... Taggeds>
+constexpr std::size_t index_of_tagged() {
+  return bcl::detail::findFirst<is_alias<TagTy, Taggeds>::value...>();
+}
+}
+
 /// \brief Finds bcl::tagged (in Taggeds) structure which is associated with the
 /// specified tag TagTy.
 ///
@@ -121,17 +132,13 @@ template<class TagTy, class Tagged> struct is_alias :
 /// is alias `void`. There is also a  specialization of this template to search
 /// tags in a bcl::TapeList<Taggeds...>. It is possible to use
 /// bcl::get_tagged<...> type alias to access result of search.
-template<class TagTy, class... Taggeds> struct get;
-
-template<class TagTy> struct get<TagTy> {
-  typedef void type;
-};
-
-/// Finds bcl::tagged structure which is associated with the specified tag.
-template<class TagTy, class Tagged, class... Taggeds>
-struct get<TagTy, Tagged, Taggeds...> {
-  typedef typename std::conditional<is_alias<TagTy, Tagged>::value,
-    Tagged, typename get<TagTy, Taggeds...>::type>::type type;
+///
+/// All tagged structures are checked at once and the result is selected by
+/// its index, so the depth of instantiation does not depend on the number
+/// of tagged structures.
+template<class TagTy, class... Taggeds> struct get {
+  typedef typename bcl::detail::TypePackElement<
+    detail::index_of_tagged<TagTy, Taggeds...>(), Taggeds..., void>::type type;
 };
 
 /// Finds bcl::tagged structure which is associated with the specified tag.
@@ -333,6 +340,82 @@ struct tagged_tuple: public std::tuple<typename Taggeds::type...> {
   }
 };
 
+/// A tagged pair is trivially relocatable if both values are trivially
+/// relocatable.
+template<class Tagged1, class Tagged2>
+struct is_trivially_relocatable<tagged_pair<Tagged1, Tagged2>> :
+  public std::integral_constant<bool,
+    is_trivially_relocatable<typename Tagged1::type>::value &&
+    is_trivially_relocatable<typename Tagged2::type>::value> {};
+
+/// An empty tagged tuple is trivially relocatable.
+template<> struct is_trivially_relocatable<tagged_tuple<>> :
+  public std::true_type {};
+
+/// A tagged tuple is trivially relocatable if all values are trivially
+/// relocatable.
+template<class First, class... Taggeds>
+struct is_trivially_relocatable<tagged_tuple<First, Taggeds...>> :
+  public std::integral_constant<bool,
+    is_trivially_relocatable<typename First::type>::value &&
+    is_trivially_relocatable<tagged_tuple<Taggeds...>>::value> {};
+
+/// A tagged pair is bitwise comparable if both values are bitwise comparable
+/// and there is no padding between them.
+template<class Tagged1, class Tagged2>
+struct is_bitwise_comparable<tagged_pair<Tagged1, Tagged2>> :
+  public std::integral_constant<bool,
+    is_bitwise_comparable<typename Tagged1::type>::value &&
+    is_bitwise_comparable<typename Tagged2::type>::value &&
+    sizeof(tagged_pair<Tagged1, Tagged2>) ==
+      sizeof(typename Tagged1::type) + sizeof(typename Tagged2::type)> {};
+
+/// A tagged tuple is bitwise comparable if all values are bitwise comparable
+/// and there is no padding between them.
+template<class... Taggeds>
+struct is_bitwise_comparable<tagged_tuple<Taggeds...>> :
+  public std::integral_constant<bool,
+    (is_bitwise_comparable<typename Taggeds::type>::value && ...) &&
+    sizeof(tagged_tuple<Taggeds...>) ==
+      (sizeof(typename Taggeds::type) + ... + 0)> {};
+
+/// \brief Compares values in tagged pairs.
+///
+/// Bitwise comparable pairs are compared with a single memcmp().
+template<class Tagged1, class Tagged2> inline bool operator==(
+    const tagged_pair<Tagged1, Tagged2> &LHS,
+    const tagged_pair<Tagged1, Tagged2> &RHS) {
+  if constexpr (is_bitwise_comparable<tagged_pair<Tagged1, Tagged2>>::value)
+    return std::memcmp(&LHS, &RHS, sizeof(LHS)) == 0;
+  else
+    return LHS.first == RHS.first && LHS.second == RHS.second;
+}
+
+/// Compares values in tagged pairs.
+template<class Tagged1, class Tagged2> inline bool operator!=(
+    const tagged_pair<Tagged1, Tagged2> &LHS,
+    const tagged_pair<Tagged1, Tagged2> &RHS) {
+  return !(LHS == RHS);
+}
+
+/// \brief Compares values in tagged tuples.
+///
+/// Bitwise comparable tuples are compared with a single memcmp().
+template<class... Taggeds> inline bool operator==(
+    const tagged_tuple<Taggeds...> &LHS, const tagged_tuple<Taggeds...> &RHS) {
+  if constexpr (is_bitwise_comparable<tagged_tuple<Taggeds...>>::value)
+    return std::memcmp(&LHS, &RHS, sizeof(LHS)) == 0;
+  else
+    return static_cast<const typename tagged_tuple<Taggeds...>::tuple &>(LHS) ==
+      static_cast<const typename tagged_tuple<Taggeds...>::tuple &>(RHS);
+}
+
+/// Compares values in tagged tuples.
+template<class... Taggeds> inline bool operator!=(
+    const tagged_tuple<Taggeds...> &LHS, const tagged_tuple<Taggeds...> &RHS) {
+  return !(LHS == RHS);
+}
+
 /// Provide access to the number of elements in a tuple.
 template<class T> class tagged_tuple_size;
 
@@ -367,14 +450,10 @@ class tagged_tuple_idx<Tag, tagged_tuple<Taggeds...>> :
 template<std::size_t Idx, class T> struct tagged_tuple_tag;
 
 /// Provide compile time access to a tag with a specified index.
-template<std::size_t Idx, class First, class... Taggeds>
-struct tagged_tuple_tag<Idx, tagged_tuple<First, Taggeds...>> :
-  public tagged_tuple_tag<Idx - 1, tagged_tuple<Taggeds...>> {};
-
-/// Provide compile time access to a tag with a specified index.
-template<class First, class... Taggeds>
-struct tagged_tuple_tag<0, tagged_tuple<First, Taggeds...>> {
-  using type = typename First::tag;
+template<std::size_t Idx, class... Taggeds>
+struct tagged_tuple_tag<Idx, tagged_tuple<Taggeds...>> {
+  using type =
+    typename bcl::detail::TypePackElement<Idx, Taggeds...>::type::tag;
 };
 
 namespace tags {
@@ -469,4 +548,47 @@ template<class Ty, class... Tags>
 using get_tagged_tuple_t = typename get_tagged_tuple<Ty, Tags...>::type;
 }
 }
+
+namespace std {
+/// \brief Computes a hash value of a tagged pair.
+///
+/// Bitwise comparable pairs are hashed as a contiguous range of bytes,
+/// otherwise hash values of both values are combined.
+template<class Tagged1, class Tagged2>
+struct hash<bcl::tagged_pair<Tagged1, Tagged2>> {
+  std::size_t operator()(const bcl::tagged_pair<Tagged1, Tagged2> &P) const {
+    if constexpr (
+        bcl::is_bitwise_comparable<bcl::tagged_pair<Tagged1, Tagged2>>::value)
+      return bcl::hash_bytes(&P, sizeof(P));
+    else
+      return bcl::hash_combine(
+        hash<typename Tagged1::type>()(P.first),
+        hash<typename Tagged2::type>()(P.second));
+  }
+};
+
+/// \brief Computes a hash value of a tagged tuple.
+///
+/// Bitwise comparable tuples are hashed as a contiguous range of bytes,
+/// otherwise hash values of all values are combined.
+template<class... Taggeds> struct hash<bcl::tagged_tuple<Taggeds...>> {
+  std::size_t operator()(const bcl::tagged_tuple<Taggeds...> &T) const {
+    if constexpr (
+        bcl::is_bitwise_comparable<bcl::tagged_tuple<Taggeds...>>::value)
+      return bcl::hash_bytes(&T, sizeof(T));
+    else
+      return combine(T, std::index_sequence_for<Taggeds...>());
+  }
+
+private:
+  template<std::size_t... Indexes>
+  static std::size_t combine(const bcl::tagged_tuple<Taggeds...> &T,
+      std::index_sequence<Indexes...>) {
+    std::size_t Seed = 0;
+    ((Seed = bcl::hash_combine(Seed, hash<typename Taggeds::type>()(
+      std::get<Indexes>(T)))), ...);
+    return Seed;
+  }
+};
+}
 #endif//TAGGED_H
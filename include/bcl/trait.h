@@ -33,6 +33,8 @@
 #include "Json.h"
 #include "tagged.h"
 #include <climits>
+#include <map>
+#include <memory_resource>
 #include <type_traits>
 #include <bitset>
 
@@ -633,6 +635,18 @@ public:
   /// Creates set of traits.
   TraitSet(TraitDescriptor &&TD) : mTD(std::move(TD)) {}
 
+  /// Creates an empty set of traits, a map of descriptions uses a specified
+  /// allocator.
+  template<class Alloc, class = typename std::enable_if<
+    std::uses_allocator<TraitMap, Alloc>::value>::type>
+  explicit TraitSet(const Alloc &A) : mValues(A) {}
+
+  /// Creates set of traits, a map of descriptions uses a specified allocator.
+  template<class Alloc, class = typename std::enable_if<
+    std::uses_allocator<TraitMap, Alloc>::value>::type>
+  TraitSet(const TraitDescriptor &TD, const Alloc &A) :
+    mValues(A), mTD(TD) {}
+
   /// Assigns descriptor to this set of traits.
   TraitSet & operator=(const TraitDescriptor &TD) {
     if (!mValues.empty())
@@ -820,6 +834,14 @@ private:
   TraitDescriptor mTD;
 };
 
+namespace pmr {
+/// Set of traits which stores descriptions in a map with a polymorphic
+/// allocator.
+template<class TraitDescriptor, class TraitTaggeds = TypeList<>>
+using TraitSet = bcl::TraitSet<TraitDescriptor,
+  std::pmr::map<TraitKey, void *>, TraitTaggeds>;
+}
+
 namespace trait {
 /// \brief Checks whether two traits (LHS and RHS) can be set simultaneously.
 ///
@@ -28,7 +28,12 @@
 
 #include <assert.h>
 #include <cstring>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <new>
 #include <queue>
+#include <utility>
 
 namespace bcl {
 /// \brief Simple queue that store pointers.
@@ -39,66 +44,113 @@ namespace bcl {
 ///
 /// This class is convenient to create some queue which usually contains only
 /// one element.
-template<class Ty>
+///
+/// The internal queue and its elements are allocated with a specified
+/// allocator. Use bcl::pmr::TransparentQueue to allocate memory from
+/// a std::pmr::memory_resource.
+template<class Ty, class Allocator = std::allocator<Ty *>>
 class TransparentQueue {
-  typedef std::queue<Ty *> Container;
+  typedef std::queue<Ty *, std::deque<Ty *, Allocator>> Container;
+  typedef typename std::allocator_traits<Allocator>::template
+    rebind_alloc<Container> ContainerAllocator;
+  typedef std::allocator_traits<ContainerAllocator> ContainerTraits;
 public:
   typedef typename Container::value_type value_type;
   typedef typename Container::size_type size_type;
   typedef typename Container::reference reference;
   typedef typename Container::const_reference const_reference;
+  typedef Allocator allocator_type;
 
   /// Creates an empty queue.
   TransparentQueue() noexcept :
     mIsSingle(true), mIsEmpty(true), mValue(nullptr) {}
 
+  /// Creates an empty queue which uses a specified allocator.
+  explicit TransparentQueue(const Allocator &A) noexcept :
+    mIsSingle(true), mIsEmpty(true), mAlloc(A), mValue(nullptr) {}
+
   /// Creates a queue that contains one pointer.
   explicit TransparentQueue(value_type V) noexcept :
     mIsSingle(true), mIsEmpty(false), mValue(V) {}
 
+  /// Creates a queue that contains one pointer and uses a specified allocator.
+  TransparentQueue(value_type V, const Allocator &A) noexcept :
+    mIsSingle(true), mIsEmpty(false), mAlloc(A), mValue(V) {}
+
   /// Copy constructor.
   TransparentQueue(const TransparentQueue &TQ) :
-      mIsSingle(TQ.mIsSingle), mIsEmpty(TQ.mIsEmpty) {
+    TransparentQueue(TQ, std::allocator_traits<Allocator>::
+      select_on_container_copy_construction(TQ.mAlloc)) {}
+
+  /// Copy constructor which uses a specified allocator.
+  TransparentQueue(const TransparentQueue &TQ, const Allocator &A) :
+      mIsSingle(TQ.mIsSingle), mIsEmpty(TQ.mIsEmpty), mAlloc(A) {
     if (mIsSingle)
       mValue = TQ.mValue;
     else
-      mQueue = new Container(*TQ.mQueue);
+      mQueue = createQueue(*TQ.mQueue);
   };
 
   /// Copy assignment.
   TransparentQueue & operator=(const TransparentQueue &TQ) {
+    if (this == &TQ)
+      return *this;
+    Container *Queue = TQ.mIsSingle ? nullptr : createQueue(*TQ.mQueue);
+    release();
     mIsSingle = TQ.mIsSingle;
     mIsEmpty = TQ.mIsEmpty;
     if (mIsSingle)
       mValue = TQ.mValue;
     else
-      mQueue = new Container(*TQ.mQueue);
+      mQueue = Queue;
+    return *this;
   }
 
   /// Move constructor.
-  TransparentQueue(TransparentQueue &&TQ) :
-      mIsSingle(TQ.mIsSingle), mIsEmpty(TQ.mIsEmpty) {
+  TransparentQueue(TransparentQueue &&TQ) noexcept :
+      mIsSingle(TQ.mIsSingle), mIsEmpty(TQ.mIsEmpty),
+      mAlloc(std::move(TQ.mAlloc)) {
+    std::memmove(&mQueue, &TQ.mQueue, sizeof(TQ.mQueue));
+    TQ.mIsSingle = true;
+    TQ.mIsEmpty = true;
+  }
+
+  /// Move constructor which uses a specified allocator.
+  ///
+  /// The internal queue is copied if allocators are not equal.
+  TransparentQueue(TransparentQueue &&TQ, const Allocator &A) :
+      mIsSingle(TQ.mIsSingle), mIsEmpty(TQ.mIsEmpty), mAlloc(A) {
+    if (!mIsSingle && !(mAlloc == TQ.mAlloc)) {
+      mQueue = createQueue(*TQ.mQueue);
+      return;
+    }
     std::memmove(&mQueue, &TQ.mQueue, sizeof(TQ.mQueue));
     TQ.mIsSingle = true;
     TQ.mIsEmpty = true;
   }
 
   /// Move assignment.
+  ///
+  /// The internal queue is copied if allocators are not equal.
   TransparentQueue & operator=(TransparentQueue &&TQ) {
+    if (this == &TQ)
+      return *this;
+    if (!TQ.mIsSingle && !(mAlloc == TQ.mAlloc))
+      return *this = static_cast<const TransparentQueue &>(TQ);
+    release();
     mIsSingle = TQ.mIsSingle;
     mIsEmpty = TQ.mIsEmpty;
     std::memmove(&mQueue, &TQ.mQueue, sizeof(TQ.mQueue));
     TQ.mIsSingle = true;
     TQ.mIsEmpty = true;
+    return *this;
   }
 
   /// Removes allocated memory if it is necessary.
-  ~TransparentQueue() {
-    if (!mIsSingle) {
-      assert(mQueue && "An internal storage must not be null!");
-      delete mQueue;
-    }
-  }
+  ~TransparentQueue() { release(); }
+
+  /// Returns allocator associated with the queue.
+  allocator_type get_allocator() const noexcept { return mAlloc; }
 
   /// Inserts an element V at the end of this queue.
   void push(value_type V) {
@@ -108,9 +160,9 @@ public:
         mValue = V;
         return;
       }
-      mIsSingle = false;
       auto Current = mValue;
-      mQueue = new Container();
+      mQueue = createQueue();
+      mIsSingle = false;
       mQueue->push(Current);
     }
     mQueue->push(V);
@@ -156,9 +208,9 @@ public:
   /// Pushes new element to the end of the queue.
   template<class... ArgTy> void emplace(ArgTy&&... Args) {
     if (mIsSingle) {
-      mIsSingle = false;
       Ty *Current = mValue;
-      mQueue = new Container();
+      mQueue = createQueue();
+      mIsSingle = false;
       mQueue->push(Current);
     }
     mQueue->emplace(Args...);
@@ -166,6 +218,8 @@ public:
 
   /// \brief Exchanges the contents of the queue with those of other.
   ///
+  /// Allocators of both queues must be equal.
+  ///
   /// TODO (kaniandr@gmail.com) : implement noexcept specification, note that
   /// the following one does not work:
   /// \code
@@ -174,10 +228,14 @@ public:
   ///   noexcept(mQueue->swap(TQ.mQueue))) {
   /// \endcode
   void swap(TransparentQueue &TQ) {
+    assert(mAlloc == TQ.mAlloc &&
+      "Queues with different allocators can not be swapped!");
     if (mIsSingle) {
       if (TQ.mIsSingle) {
         std::swap(mValue, TQ.mValue);
-        std::swap(mIsEmpty, TQ.mIsEmpty);
+        bool IsEmpty = mIsEmpty;
+        mIsEmpty = TQ.mIsEmpty;
+        TQ.mIsEmpty = IsEmpty;
       } else {
         Ty *Tmp = mValue;
         mIsSingle = false;
@@ -188,14 +246,14 @@ public:
       }
     } else {
       if (TQ.mIsSingle) {
-        Ty *Tmp = TQ.Value;
+        Ty *Tmp = TQ.mValue;
         TQ.mIsSingle = false;
         TQ.mQueue = mQueue;
         mIsSingle = true;
         mIsEmpty = TQ.mIsEmpty;
         mValue = Tmp;
       } else {
-        mQueue->swap(TQ.mQueue);
+        std::swap(mQueue, TQ.mQueue);
       }
     }
   }
@@ -229,13 +287,13 @@ public:
         *mQueue < *TQ.mQueue;
     } else {
       if (mIsSingle) {
-        Container Tmp;
+        Container Tmp(mAlloc);
         if (!mIsEmpty)
           Tmp.push(mValue);
         return Tmp < *TQ.mQueue;
       }
       else {
-        Container Tmp;
+        Container Tmp(mAlloc);
         if (!TQ.mIsEmpty)
           Tmp.push(TQ.mValue);
         return *mQueue < Tmp;
@@ -244,11 +302,39 @@ public:
   }
 
 private:
+  /// Allocates an internal queue with the allocator of this queue.
+  template<class... ArgTy> Container * createQueue(const ArgTy &... Args) {
+    ContainerAllocator A(mAlloc);
+    auto *Queue = ContainerTraits::allocate(A, 1);
+    try {
+      ::new (static_cast<void *>(Queue)) Container(Args..., mAlloc);
+    } catch (...) {
+      ContainerTraits::deallocate(A, Queue, 1);
+      throw;
+    }
+    return Queue;
+  }
+
+  /// Releases the internal queue if it is necessary.
+  void release() noexcept {
+    if (mIsSingle)
+      return;
+    assert(mQueue && "An internal storage must not be null!");
+    ContainerAllocator A(mAlloc);
+    mQueue->~Container();
+    ContainerTraits::deallocate(A, mQueue, 1);
+    mIsSingle = true;
+    mIsEmpty = true;
+    mValue = nullptr;
+  }
+
   struct {
     bool mIsSingle : 1;
     bool mIsEmpty : 1;
   };
 
+  Allocator mAlloc;
+
   union {
     value_type mValue;
     Container *mQueue;
@@ -256,35 +342,47 @@ private:
 };
 
 /// Exchanges the contents of the queue with those of other.
-template<class Ty> inline
-void swap(TransparentQueue<Ty> &Left, TransparentQueue<Ty> &Right)
+template<class Ty, class Allocator> inline
+void swap(TransparentQueue<Ty, Allocator> &Left,
+    TransparentQueue<Ty, Allocator> &Right)
     noexcept(noexcept(Left.swap(Right))) {
   Left.swap(Right);
 }
 
 /// Compares the contents of two queues.
-template<class Ty> inline bool operator!=(
-    const TransparentQueue<Ty> &Left, const TransparentQueue<Ty> &Right) {
+template<class Ty, class Allocator> inline bool operator!=(
+    const TransparentQueue<Ty, Allocator> &Left,
+    const TransparentQueue<Ty, Allocator> &Right) {
   return !(Left == Right);
 }
 
 /// Lexicographically compares the values in the queue.
-template<class Ty> inline bool operator>(
-  const TransparentQueue<Ty> &Left, const TransparentQueue<Ty> &Right) {
+template<class Ty, class Allocator> inline bool operator>(
+    const TransparentQueue<Ty, Allocator> &Left,
+    const TransparentQueue<Ty, Allocator> &Right) {
   return Right < Left;
 }
 
 /// Lexicographically compares the values in the queue.
-template<class Ty> inline bool operator<=(
-  const TransparentQueue<Ty> &Left, const TransparentQueue<Ty> &Right) {
+template<class Ty, class Allocator> inline bool operator<=(
+    const TransparentQueue<Ty, Allocator> &Left,
+    const TransparentQueue<Ty, Allocator> &Right) {
   return !(Right < Left);
 }
 
 /// Lexicographically compares the values in the queue.
-template<class Ty> inline bool operator>=(
-  const TransparentQueue<Ty> &Left, const TransparentQueue<Ty> &Right) {
+template<class Ty, class Allocator> inline bool operator>=(
+    const TransparentQueue<Ty, Allocator> &Left,
+    const TransparentQueue<Ty, Allocator> &Right) {
   return !(Left < Right);
 }
+
+namespace pmr {
+/// Transparent queue which uses a polymorphic allocator.
+template<class Ty>
+using TransparentQueue =
+  bcl::TransparentQueue<Ty, std::pmr::polymorphic_allocator<Ty *>>;
+}
 }
 
 #endif//BCL_TRANSPARENT_QUEUE_H
@@ -26,10 +26,14 @@
 #ifndef BCL_UTILITY_H
 #define BCL_UTILITY_H
 
+#include <array>
+#include <cassert>
 #include <climits>
+#include <cstdint>
 #include <cstring>
 #include <type_traits>
 #include <memory>
+#include <new>
 #include <string>
 #include <utility>
 
@@ -45,6 +49,32 @@
 # endif
 #endif
 
+#if defined(__has_builtin)
+# if __has_builtin(__builtin_bit_cast)
+#  define BCL_HAS_BUILTIN_BIT_CAST
+# endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1927
+# define BCL_HAS_BUILTIN_BIT_CAST
+#endif
+
+#if defined(__has_builtin)
+# if __has_builtin(__type_pack_element)
+#  define BCL_HAS_BUILTIN_TYPE_PACK_ELEMENT
+# endif
+#endif
+
+/// This is `constexpr` if bcl::bit_cast() can be used in constant expressions.
+#ifdef BCL_HAS_BUILTIN_BIT_CAST
+# define BCL_CONSTEXPR_BIT_CAST constexpr
+#else
+# define BCL_CONSTEXPR_BIT_CAST
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ || \
+    defined(_WIN32)
+# define BCL_LITTLE_ENDIAN
+#endif
+
 /// \brief This can be used to set list of parameters as single parameter
 /// of a macro.
 ///
@@ -166,46 +196,68 @@ public:
 ///
 /// If Ty is contained in Args provides the member constant `value` equal to true.
 /// Otherwise `value` is false.
-template<class Ty, class... Args> struct is_contained;
-
-/// Checks if Ty is contained in the list of types Args.
-template<class Ty> struct is_contained<Ty> : public std::false_type {};
-
-/// Checks if Ty is contained in the list of types Args.
-template<class Ty, class First, class... Args>
-struct is_contained<Ty, First, Args...> :
-  public std::conditional<std::is_same<Ty, First>::value,
-  std::true_type, is_contained<Ty, Args...>>::type{};
+///
+/// Fold expression is used instead of recursion, so this does not instantiate
+/// intermediate types for each element of Args.
+template<class Ty, class... Args> struct is_contained :
+  public std::integral_constant<bool,
+    (false || ... || std::is_same<Ty, Args>::value)> {};
 
 namespace detail {
-template<class Ty, class... Args> struct IndexOfImp;
+/// Returns index of the first flag which is true or the number of flags if
+/// all flags are false.
+///
+/// The search is performed by a constexpr loop, so the depth of
+/// instantiation does not depend on the number of flags.
+template<bool... Flags> constexpr std::size_t findFirst() {
+  constexpr bool Values[] = { false, Flags... };
+  for (std::size_t I = 1; I <= sizeof...(Flags); ++I)
+    if (Values[I])
+      return I - 1;
+  return sizeof...(Flags);
+}
 
-template<class Ty, class Arg>
-struct IndexOfImp<Ty, Arg> {
+/// Provides index of type Ty in the list of types Args.
+///
+/// If Ty is not contained in Args the number of types in Args is returned,
+/// so the result can be compared with bcl::size_of<Args...>() to check that
+/// Ty has been found. bcl::index_of() does not accept such types.
+template<class Ty, class... Args> struct IndexOfImp {
   static constexpr std::size_t index_of() {
-    return 0;
+    return findFirst<std::is_same<Ty, Args>::value...>();
   }
 };
 
-template<class Ty, class First, class... Args>
-struct IndexOfImp<Ty, First, Args...> {
-  static constexpr std::size_t index_of() {
-    return std::is_same<Ty, First>::value ? 0 :
-      IndexOfImp<Ty, Args...>::index_of() + 1;
-  }
+template<class... Args> struct SizeOfImp {
+  static constexpr std::size_t size_of() { return sizeof...(Args); }
 };
 
-template<class... Args> struct SizeOfImp;
+/// A base of bcl::detail::TypePackElementImp which binds a type to an index.
+template<std::size_t Idx, class Ty> struct IndexedType { using type = Ty; };
 
-template<> struct SizeOfImp<> {
-  static constexpr std::size_t size_of() { return 0; }
-};
+template<class IndexSeq, class... Args> struct TypePackElementImp;
 
-template<class First, class... Args>
-struct SizeOfImp<First, Args...> {
-  static constexpr std::size_t size_of() {
-    return SizeOfImp<Args...>::size_of() + 1;
-  }
+template<std::size_t... Indexes, class... Args>
+struct TypePackElementImp<std::index_sequence<Indexes...>, Args...> :
+  public IndexedType<Indexes, Args>... {};
+
+template<std::size_t Idx, class Ty>
+IndexedType<Idx, Ty> selectIndexedType(const IndexedType<Idx, Ty> &);
+
+/// \brief Provides a member typedef `type` which is a type with a specified
+/// index in the list of types Args.
+///
+/// Overload resolution over a set of bases is used to find a type, so this
+/// does not instantiate intermediate types for each element of Args.
+template<std::size_t Idx, class... Args> struct TypePackElement {
+  static_assert(Idx < sizeof...(Args), "Index is out of range!");
+#ifdef BCL_HAS_BUILTIN_TYPE_PACK_ELEMENT
+  using type = __type_pack_element<Idx, Args...>;
+#else
+  using type = typename decltype(selectIndexedType<Idx>(
+    std::declval<TypePackElementImp<
+      std::index_sequence_for<Args...>, Args...>>()))::type;
+#endif
 };
 }
 
@@ -337,25 +389,145 @@ std::unique_ptr<T> make_unique_piecewise(std::tuple<ArgT...> Args) {
                                           std::index_sequence_for<ArgT...>());
 }
 
+/// \brief Determines whether objects of a type `T` can be relocated (moved to
+/// a new location and destroyed at the old one) with a plain memory copy.
+///
+/// All trivially copyable types are trivially relocatable. This is
+/// a customization point: specialize it for types which have non-trivial
+/// move constructor or destructor but do not depend on their own address
+/// (for example, classes which own heap memory through a pointer).
+template<class T> struct is_trivially_relocatable :
+  public std::is_trivially_copyable<T> {};
+
 /// Exchanges contents of passed objects, this is useful if specified objects
 /// haven't necessary operators available (e.g. private operator=, etc).
 /// Note, this function does not swap external memory to which objects refer.
+///
+/// Objects are exchanged through a fixed-size buffer on stack, large objects
+/// are exchanged chunk by chunk.
 template<typename T> void swapMemory(T &LObj, T &RObj) {
   if (&LObj == &RObj)
     return;
-  char* Tmp = nullptr;
-  const int Size = sizeof(T) / sizeof(*Tmp);
-  Tmp = new char[Size];
-  std::memcpy(Tmp, &LObj, Size);
-  std::memcpy(&LObj, &RObj, Size);
-  std::memcpy(&RObj, Tmp, Size);
-  delete[] Tmp;
+  constexpr std::size_t BufferSize = sizeof(T) < 256 ? sizeof(T) : 256;
+  char Tmp[BufferSize];
+  auto *L = reinterpret_cast<char *>(&LObj);
+  auto *R = reinterpret_cast<char *>(&RObj);
+  for (std::size_t Offset = 0; Offset < sizeof(T); Offset += BufferSize) {
+    auto Size = sizeof(T) - Offset < BufferSize ? sizeof(T) - Offset :
+      BufferSize;
+    std::memcpy(Tmp, L + Offset, Size);
+    std::memcpy(L + Offset, R + Offset, Size);
+    std::memcpy(R + Offset, Tmp, Size);
+  }
 }
 
-/// Shrink a pair of values to a single value of a specified type if possible,
-/// return true on success.
+namespace detail {
+/// Relocates objects of a trivially relocatable type.
+template<class T>
+inline void relocate_n(T *First, std::size_t N, T *Dest, std::true_type) {
+  std::memmove(static_cast<void *>(Dest), static_cast<const void *>(First),
+    N * sizeof(T));
+}
+
+/// Relocates objects one by one using move constructor and destructor.
+template<class T>
+void relocate_n(T *First, std::size_t N, T *Dest, std::false_type) {
+  if (Dest < First) {
+    for (std::size_t I = 0; I < N; ++I) {
+      ::new (static_cast<void *>(Dest + I)) T(std::move(First[I]));
+      First[I].~T();
+    }
+  } else {
+    for (std::size_t I = N; I > 0; --I) {
+      ::new (static_cast<void *>(Dest + I - 1)) T(std::move(First[I - 1]));
+      First[I - 1].~T();
+    }
+  }
+}
+}
+
+/// \brief Relocates `N` objects which start at `First` to a memory which
+/// starts at `Dest`.
+///
+/// Source and destination ranges may overlap, so this can be used to shift
+/// elements of a container on insertion or erasure. After relocation objects
+/// in the source range which do not belong to the destination range are
+/// destroyed and objects in the destination range which do not belong to the
+/// source range must be previously uninitialized.
+/// If `T` is trivially relocatable the whole range is relocated with a single
+/// memmove(), otherwise each object is move-constructed and destroyed.
+/// \return Pointer to the end of the destination range.
+template<class T> T * relocate_n(T *First, std::size_t N, T *Dest) {
+  if (First == Dest || N == 0)
+    return Dest + N;
+  detail::relocate_n(First, N, Dest, is_trivially_relocatable<T>());
+  return Dest + N;
+}
+
+/// \brief Relocates objects from a range [First, Last) to an uninitialized
+/// memory which starts at `Dest`.
+///
+/// Objects in the source range are destroyed. Ranges must not overlap,
+/// use bcl::relocate_n() to shift objects inside a single buffer.
+/// \return Pointer to the end of the destination range.
+template<class T> T * uninitialized_relocate(T *First, T *Last, T *Dest) {
+  assert((Last <= Dest || Dest + (Last - First) <= First) &&
+    "Ranges must not overlap!");
+  return relocate_n(First, static_cast<std::size_t>(Last - First), Dest);
+}
+
+/// \brief Reinterprets the object representation of one type as that of
+/// another.
+///
+/// This function is available since C++ 20, so this implementation is
+/// convenient to use if only C++ 17 is available. It can be used in constant
+/// expressions if the compiler provides __builtin_bit_cast
+/// (BCL_CONSTEXPR_BIT_CAST is defined to `constexpr` in this case).
+template<class To, class From>
+inline BCL_CONSTEXPR_BIT_CAST To bit_cast(const From &V) noexcept {
+  static_assert(sizeof(To) == sizeof(From),
+    "Types must have the same size!");
+  static_assert(std::is_trivially_copyable<To>::value &&
+    std::is_trivially_copyable<From>::value,
+    "Types must be trivially copyable!");
+#ifdef BCL_HAS_BUILTIN_BIT_CAST
+  return __builtin_bit_cast(To, V);
+#else
+  To Res;
+  std::memcpy(&Res, &V, sizeof(To));
+  return Res;
+#endif
+}
+
+namespace detail {
+/// Shrinks a pair of trivially copyable values, this can be used in constant
+/// expressions.
+template<class FirstT, class SecondT, class T>
+inline BCL_CONSTEXPR_BIT_CAST bool shrinkPair(
+    const FirstT &First, const SecondT &Second, T &Out, std::true_type) {
+  constexpr auto HalfSizeOfT = sizeof(T) / 2;
+  auto RawFirst = bcl::bit_cast<std::array<unsigned char, sizeof(FirstT)>>(
+    First);
+  for (std::size_t I = HalfSizeOfT; I < sizeof(FirstT); ++I)
+    if (RawFirst[I] != 0)
+      return false;
+  auto RawSecond = bcl::bit_cast<std::array<unsigned char, sizeof(SecondT)>>(
+    Second);
+  for (std::size_t I = HalfSizeOfT; I < sizeof(SecondT); ++I)
+    if (RawSecond[I] != 0)
+      return false;
+  std::array<unsigned char, sizeof(T)> RawOut{};
+  for (std::size_t I = 0; I < HalfSizeOfT && I < sizeof(FirstT); ++I)
+    RawOut[I] = RawFirst[I];
+  for (std::size_t I = 0; I < HalfSizeOfT && I < sizeof(SecondT); ++I)
+    RawOut[HalfSizeOfT + I] = RawSecond[I];
+  Out = bcl::bit_cast<T>(RawOut);
+  return true;
+}
+
+/// Shrinks a pair of values which are not trivially copyable.
 template<class FirstT, class SecondT, class T> bool shrinkPair(
-    const FirstT &First, const SecondT &Second, T &Out) {
+    const FirstT &First, const SecondT &Second, T &Out, std::false_type) {
   char RawFirst[sizeof(FirstT)], RawSecond[sizeof(SecondT)];
   constexpr auto SizeOfT = sizeof(T);
   constexpr auto HalfSizeOfT = SizeOfT / 2;
@@ -374,9 +546,147 @@ template<class FirstT, class SecondT, class T> bool shrinkPair(
   return true;
 }
 
+/// Restores a pair of trivially copyable values, this can be used in
+/// constant expressions.
+template<class FirstT, class SecondT, class T>
+inline BCL_CONSTEXPR_BIT_CAST void restoreShrinkedPair(
+    const T &Data, FirstT &First, SecondT &Second, std::true_type) {
+  constexpr auto HalfSizeOfT = sizeof(T) / 2;
+  auto RawData = bcl::bit_cast<std::array<unsigned char, sizeof(T)>>(Data);
+  std::array<unsigned char, sizeof(FirstT)> RawFirst{};
+  for (std::size_t I = 0; I < HalfSizeOfT; ++I)
+    RawFirst[I] = RawData[I];
+  First = bcl::bit_cast<FirstT>(RawFirst);
+  std::array<unsigned char, sizeof(SecondT)> RawSecond{};
+  for (std::size_t I = 0; I < HalfSizeOfT; ++I)
+    RawSecond[I] = RawData[HalfSizeOfT + I];
+  Second = bcl::bit_cast<SecondT>(RawSecond);
+}
+
+/// Restores a pair of values which are not trivially copyable.
+template<class FirstT, class SecondT, class T>
+void restoreShrinkedPair(
+    const T &Data, FirstT &First, SecondT &Second, std::false_type) {
+  constexpr auto SizeOfT = sizeof(T);
+  constexpr auto HalfSizeOfT = SizeOfT / 2;
+  char RawData[SizeOfT];
+  new (RawData) T(Data);
+  std::memset(&First, 0, sizeof(FirstT));
+  std::memmove(&First, RawData, HalfSizeOfT);
+  std::memset(&Second, 0, sizeof(SecondT));
+  std::memmove(&Second, RawData + HalfSizeOfT, HalfSizeOfT);
+}
+
+/// \brief Checks whether pairs of integers can be shrinked with bitwise
+/// operations on 64-bit unsigned values.
+///
+/// Bitwise operations produce the same layout as byte copying on
+/// little-endian targets only. The `bool` type is excluded because it has no
+/// unsigned counterpart.
+template<class FirstT, class SecondT, class T> struct IsShrinkableByShift :
+  public std::integral_constant<bool,
+#ifdef BCL_LITTLE_ENDIAN
+    std::is_integral<FirstT>::value && std::is_integral<SecondT>::value &&
+    !std::is_same<FirstT, bool>::value && !std::is_same<SecondT, bool>::value &&
+    std::is_integral<T>::value && sizeof(T) >= 2 && sizeof(T) <= 8 &&
+    sizeof(FirstT) <= 8 && sizeof(SecondT) <= 8
+#else
+    false
+#endif
+  > {};
+
+template<class FirstT, class SecondT, class T, class FailedItrT>
+std::size_t shrinkPairs(const std::pair<FirstT, SecondT> *Data,
+    std::size_t Size, T *Out, FailedItrT Failed, std::true_type) {
+  constexpr unsigned HalfBits = sizeof(T) / 2 * CHAR_BIT;
+  using UFirstT = typename std::make_unsigned<FirstT>::type;
+  using USecondT = typename std::make_unsigned<SecondT>::type;
+  using UT = typename std::make_unsigned<T>::type;
+  // There are no branches in this loop, so it can be vectorized.
+  std::uint64_t HighBits = 0;
+  for (std::size_t I = 0; I < Size; ++I) {
+    std::uint64_t F = static_cast<UFirstT>(Data[I].first);
+    std::uint64_t S = static_cast<USecondT>(Data[I].second);
+    Out[I] = static_cast<T>(static_cast<UT>(F | S << HalfBits));
+    HighBits |= (F | S) >> HalfBits;
+  }
+  if (HighBits == 0)
+    return 0;
+  std::size_t FailedNum = 0;
+  for (std::size_t I = 0; I < Size; ++I) {
+    std::uint64_t F = static_cast<UFirstT>(Data[I].first);
+    std::uint64_t S = static_cast<USecondT>(Data[I].second);
+    if ((F | S) >> HalfBits) {
+      *Failed++ = I;
+      ++FailedNum;
+    }
+  }
+  return FailedNum;
+}
+
+template<class FirstT, class SecondT, class T, class FailedItrT>
+std::size_t shrinkPairs(const std::pair<FirstT, SecondT> *Data,
+    std::size_t Size, T *Out, FailedItrT Failed, std::false_type) {
+  std::size_t FailedNum = 0;
+  for (std::size_t I = 0; I < Size; ++I)
+    if (!bcl::detail::shrinkPair(Data[I].first, Data[I].second, Out[I],
+          std::integral_constant<bool,
+            std::is_trivially_copyable<FirstT>::value &&
+            std::is_trivially_copyable<SecondT>::value &&
+            std::is_trivially_copyable<T>::value>())) {
+      *Failed++ = I;
+      ++FailedNum;
+    }
+  return FailedNum;
+}
+
+template<class FirstT, class SecondT, class T>
+void restoreShrinkedPairs(const T *Data, std::size_t Size,
+    std::pair<FirstT, SecondT> *Out, std::true_type) {
+  constexpr unsigned HalfBits = sizeof(T) / 2 * CHAR_BIT;
+  constexpr std::uint64_t Mask = (std::uint64_t(1) << HalfBits) - 1;
+  using UT = typename std::make_unsigned<T>::type;
+  for (std::size_t I = 0; I < Size; ++I) {
+    std::uint64_t D = static_cast<UT>(Data[I]);
+    Out[I].first = static_cast<FirstT>(D & Mask);
+    Out[I].second = static_cast<SecondT>(D >> HalfBits & Mask);
+  }
+}
+
+template<class FirstT, class SecondT, class T>
+void restoreShrinkedPairs(const T *Data, std::size_t Size,
+    std::pair<FirstT, SecondT> *Out, std::false_type) {
+  for (std::size_t I = 0; I < Size; ++I)
+    bcl::detail::restoreShrinkedPair(Data[I], Out[I].first, Out[I].second,
+      std::integral_constant<bool,
+        std::is_trivially_copyable<FirstT>::value &&
+        std::is_trivially_copyable<SecondT>::value &&
+        std::is_trivially_copyable<T>::value>());
+}
+}
+
+/// \brief Shrink a pair of values to a single value of a specified type if
+/// possible, return true on success.
+///
+/// The first half of bytes in `Out` is occupied with the first bytes of
+/// the `First` value, the second half is occupied with the first bytes of
+/// the `Second` value. The rest bytes of each value must be zero.
+/// If all types are trivially copyable this can be used in constant
+/// expressions (see bcl::bit_cast()).
+template<class FirstT, class SecondT, class T>
+inline BCL_CONSTEXPR_BIT_CAST bool shrinkPair(
+    const FirstT &First, const SecondT &Second, T &Out) {
+  return detail::shrinkPair(First, Second, Out,
+    std::integral_constant<bool,
+      std::is_trivially_copyable<FirstT>::value &&
+      std::is_trivially_copyable<SecondT>::value &&
+      std::is_trivially_copyable<T>::value>());
+}
+
 /// Shrink a pair of values to a single value of a specified type if possible,
 /// return true on success.
-template<class FirstT, class SecondT, class T> bool shrinkPair(
+template<class FirstT, class SecondT, class T>
+inline BCL_CONSTEXPR_BIT_CAST bool shrinkPair(
     const std::pair<FirstT, SecondT> &Data, T &Out) {
   return shrinkPair(Data.first, Data.second, Out);
 }
@@ -384,21 +694,119 @@ template<class FirstT, class SecondT, class T> bool shrinkPair(
 /// Restore a pair of values which have been previously shrinked to a specified
 /// type `T`.
 template<class FirstT, class SecondT, class T>
-void restoreShrinkedPair(const T &Data, FirstT &First, SecondT &Second) {
+inline BCL_CONSTEXPR_BIT_CAST void restoreShrinkedPair(
+    const T &Data, FirstT &First, SecondT &Second) {
   constexpr auto SizeOfT = sizeof(T);
   constexpr auto HalfSizeOfT = SizeOfT / 2;
   static_assert(sizeof(FirstT) >= HalfSizeOfT,
     "Too small target type of a first value!");
   static_assert(sizeof(SecondT) >= HalfSizeOfT ,
     "Too small target type of a second value!");
-  char RawData[SizeOfT];
-  new (RawData) T(Data);
-  std::memset(&First, 0, sizeof(FirstT));
-  std::memmove(&First, RawData, HalfSizeOfT);
-  std::memset(&Second, 0, sizeof(SecondT));
-  std::memmove(&Second, RawData + HalfSizeOfT, HalfSizeOfT);
+  detail::restoreShrinkedPair(Data, First, Second,
+    std::integral_constant<bool,
+      std::is_trivially_copyable<FirstT>::value &&
+      std::is_trivially_copyable<SecondT>::value &&
+      std::is_trivially_copyable<T>::value>());
+}
+
+/// \brief Shrink each pair in an array `Data` of a specified size and store
+/// results in an array `Out` of the same size.
+///
+/// Indices of pairs which can not be shrinked are written to an output
+/// iterator `Failed` in ascending order, values in `Out` at these indices
+/// are unspecified. Pairs of integers are shrinked with a branch-free loop
+/// which can be vectorized by a compiler.
+/// \return Number of pairs which can not be shrinked.
+template<class FirstT, class SecondT, class T, class FailedItrT>
+std::size_t shrinkPairs(const std::pair<FirstT, SecondT> *Data,
+    std::size_t Size, T *Out, FailedItrT Failed) {
+  return detail::shrinkPairs(Data, Size, Out, Failed,
+    detail::IsShrinkableByShift<FirstT, SecondT, T>());
+}
+
+/// Restore each pair of values in an array `Out` of a specified size from
+/// a value in an array `Data` which has been previously shrinked with
+/// bcl::shrinkPair() or bcl::shrinkPairs().
+template<class FirstT, class SecondT, class T>
+void restoreShrinkedPairs(const T *Data, std::size_t Size,
+    std::pair<FirstT, SecondT> *Out) {
+  static_assert(sizeof(FirstT) >= sizeof(T) / 2,
+    "Too small target type of a first value!");
+  static_assert(sizeof(SecondT) >= sizeof(T) / 2,
+    "Too small target type of a second value!");
+  detail::restoreShrinkedPairs(Data, Size, Out,
+    detail::IsShrinkableByShift<FirstT, SecondT, T>());
 }
 
+/// \brief Determines whether objects of a type `T` are equal if and only if
+/// their object representations are equal.
+///
+/// Such objects can be compared with memcmp() and hashed as a contiguous
+/// range of bytes. By default, this is true for types which have unique
+/// object representations (integers, pointers, enumerations and classes
+/// without padding which consist of such types). This is a customization
+/// point: specialize it to `false` for a type which defines equality in
+/// a different way.
+template<class T> struct is_bitwise_comparable :
+  public std::has_unique_object_representations<T> {};
+
+/// \brief Mixes bits of a specified value.
+///
+/// This is a finalizer of 64-bit MurmurHash3, each bit of an input affects
+/// each bit of a result.
+inline constexpr std::uint64_t hash_mix(std::uint64_t V) noexcept {
+  V ^= V >> 33;
+  V *= 0xff51afd7ed558ccdULL;
+  V ^= V >> 33;
+  V *= 0xc4ceb9fe1a85ec53ULL;
+  V ^= V >> 33;
+  return V;
+}
+
+/// Combines a hash value of an object with a hash value `Seed` of previously
+/// visited objects.
+inline constexpr std::size_t hash_combine(
+    std::size_t Seed, std::size_t Hash) noexcept {
+  return static_cast<std::size_t>(
+    hash_mix(Seed + 0x9e3779b97f4a7c15ULL + hash_mix(Hash)));
+}
+
+namespace detail {
+inline std::uint64_t loadHashWord(const unsigned char *Ptr) noexcept {
+  std::uint64_t W;
+  std::memcpy(&W, Ptr, sizeof(W));
+  return W;
+}
+
+inline constexpr std::uint64_t rotateLeft(
+    std::uint64_t V, unsigned S) noexcept {
+  return (V << S) | (V >> (64 - S));
+}
+}
+
+/// \brief Computes a hash value of a range of bytes.
+///
+/// Each 64-bit word is mixed with a key which depends on its position, and
+/// results are summed. So, multiplications do not form a dependency chain,
+/// they are executed in parallel and the loop can be vectorized.
+inline std::size_t hash_bytes(
+    const void *Data, std::size_t Size, std::size_t Seed = 0) noexcept {
+  constexpr std::uint64_t P1 = 0x9e3779b185ebca87ULL;
+  constexpr std::uint64_t P2 = 0xc2b2ae3d27d4eb4fULL;
+  auto *Ptr = static_cast<const unsigned char *>(Data);
+  std::uint64_t H = Seed + Size * P1;
+  std::uint64_t Key = P2;
+  std::size_t I = 0;
+  for (; I + 8 <= Size; I += 8, Key += P1)
+    H += detail::rotateLeft(
+      (detail::loadHashWord(Ptr + I) ^ Key) * P1, 31) * P2;
+  if (I < Size) {
+    std::uint64_t W = 0;
+    std::memcpy(&W, Ptr + I, Size - I);
+    H += detail::rotateLeft((W ^ Key) * P1, 31) * P2;
+  }
+  return static_cast<std::size_t>(hash_mix(H));
+}
 }
 
 #ifndef NULL
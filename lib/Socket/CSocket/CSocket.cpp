@@ -27,6 +27,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <bcl/CSocket.h>
+#include <bcl/Trace.h>
 #include <bcl/utility.h>
 #include <cassert>
 #include <csignal>
@@ -201,6 +202,7 @@ public:
      , mOn(on) {}
 
   void send(const std::string &Message) const override {
+    BCL_TRACE_SCOPE("net::Connection::send");
     if (!sendData(mConnectionFD, Message)) {
       mOn(bcl::net::SocketStatus::SendError, mConnection);
       mState = State::OnClose;
@@ -218,6 +220,7 @@ public:
   }
 
   int run() {
+    BCL_TRACE_SCOPE("net::Connection");
     bcl::createServer(this);
     auto Buffer = bcl::make_unique<char[]>(mBufferSize + 1);
     for (;;) {
@@ -233,6 +236,7 @@ public:
       }
       Buffer.get()[ReceivedInfo.first] = '\0';
       mOn(bcl::net::SocketStatus::Receive, mConnection);
+      BCL_TRACE_SCOPE("net::Connection::receive");
       for (auto &Callback : mReceiveCallbacks)
         Callback(std::string(Buffer.get()));
       if (mState == State::OnClose) {
@@ -0,0 +1,147 @@
+//===- alloc_test.cpp ------- Allocation Budget Test -------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements regression tests for the number of heap allocations
+// performed by BCL components. Each check fails if the number of allocations
+// exceeds a specified budget.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/AllocationCounter.h>
+#include <bcl/Diagnostic.h>
+#include <bcl/Json.h>
+#include <bcl/transparent_queue.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+BCL_COUNTING_OPERATOR_NEW
+
+JSON_OBJECT_BEGIN(Human)
+JSON_OBJECT_ROOT_PAIR_3(Human,
+  Name, std::string,
+  Age, unsigned,
+  Children, std::vector<std::string>)
+  Human() : JSON_INIT_ROOT {}
+JSON_OBJECT_END(Human)
+JSON_DEFAULT_TRAITS(::, Human)
+
+/// Prints statistic of a specified scope and checks that the number of
+/// allocations does not exceed a specified budget.
+static bool check(const bcl::AllocationScope &S, std::size_t Budget) {
+  bool Ok = S.stats().Allocations <= Budget;
+  std::cout << S.name() << ": " << S.stats().Allocations << " allocations ("
+    << S.stats().Bytes << " bytes), budget " << Budget
+    << (Ok ? "" : " exceeded") << std::endl;
+  return Ok;
+}
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  bool Ok = true;
+  {
+    int X = 0, Y = 0;
+    bcl::TransparentQueue<int> TQ;
+    {
+      bcl::AllocationScope S("push single element to TransparentQueue");
+      TQ.push(&X);
+      TQ.pop();
+      Ok &= check(S, 0);
+    }
+    {
+      bcl::AllocationScope S("push two elements to TransparentQueue");
+      TQ.push(&X);
+      TQ.push(&Y);
+      Ok &= check(S, 3);
+    }
+  }
+  {
+    bcl::Diagnostic D("error");
+    bcl::AllocationScope S("insert diagnostic");
+    D.insert(1, "unexpected symbol %c", 42, 'x');
+    Ok &= check(S, 2);
+  }
+  {
+    std::string JSON(R"j({"name": "Human", "Name": "Jon", "Age": 42,)j"
+      R"j( "Children": ["Ann", "Bob"]})j");
+    // Name of an object is interned once, it is not a per-parse cost.
+    json::Object::id<Human>();
+    bcl::AllocationScope S("parse JSON object");
+    json::Parser<Human> P(JSON);
+    auto O = P.parse();
+    Ok &= O && O->is<Human>();
+    Ok &= check(S, 6);
+  }
+  {
+    Human H;
+    H[Human::Name] = "Jon";
+    H[Human::Age] = 42;
+    H[Human::Children] = { "Ann", "Bob" };
+    bcl::AllocationScope S("unparse JSON object");
+    auto JSON = json::Parser<Human>::unparseAsObject(H);
+    Ok &= !JSON.empty();
+    Ok &= check(S, 5);
+  }
+  {
+    std::string JSON("[");
+    for (unsigned I = 0; I < 100; ++I)
+      JSON += R"j("category of a file", "path/to/a/file.cpp", )j";
+    JSON += R"j("category of a file"])j";
+    json::SymbolPool Pool;
+    std::vector<json::Symbol> V;
+    V.reserve(201);
+    json::Parser<> P(JSON);
+    P.setSymbolPool(&Pool);
+    bcl::AllocationScope S("parse repeated symbols");
+    Ok &= P.parse(V) && V.size() == 201 && Pool.size() == 2;
+    Ok &= check(S, 5);
+  }
+  {
+    std::string JSON("[");
+    for (unsigned I = 0; I < 100; ++I)
+      JSON += R"j({"Kind":"error","Code":101,"Position":100,)j"
+        R"j("Message":"unexpected \"x\""},)j";
+    JSON.back() = ']';
+    std::pmr::monotonic_buffer_resource Arena;
+    bcl::Diagnostic D("error", &Arena);
+    D.insert(1, "reserve memory in the arena", 0);
+    D.clear();
+    json::Parser<> P(JSON);
+    bcl::AllocationScope S("parse diagnostics");
+    Ok &= P.parse(D) && D.size() == 100;
+    Ok &= check(S, 3);
+  }
+  {
+    // Allocations from the default upstream resource are also counted by
+    // the replaced operator new, so use a buffer to count them once.
+    alignas(std::max_align_t) char Buffer[256];
+    std::pmr::monotonic_buffer_resource Arena(
+      Buffer, sizeof(Buffer), std::pmr::null_memory_resource());
+    bcl::CountingResource R(&Arena);
+    bcl::AllocationScope S("std::pmr::vector with CountingResource");
+    std::pmr::vector<int> V(&R);
+    V.reserve(16);
+    V.assign(16, 0);
+    Ok &= R.stats().Allocations == 1 && check(S, 1);
+  }
+  std::cout << (Ok ? "passed" : "failed") << std::endl;
+  return Ok ? 0 : 1;
+}
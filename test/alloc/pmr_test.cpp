@@ -0,0 +1,192 @@
+//===- pmr_test.cpp ------ Polymorphic Allocator Test -------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements tests for BCL containers which use
+// std::pmr::polymorphic_allocator. Each check fails if a container allocates
+// memory from the global heap instead of a specified memory resource.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/AllocationCounter.h>
+#include <bcl/Diagnostic.h>
+#include <bcl/Json.h>
+#include <bcl/marray.h>
+#include <bcl/trait.h>
+#include <bcl/transparent_queue.h>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+BCL_COUNTING_OPERATOR_NEW
+
+namespace {
+struct Read {};
+struct Write {};
+using AccessDescriptor = bcl::TraitDescriptor<bcl::TraitUnion<Read, Write>>;
+
+/// Prints statistic of a specified scope and checks that the number of
+/// heap allocations does not exceed a specified budget and that
+/// a specified resource has been used.
+bool check(const bcl::AllocationScope &S, std::size_t Budget,
+    const bcl::CountingResource &R) {
+  auto Heap = S.stats().Allocations - R.stats().Allocations;
+  bool Ok = Heap <= Budget && R.stats().Allocations > 0;
+  std::cout << S.name() << ": " << Heap << " heap allocations, budget "
+    << Budget << ", " << R.stats().Allocations << " resource allocations"
+    << (Ok ? "" : " failed") << std::endl;
+  return Ok;
+}
+
+/// Resource which checks that each block is released with the size it has
+/// been allocated with.
+class SizeCheckingResource : public std::pmr::memory_resource {
+public:
+  /// Returns true if all released blocks had expected sizes.
+  bool isValid() const noexcept { return mIsValid; }
+
+private:
+  void * do_allocate(std::size_t Bytes, std::size_t Alignment) override {
+    auto *Ptr = std::pmr::new_delete_resource()->allocate(Bytes, Alignment);
+    mSizes[Ptr] = Bytes;
+    return Ptr;
+  }
+
+  void do_deallocate(void *Ptr, std::size_t Bytes,
+      std::size_t Alignment) override {
+    auto I = mSizes.find(Ptr);
+    mIsValid &= I != mSizes.end() && I->second == Bytes;
+    if (I != mSizes.end()) {
+      std::pmr::new_delete_resource()->deallocate(Ptr, I->second, Alignment);
+      mSizes.erase(I);
+    }
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource &Other) const noexcept override {
+    return this == &Other;
+  }
+
+  std::map<void *, std::size_t> mSizes;
+  bool mIsValid = true;
+};
+
+/// Prints result of a check.
+bool check(const char *Name, bool Ok) {
+  std::cout << Name << (Ok ? ": passed" : ": failed") << std::endl;
+  return Ok;
+}
+}
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  bool Ok = true;
+  alignas(std::max_align_t) char Buffer[1 << 16];
+  {
+    std::pmr::monotonic_buffer_resource Arena(
+      Buffer, sizeof(Buffer), std::pmr::null_memory_resource());
+    bcl::CountingResource R(&Arena);
+    bcl::AllocationScope S("push two elements to pmr::TransparentQueue");
+    int X = 0, Y = 0, Z = 0;
+    bcl::pmr::TransparentQueue<int> TQ(&R);
+    TQ.push(&X);
+    TQ.push(&Y);
+    bcl::pmr::TransparentQueue<int> Copy(TQ, &R);
+    Copy.push(&Z);
+    Ok &= check(S, 0, R);
+    Ok &= check("copy of pmr::TransparentQueue uses a specified resource",
+      Copy.get_allocator().resource() == &R && Copy.size() == 3 &&
+      TQ.pop() == &X && TQ.pop() == &Y && TQ.empty());
+  }
+  {
+    std::pmr::monotonic_buffer_resource Arena(
+      Buffer, sizeof(Buffer), std::pmr::null_memory_resource());
+    bcl::CountingResource R(&Arena);
+    bcl::AllocationScope S("insert diagnostics to Diagnostic");
+    bcl::Diagnostic D("error", &R);
+    D.insert(1, "unexpected symbol %c", 42, 'x');
+    D.insert(2, "unexpected end of file", 43);
+    Ok &= check(S, 0, R);
+    bcl::Diagnostic Heap("error");
+    Heap.insert(3, "unknown identifier", 44);
+    Heap.swap(D);
+    Ok &= check("swap diagnostics with different resources",
+      Heap.size() == 2 && D.size() == 1 && D.resource() == &R &&
+      std::string(*D.begin()) == "error C3(44): unknown identifier");
+  }
+  {
+    SizeCheckingResource R;
+    {
+      bcl::Diagnostic D("error", &R);
+      D.insert(1, "x%cyyyy", 2, 0);
+      Ok &= check("diagnostic with a null character is truncated",
+        D.size() == 1 && std::string(*D.begin()) == "error C1(2): x");
+    }
+    Ok &= check("diagnostics are released with their sizes", R.isValid());
+  }
+  {
+    std::pmr::monotonic_buffer_resource Arena(
+      Buffer, sizeof(Buffer), std::pmr::null_memory_resource());
+    bcl::CountingResource R(&Arena);
+    bcl::AllocationScope S("create pmr::marray of strings");
+    bcl::pmr::marray<std::pmr::string, 2> A({{4, 4}}, &R);
+    A[1][2] = "a string which does not fit into a small buffer";
+    Ok &= check(S, 0, R);
+    Ok &= check("elements of pmr::marray share a resource",
+      A[3][3].get_allocator().resource() == &R);
+  }
+  {
+    std::pmr::monotonic_buffer_resource Arena(
+      Buffer, sizeof(Buffer), std::pmr::null_memory_resource());
+    bcl::CountingResource R(&Arena);
+    bcl::pmr::TraitSet<AccessDescriptor> TS(AccessDescriptor{},
+      std::pmr::polymorphic_allocator<void>(&R));
+    auto W = std::make_unique<Write>();
+    auto *Description = W.get();
+    bcl::AllocationScope S("set trait in pmr::TraitSet");
+    // The set takes ownership of the description.
+    TS.set<Write>(W.release());
+    Ok &= check(S, 0, R);
+    Ok &= check("pmr::TraitSet stores a description",
+      TS.get<Write>() == Description && TS.is<Write>() && !TS.is<Read>());
+  }
+  {
+    std::pmr::monotonic_buffer_resource Arena(
+      Buffer, sizeof(Buffer), std::pmr::null_memory_resource());
+    bcl::CountingResource R(&Arena);
+    std::string JSON(R"({"first key with a long name":[1,2,3],)"
+      R"("second key with a long name":[4,5]})");
+    std::pmr::map<std::pmr::string, std::pmr::vector<int>> Map(&R);
+    bcl::AllocationScope S("parse pmr::map");
+    json::Parser<> P(JSON, "name", &R);
+    bool IsParsed = P.parse(Map);
+    // The parser copies the JSON string.
+    Ok &= check(S, 1, R);
+    Ok &= check("elements of parsed pmr::map share a resource",
+      IsParsed && Map.size() == 2 &&
+      Map.begin()->first.get_allocator().resource() == &R &&
+      Map.begin()->second.get_allocator().resource() == &R &&
+      Map.begin()->second.size() == 3 && Map.rbegin()->second.back() == 5);
+  }
+  return Ok ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+//===- base64_perf.cpp ------ Base64 Encoding Benchmark -----------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements performance benchmark for base64 encoding. The codec
+// from Base64.h is compared with a straightforward implementation which
+// processes a single character at a time and appends it to a string.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/Base64.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using TimeT = std::chrono::duration<double>;
+
+static const char Alphabet[] =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static std::string encodeByChar(const std::vector<unsigned char> &Data) {
+  std::string Res;
+  unsigned Bits = 0, Count = 0;
+  for (auto C : Data) {
+    Bits = (Bits << 8) | C;
+    Count += 8;
+    while (Count >= 6) {
+      Count -= 6;
+      Res += Alphabet[(Bits >> Count) & 0x3F];
+    }
+  }
+  if (Count > 0)
+    Res += Alphabet[(Bits << (6 - Count)) & 0x3F];
+  while (Res.size() % 4)
+    Res += '=';
+  return Res;
+}
+
+static bool decodeByChar(const std::string &Str,
+    std::vector<unsigned char> &Data) {
+  Data.clear();
+  unsigned Bits = 0, Count = 0;
+  for (auto C : Str) {
+    if (C == '=')
+      break;
+    auto *P = std::char_traits<char>::find(Alphabet, 64, C);
+    if (!P)
+      return false;
+    Bits = (Bits << 6) | static_cast<unsigned>(P - Alphabet);
+    Count += 6;
+    if (Count >= 8) {
+      Count -= 8;
+      Data.push_back(static_cast<unsigned char>(Bits >> Count));
+    }
+  }
+  return true;
+}
+
+int main(int Argc, char **Argv) {
+  std::string Help = "parameters: <number of bytes> [number of iterations]\n";
+  if (Argc < 2) {
+    std::cerr << "error: too few arguments\n" << Help;
+    return 1;
+  } else if (Argc > 3) {
+    std::cerr << "error: too many arguments\n" << Help;
+    return 2;
+  }
+  std::size_t Size = std::atoll(Argv[1]);
+  unsigned MaxIter = (Argc > 2) ? std::atoi(Argv[2]) : 10;
+  std::vector<unsigned char> Data(Size);
+  for (std::size_t I = 0; I < Size; ++I)
+    Data[I] = static_cast<unsigned char>(I * 7 + (I >> 8));
+  TimeT EncodeByChar(0), DecodeByChar(0), Encode(0), Decode(0);
+  bool Ok = true;
+  for (unsigned I = 0; I < MaxIter; ++I) {
+    auto S = std::chrono::high_resolution_clock::now();
+    auto Str = encodeByChar(Data);
+    auto E = std::chrono::high_resolution_clock::now();
+    EncodeByChar += E - S;
+    std::vector<unsigned char> Res;
+    S = std::chrono::high_resolution_clock::now();
+    Ok &= decodeByChar(Str, Res);
+    E = std::chrono::high_resolution_clock::now();
+    DecodeByChar += E - S;
+    Ok &= Res == Data;
+    S = std::chrono::high_resolution_clock::now();
+    std::string BCLStr(bcl::base64EncodedSize(Data.size()), '\0');
+    bcl::base64Encode(Data.data(), Data.size(), BCLStr.data());
+    E = std::chrono::high_resolution_clock::now();
+    Encode += E - S;
+    Ok &= BCLStr == Str;
+    S = std::chrono::high_resolution_clock::now();
+    std::vector<unsigned char> BCLRes(bcl::base64DecodedSize(BCLStr));
+    Ok &= bcl::base64Decode(BCLStr, BCLRes.data());
+    E = std::chrono::high_resolution_clock::now();
+    Decode += E - S;
+    Ok &= BCLRes == Data;
+  }
+  if (!Ok) {
+    std::cerr << "error: different results of encoding\n";
+    return 3;
+  }
+  std::cout << "Results for " << __FILE__ << " benchmark" << std::endl;
+  std::cout << "  date " << __DATE__ << std::endl;
+  std::cout << "  compiler ";
+#if defined __GNUC__
+  std::cout << "GCC " << __GNUC__;
+#elif defined __clang__
+  std::cout << "Clang " << __clang__;
+#elif defined _MSC_VER
+  std::cout << "Microsoft " << _MSC_VER;
+#else
+  std::cout << "unknown";
+#endif
+  std::cout << std::endl;
+  std::cout << "  BCL version " << BCL_VERSION_STRING << std::endl;
+  std::cout << "  number of bytes " << Size << std::endl;
+  std::cout << "  number of iterations " << MaxIter << std::endl;
+  std::map<double, std::string> Time;
+  std::cout << std::endl;
+  Time.emplace(EncodeByChar.count(), "encode by character time (.s) ");
+  Time.emplace(DecodeByChar.count(), "decode by character time (.s) ");
+  Time.emplace(Encode.count(), "bcl::base64Encode() time (.s) ");
+  Time.emplace(Decode.count(), "bcl::base64Decode() time (.s) ");
+  for (auto &T : Time)
+    std::cout << T.second << T.first << std::endl;
+  return 0;
+}
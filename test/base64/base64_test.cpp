@@ -0,0 +1,97 @@
+//===- base64_test.cpp ------- Base64 Encoding Test ---------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for base64 encoding and for JSON representation
+// of binary data.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/Base64.h>
+#include <bcl/Json.h>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+static bool check(const char *Title, bool Ok) {
+  std::cout << Title << (Ok ? ": passed" : ": failed") << std::endl;
+  return Ok;
+}
+
+static std::string encode(std::string_view Data) {
+  std::string Res(bcl::base64EncodedSize(Data.size()), '\0');
+  bcl::base64Encode(Data.data(), Data.size(), Res.data());
+  return Res;
+}
+
+/// Decodes a specified string, returns "<invalid>" if it is not a valid
+/// encoding.
+static std::string decode(std::string_view Str) {
+  std::string Res(bcl::base64DecodedSize(Str), '\0');
+  return bcl::base64Decode(Str, Res.data()) ? Res : "<invalid>";
+}
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  bool Ok = true;
+  // Test vectors from RFC 4648.
+  const char *Vectors[][2] = {
+    { "", "" }, { "f", "Zg==" }, { "fo", "Zm8=" }, { "foo", "Zm9v" },
+    { "foob", "Zm9vYg==" }, { "fooba", "Zm9vYmE=" }, { "foobar", "Zm9vYmFy" }
+  };
+  bool VectorsOk = true;
+  for (auto &V : Vectors)
+    VectorsOk &= encode(V[0]) == V[1] && decode(V[1]) == V[0];
+  Ok &= check("RFC 4648 test vectors", VectorsOk);
+  Ok &= check("decode without padding",
+    decode("Zg") == "f" && decode("Zm8") == "fo" && decode("Zm9vYg") == "foob");
+  Ok &= check("reject invalid encoding",
+    decode("Zm9v!") == "<invalid>" && decode("Z") == "<invalid>" &&
+    decode("Zm9=") == "fo" && decode("Zm=") == "<invalid>" &&
+    decode("Zm 9v") == "<invalid>");
+  {
+    std::string All;
+    for (unsigned I = 0; I < 256 * 3; ++I)
+      All += static_cast<char>(I * 7);
+    Ok &= check("encode all bytes", decode(encode(All)) == All);
+  }
+  {
+    bcl::bytes B("\0\1\2\xff", 4);
+    auto JSON = json::Parser<>::unparse(B);
+    bcl::bytes Parsed;
+    std::vector<std::uint8_t> U;
+    json::Parser<> P(JSON);
+    Ok &= check("unparse bytes", JSON == R"j("AAEC/w==")j" &&
+      P.parse(Parsed) && Parsed == B &&
+      json::Parser<>(R"j("AAEC\/w==")j").parse(U) && U.size() == 4 &&
+      U[3] == 0xff);
+  }
+  {
+    json::Parser<> P(R"j({"0":"Zm9v", "1":"Zm9v!"})j");
+    std::vector<std::vector<std::byte>> V;
+    Ok &= check("reject invalid bytes", !P.parse(V) &&
+      !P.errorRecords().empty() &&
+      P.errorRecords().front().Code == json::Error::ILLEGAL_VALUE &&
+      P.errorRecords().front().Pos == 17);
+  }
+  return Ok ? 0 : 1;
+}
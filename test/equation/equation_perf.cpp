@@ -0,0 +1,152 @@
+//===- equation_perf.cpp ----- Binomial System Benchmark ----------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2020 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements performance benchmark for solvers of binomial systems.
+// A large number of small systems is solved one by one with
+// milp::BinomialSystem and at once with milp::BinomialBatch.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/Equation.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using TimeT = std::chrono::duration<double>;
+
+using System = milp::BinomialSystem<int, long, 0, 0, 0>;
+using Batch = milp::BinomialBatch<int, long>;
+
+struct ColumnInfo {
+  template<class T> T get(int) const { return T(); }
+  int parameterColumn() { return mNextParameter++; }
+  int parameterColumn(int) { return mNextParameter++; }
+  bool isParameter(int C) const { return C >= 1000; }
+  std::string name(int C) const { return std::to_string(C); }
+
+private:
+  int mNextParameter = 1000;
+};
+
+struct Equation {
+  int X;
+  long A;
+  int Y;
+  long B;
+  long C;
+};
+
+/// Generates systems which are satisfied by a random assignment of variables.
+static std::vector<std::vector<Equation>> generate(std::size_t N) {
+  unsigned long Seed = 12345;
+  auto next = [&Seed](long Range) {
+    Seed = Seed * 6364136223846793005UL + 1442695040888963407UL;
+    return static_cast<long>((Seed >> 33) % Range);
+  };
+  std::vector<std::vector<Equation>> Systems(N);
+  for (auto &Equations : Systems) {
+    long Values[16];
+    for (auto &V : Values)
+      V = next(201) - 100;
+    for (long R = 0, ER = next(8) + 1; R < ER; ++R) {
+      int X = static_cast<int>(next(16)), Y = static_cast<int>(next(16));
+      long A = next(19) - 9, B = next(19) - 9;
+      A = A != 0 ? A : 1;
+      B = B != 0 ? B : -1;
+      Equations.push_back({X, A, Y, B, A * Values[X] + B * Values[Y]});
+    }
+  }
+  return Systems;
+}
+
+int main(int Argc, char **Argv) {
+  std::string Help = "parameters: <number of systems> [number of iterations]\n";
+  if (Argc < 2) {
+    std::cerr << "error: too few arguments\n" << Help;
+    return 1;
+  } else if (Argc > 3) {
+    std::cerr << "error: too many arguments\n" << Help;
+    return 2;
+  }
+  std::size_t Size = std::atoll(Argv[1]);
+  unsigned MaxIter = (Argc > 2) ? std::atoi(Argv[2]) : 10;
+  auto Systems = generate(Size);
+  TimeT SystemTime(0), BatchTime(0);
+  bool Ok = true;
+  Batch B;
+  for (unsigned I = 0; I < MaxIter; ++I) {
+    std::size_t NumSolved = 0;
+    auto S = std::chrono::high_resolution_clock::now();
+    for (auto &Equations : Systems) {
+      System Sys;
+      for (auto &E : Equations)
+        Sys.push_back({E.X, E.A}, {E.Y, E.B}, E.C);
+      ColumnInfo Info;
+      Sys.instantiate(Info);
+      NumSolved += Sys.solve<ColumnInfo, false>(Info) == Equations.size();
+    }
+    auto E = std::chrono::high_resolution_clock::now();
+    SystemTime += E - S;
+    Ok &= NumSolved == Size;
+    S = std::chrono::high_resolution_clock::now();
+    B.clear();
+    B.reserve(Size);
+    for (auto &Equations : Systems) {
+      B.addSystem();
+      for (auto &E : Equations)
+        B.push_back({E.X, E.A}, {E.Y, E.B}, E.C);
+    }
+    NumSolved = B.solve();
+    E = std::chrono::high_resolution_clock::now();
+    BatchTime += E - S;
+    Ok &= NumSolved == Size;
+  }
+  if (!Ok) {
+    std::cerr << "error: some systems have not been solved\n";
+    return 3;
+  }
+  std::cout << "Results for " << __FILE__ << " benchmark" << std::endl;
+  std::cout << "  date " << __DATE__ << std::endl;
+  std::cout << "  compiler ";
+#if defined __GNUC__
+  std::cout << "GCC " << __GNUC__;
+#elif defined __clang__
+  std::cout << "Clang " << __clang__;
+#elif defined _MSC_VER
+  std::cout << "Microsoft " << _MSC_VER;
+#else
+  std::cout << "unknown";
+#endif
+  std::cout << std::endl;
+  std::cout << "  BCL version " << BCL_VERSION_STRING << std::endl;
+  std::cout << "  number of systems " << Size << std::endl;
+  std::cout << "  number of iterations " << MaxIter << std::endl;
+  std::map<double, std::string> Time;
+  std::cout << std::endl;
+  Time.emplace(SystemTime.count(), "milp::BinomialSystem time (.s) ");
+  Time.emplace(BatchTime.count(), "milp::BinomialBatch time (.s) ");
+  for (auto &T : Time)
+    std::cout << T.second << T.first << std::endl;
+  return 0;
+}
@@ -0,0 +1,365 @@
+//===- equation_test.cpp ---- Binomial System Test ----------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2020 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for milp::BinomialSystem, milp::BinomialBatch
+// and milp::SolutionProgram.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/Equation.h>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using System = milp::BinomialSystem<int, long, 0, 0, 0>;
+using Batch = milp::BinomialBatch<int, long, 4>;
+
+/// Variables are numbers less than FirstParameter, parameters are allocated
+/// after them.
+struct ColumnInfo {
+  static constexpr int FirstParameter = 1000;
+
+  template<class T> T get(int) const { return T(); }
+  int parameterColumn() { return mNextParameter++; }
+  int parameterColumn(int) { return mNextParameter++; }
+  bool isParameter(int C) const { return C >= FirstParameter; }
+  std::string name(int C) const {
+    return (isParameter(C) ? "t" : "x") + std::to_string(C);
+  }
+
+private:
+  int mNextParameter = FirstParameter;
+};
+
+struct Equation {
+  int X;
+  long A;
+  int Y;
+  long B;
+  long C;
+};
+
+static bool check(const char *Title, bool Ok) {
+  std::cout << Title << (Ok ? ": passed" : ": failed") << std::endl;
+  return Ok;
+}
+
+/// Returns variables which have non-zero coefficient in at least one of
+/// specified equations after monomials with the same variable are merged.
+static std::set<int> constrained(const std::vector<Equation> &Equations) {
+  std::set<int> Variables;
+  for (auto &E : Equations) {
+    if (E.X == E.Y) {
+      if (E.A + E.B != 0)
+        Variables.insert(E.X);
+      continue;
+    }
+    if (E.A != 0)
+      Variables.insert(E.X);
+    if (E.B != 0)
+      Variables.insert(E.Y);
+  }
+  return Variables;
+}
+
+/// Solves a specified system and checks that the solution satisfies all
+/// equations for several values of parameters. The solution must contain
+/// constrained variables only, each of them exactly once.
+static bool checkSolution(const std::vector<Equation> &Equations,
+    std::size_t &NumSolutions,
+    milp::PivotOrder Order = milp::PivotOrder::Natural) {
+  System S;
+  for (auto &E : Equations)
+    S.push_back({E.X, E.A}, {E.Y, E.B}, E.C);
+  S.setPivotOrder(Order);
+  ColumnInfo Info;
+  S.instantiate(Info);
+  if (S.solve<ColumnInfo, false>(Info) != Equations.size())
+    return false;
+  NumSolutions = S.getSolution().size();
+  std::set<int> Solved;
+  for (auto &Solution : S.getSolution())
+    if (Info.isParameter(Solution.LHS.Column) ||
+        !Solved.insert(Solution.LHS.Column).second)
+      return false;
+  if (Solved != constrained(Equations))
+    return false;
+  for (long T = -3; T <= 3; ++T) {
+    // x + b * t = c
+    std::map<int, long> Values;
+    for (auto &Solution : S.getSolution())
+      Values[Solution.LHS.Column] =
+        Solution.Constant - Solution.RHS.Value * (T + Solution.RHS.Column);
+    // Unconstrained variables (for example, x in x - x = 0) do not have
+    // solutions, any value fits them, so zero is used.
+    for (auto &E : Equations)
+      if (E.A * Values[E.X] + E.B * Values[E.Y] != E.C)
+        return false;
+  }
+  return true;
+}
+
+/// Returns true if a specified system has no solution.
+static bool checkInfeasible(const std::vector<Equation> &Equations) {
+  System S;
+  for (auto &E : Equations)
+    S.push_back({E.X, E.A}, {E.Y, E.B}, E.C);
+  ColumnInfo Info;
+  S.instantiate(Info);
+  return S.solve<ColumnInfo, false>(Info) < Equations.size();
+}
+
+/// Solves a batch of specified systems and checks that each solution
+/// satisfies all equations in its system for several values of parameters.
+/// Systems which are marked as infeasible must not be solved.
+static bool checkBatch(const std::vector<std::vector<Equation>> &Systems,
+    const std::vector<bool> &IsFeasible) {
+  Batch B;
+  B.reserve(Systems.size());
+  for (auto &Equations : Systems) {
+    B.addSystem();
+    for (auto &E : Equations)
+      B.push_back({E.X, E.A}, {E.Y, E.B}, E.C);
+  }
+  std::size_t NumFeasible = 0;
+  for (bool F : IsFeasible)
+    NumFeasible += F;
+  if (B.solve() != NumFeasible)
+    return false;
+  for (std::size_t S = 0; S < Systems.size(); ++S) {
+    if (B.isSolved(S) != IsFeasible[S])
+      return false;
+    if (!IsFeasible[S])
+      continue;
+    std::set<int> Solved;
+    for (auto I = B.solution_begin(S), EI = B.solution_end(S); I != EI; ++I)
+      if (!Solved.insert(B.column(S, I->LHS.Column)).second)
+        return false;
+    if (Solved != constrained(Systems[S]))
+      return false;
+    for (long T = -3; T <= 3; ++T) {
+      // x + b * t = c
+      std::map<int, long> Values;
+      for (auto I = B.solution_begin(S), EI = B.solution_end(S); I != EI; ++I) {
+        if (Batch::isParameter(I->LHS.Column) ||
+            !Batch::isParameter(I->RHS.Column))
+          return false;
+        Values[B.column(S, I->LHS.Column)] =
+          I->Constant - I->RHS.Value * (T + I->RHS.Column);
+      }
+      // Unconstrained variables do not have solutions, zero is used.
+      for (auto &E : Systems[S])
+        if (E.A * Values[E.X] + E.B * Values[E.Y] != E.C)
+          return false;
+    }
+  }
+  return true;
+}
+
+/// Solves a specified system with each pivot order.
+static bool checkPivotOrders(const std::vector<Equation> &Equations) {
+  std::size_t NumSolutions = 0, NumMinDegree = 0, NumSmallest = 0;
+  return checkSolution(Equations, NumSolutions) &&
+    checkSolution(Equations, NumMinDegree, milp::PivotOrder::MinDegree) &&
+    checkSolution(Equations, NumSmallest,
+      milp::PivotOrder::SmallestCoefficient) &&
+    NumSolutions == NumMinDegree && NumSolutions == NumSmallest;
+}
+
+/// Solves a chain 3 * x[I] + 2 * x[I + 1] = 5 with a specified pivot order.
+static System::Stats solveChain(milp::PivotOrder Order) {
+  System S;
+  for (int I = 1; I < 12; ++I)
+    S.push_back({I, 3}, {I + 1, 2}, 5);
+  S.setPivotOrder(Order);
+  ColumnInfo Info;
+  S.instantiate(Info);
+  S.solve<ColumnInfo, false>(Info);
+  return S.getStats();
+}
+
+/// Compiles solution of a specified system and checks that it satisfies all
+/// equations at each point of a grid and at a vector of points.
+static bool checkProgram(const std::vector<Equation> &Equations) {
+  System S;
+  for (auto &E : Equations)
+    S.push_back({E.X, E.A}, {E.Y, E.B}, E.C);
+  ColumnInfo Info;
+  S.instantiate(Info);
+  if (S.solve<ColumnInfo, false>(Info) != Equations.size())
+    return false;
+  milp::SolutionProgram<int, long> P(S.getSolution());
+  auto NumParams = P.parameters().size();
+  auto NumTargets = P.targets().size();
+  std::vector<long> Lower(NumParams, -2), Upper(NumParams, 2);
+  auto N = P.gridSize(Lower.data(), Upper.data());
+  std::vector<long> Out(NumTargets * N);
+  if (P.evaluateGrid(Lower.data(), Upper.data(), Out.data()) != N)
+    return false;
+  auto checkPoint = [&Equations, &P, &Out](std::size_t J, std::size_t Size) {
+    std::map<int, long> Values;
+    for (std::size_t I = 0; I < P.targets().size(); ++I)
+      Values[P.targets()[I]] = Out[I * Size + J];
+    for (auto &E : Equations)
+      if (E.A * Values[E.X] + E.B * Values[E.Y] != E.C)
+        return false;
+    return true;
+  };
+  // Each parameter has non-zero coefficient, so all points are different.
+  std::set<std::vector<long>> Points;
+  for (std::size_t J = 0; J < N; ++J) {
+    if (!checkPoint(J, N))
+      return false;
+    std::vector<long> Point(NumTargets);
+    for (std::size_t I = 0; I < NumTargets; ++I)
+      Point[I] = Out[I * N + J];
+    Points.insert(Point);
+  }
+  if (Points.size() != N)
+    return false;
+  N = 100;
+  std::vector<long> Params(NumParams * N);
+  for (std::size_t I = 0; I < Params.size(); ++I)
+    Params[I] = static_cast<long>(I % 7) - 3;
+  Out.assign(NumTargets * N, 0);
+  P.evaluate(Params.data(), N, Out.data());
+  for (std::size_t J = 0; J < N; ++J)
+    if (!checkPoint(J, N))
+      return false;
+  return true;
+}
+
+/// Generates systems which are satisfied by a random assignment of variables.
+static std::vector<std::vector<Equation>> generate(std::size_t N) {
+  unsigned long Seed = 12345;
+  auto next = [&Seed](long Range) {
+    Seed = Seed * 6364136223846793005UL + 1442695040888963407UL;
+    return static_cast<long>((Seed >> 33) % Range);
+  };
+  std::vector<std::vector<Equation>> Systems(N);
+  for (auto &Equations : Systems) {
+    long Values[8];
+    for (auto &V : Values)
+      V = next(21) - 10;
+    for (long R = 0, ER = next(4) + 1; R < ER; ++R) {
+      int X = static_cast<int>(next(8)), Y = static_cast<int>(next(8));
+      long A = next(9) - 4, B = next(9) - 4;
+      A = A != 0 ? A : 1;
+      B = B != 0 ? B : -1;
+      Equations.push_back({X, A, Y, B, A * Values[X] + B * Values[Y]});
+    }
+  }
+  return Systems;
+}
+
+int main() {
+  bool Ok = true;
+  std::size_t NumSolutions = 0;
+  Ok &= check("binomial equations", checkSolution({
+    {1, 2, 2, 3, 7},
+    {2, 1, 3, -1, 4}}, NumSolutions) && NumSolutions == 3);
+  Ok &= check("duplicates and multiples", checkSolution({
+    {1, 2, 2, 4, 6},
+    {2, 2, 1, 1, 3},
+    {1, -3, 2, -6, -9},
+    {1, 1, 2, 2, 3}}, NumSolutions) && NumSolutions == 2);
+  Ok &= check("variables with known values", checkSolution({
+    {1, 3, 2, 1, 8},
+    {1, 2, 3, 0, 4},
+    {3, 5, 2, 1, 7},
+    {2, 1, 2, 1, 4}}, NumSolutions) && NumSolutions == 3);
+  Ok &= check("single equation without presolve",
+    checkSolution({{1, 2, 2, 0, 4}}, NumSolutions) && NumSolutions == 1 &&
+    checkSolution({{1, 2, 2, 3, 7}}, NumSolutions) && NumSolutions == 2 &&
+    checkSolution({{1, 2, 1, -2, 0}}, NumSolutions) && NumSolutions == 0);
+  Ok &= check("unconstrained variables", checkSolution({
+    {1, 1, 2, 0, 3},
+    {3, 1, 3, -1, 0},
+    {1, 2, 4, 1, 6}}, NumSolutions) && NumSolutions == 2);
+  Ok &= check("constant is not divisible by GCD",
+    checkInfeasible({{1, 2, 2, 4, 5}}));
+  Ok &= check("inconsistent multiples",
+    checkInfeasible({{1, 1, 2, 2, 3}, {1, 2, 2, 4, 7}}));
+  Ok &= check("inconsistent known values",
+    checkInfeasible({{1, 2, 2, 0, 4}, {1, 3, 3, 0, 9}}));
+  Ok &= check("inconsistent substitution",
+    checkInfeasible({{1, 1, 2, 0, 1}, {2, 1, 2, 0, 2}, {1, 1, 2, 1, 4}}));
+  Ok &= check("batch of systems", checkBatch({
+    {{1, 2, 2, 3, 7}, {2, 1, 3, -1, 4}},
+    {{1, 2, 2, 4, 5}},
+    {{1, 1, 2, 1, 1}, {1, 1, 2, -1, 3}},
+    {{1, 3, 2, 1, 8}, {1, 2, 3, 0, 4}, {3, 5, 2, 1, 7}, {2, 1, 2, 1, 4}},
+    {{1, 1, 2, 2, 3}, {1, 2, 2, 4, 7}},
+    {{1, 1, 1, -1, 0}},
+    {{1, 1, 1, -1, 2}}},
+    {true, false, true, true, false, true, false}));
+  {
+    auto Systems = generate(1000);
+    bool IsOrdered = true;
+    for (auto &Equations : Systems)
+      IsOrdered &= checkPivotOrders(Equations);
+    Ok &= check("pivot orders", IsOrdered);
+    bool IsCompiled = true;
+    for (std::size_t I = 0; I < 100; ++I)
+      IsCompiled &= checkProgram(Systems[I]);
+    Ok &= check("compiled solution", IsCompiled && checkProgram({
+      {1, 2, 2, 3, 7},
+      {3, 1, 4, -1, 4}}));
+    Ok &= check("batch of generated systems",
+      checkBatch(Systems, std::vector<bool>(Systems.size(), true)));
+  }
+  {
+    Batch B;
+    B.addSystem();
+    B.push_back({1, 2}, {2, 3}, 7);
+    B.solve();
+    Batch Moved(std::move(B));
+    B.clear();
+    B.addSystem();
+    B.push_back({1, 1}, {2, 0}, 3);
+    Ok &= check("reuse moved-from batch", B.solve() == 1 && B.isSolved(0) &&
+      Moved.isSolved(0) && Moved.solution_begin(0) != Moved.solution_end(0));
+  }
+  {
+    // -x1 + 2 * t = 3, so x1 = 2 * t - 3.
+    std::vector<milp::BAEquation<int, long>> Solution;
+    Solution.emplace_back(1, -1, ColumnInfo::FirstParameter, 2, 3);
+    milp::SolutionProgram<int, long> P(Solution);
+    long Params[] = {-1, 0, 4}, Out[3];
+    P.evaluate(Params, 3, Out);
+    Ok &= check("compiled solution with negative coefficient",
+      Out[0] == -5 && Out[1] == -3 && Out[2] == 5);
+  }
+  {
+    auto Natural = solveChain(milp::PivotOrder::Natural);
+    auto Smallest = solveChain(milp::PivotOrder::SmallestCoefficient);
+    Ok &= check("coefficient statistics",
+      Natural.NumPivots == 11 && Smallest.NumPivots == 11 &&
+      Natural.MaxInitialMagnitude == 5 && Smallest.MaxInitialMagnitude == 5 &&
+      Natural.NumOverflows > 0 && Smallest.NumOverflows == 0 &&
+      Smallest.NumUpdates < Natural.NumUpdates &&
+      Smallest.MaxMagnitude < Natural.MaxMagnitude);
+  }
+  return Ok ? 0 : 1;
+}
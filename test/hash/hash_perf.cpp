@@ -0,0 +1,161 @@
+//===- hash_perf.cpp --------- Hash and Equality Benchmark --------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements performance benchmark for std::hash specialization
+// and equality operators of bcl::StaticMap. Lookups in a hash set are
+// compared with lookups which use functors which visit each cell of a map
+// through type-erased calls.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/cell.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using TimeT = std::chrono::duration<double>;
+
+struct Id { typedef std::uint32_t ValueType; };
+struct Kind { typedef std::uint32_t ValueType; };
+struct Offset { typedef std::uint64_t ValueType; };
+struct Size { typedef std::uint64_t ValueType; };
+struct Line { typedef std::uint32_t ValueType; };
+struct Column { typedef std::uint32_t ValueType; };
+
+using Record = bcl::StaticMap<Id, Kind, Offset, Size, Line, Column>;
+
+/// Computes a hash value of a record visiting each cell, values are hashed
+/// through a type-erased function.
+struct ForEachHash {
+  std::size_t operator()(const Record &R) const {
+    std::size_t Seed = 0;
+    std::function<void(std::size_t)> Combine = [&Seed](std::size_t H) {
+      Seed ^= H + 0x9e3779b9 + (Seed << 6) + (Seed >> 2);
+    };
+    R.for_each([&Combine](auto *C) {
+      using CellT = typename std::remove_pointer<decltype(C)>::type;
+      using KeyT = typename CellT::CellKey;
+      Combine(std::hash<typename KeyT::ValueType>()(
+        C->template value<KeyT>()));
+    });
+    return Seed;
+  }
+};
+
+/// Compares records visiting each cell, values are compared through
+/// a type-erased function.
+struct ForEachEqual {
+  bool operator()(const Record &LHS, const Record &RHS) const {
+    bool IsEqual = true;
+    std::function<void(bool)> Join = [&IsEqual](bool V) { IsEqual &= V; };
+    LHS.for_each([&Join, &RHS](auto *C) {
+      using CellT = typename std::remove_pointer<decltype(C)>::type;
+      using KeyT = typename CellT::CellKey;
+      Join(C->template value<KeyT>() == RHS.template value<KeyT>());
+    });
+    return IsEqual;
+  }
+};
+
+static Record makeRecord(std::size_t I) {
+  return Record(static_cast<std::uint32_t>(I % 1000),
+    static_cast<std::uint32_t>(I % 7), std::uint64_t(I * 16),
+    std::uint64_t(I % 64), static_cast<std::uint32_t>(I / 80),
+    static_cast<std::uint32_t>(I % 80));
+}
+
+/// Looks up each record from a list of queries in a set which contains
+/// records from Data.
+template<class HashT, class EqualT>
+TimeT lookupTime(const std::vector<Record> &Data,
+    const std::vector<Record> &Queries, std::size_t &Found) {
+  std::unordered_set<Record, HashT, EqualT> Set(Data.begin(), Data.end());
+  auto S = std::chrono::high_resolution_clock::now();
+  for (auto &Q : Queries)
+    Found += Set.count(Q);
+  auto E = std::chrono::high_resolution_clock::now();
+  return E - S;
+}
+
+int main(int Argc, char **Argv) {
+  std::string Help = "parameters: <number of records> [number of iterations]\n";
+  if (Argc < 2) {
+    std::cerr << "error: too few arguments\n" << Help;
+    return 1;
+  } else if (Argc > 3) {
+    std::cerr << "error: too many arguments\n" << Help;
+    return 2;
+  }
+  std::size_t Size = std::atoll(Argv[1]);
+  unsigned MaxIter = (Argc > 2) ? std::atoi(Argv[2]) : 10;
+  std::vector<Record> Data, Queries;
+  for (std::size_t I = 0; I < Size; ++I)
+    Data.push_back(makeRecord(I));
+  // A half of queries is not found, queries are shuffled to avoid
+  // dependence on order of records in a hash table.
+  for (std::size_t I = 0; I < Size * 2; ++I)
+    Queries.push_back(makeRecord(I));
+  std::shuffle(Queries.begin(), Queries.end(), std::mt19937_64(Size));
+  TimeT ForEach(0), Std(0);
+  std::size_t ForEachFound = 0, StdFound = 0;
+  for (unsigned I = 0; I < MaxIter; ++I) {
+    ForEach += lookupTime<ForEachHash, ForEachEqual>(
+      Data, Queries, ForEachFound);
+    Std += lookupTime<std::hash<Record>, std::equal_to<Record>>(
+      Data, Queries, StdFound);
+  }
+  if (ForEachFound != StdFound) {
+    std::cerr << "error: different number of found records\n";
+    return 3;
+  }
+  std::cout << "Results for " << __FILE__ << " benchmark" << std::endl;
+  std::cout << "  date " << __DATE__ << std::endl;
+  std::cout << "  compiler ";
+#if defined __GNUC__
+  std::cout << "GCC " << __GNUC__;
+#elif defined __clang__
+  std::cout << "Clang " << __clang__;
+#elif defined _MSC_VER
+  std::cout << "Microsoft " << _MSC_VER;
+#else
+  std::cout << "unknown";
+#endif
+  std::cout << std::endl;
+  std::cout << "  BCL version " << BCL_VERSION_STRING << std::endl;
+  std::cout << "  number of records " << Size << std::endl;
+  std::cout << "  size of record " << sizeof(Record) << std::endl;
+  std::cout << "  number of iterations " << MaxIter << std::endl;
+  std::map<double, std::string> Time;
+  std::cout << std::endl;
+  Time.emplace(ForEach.count(), "for_each() based functors time (.s) ");
+  Time.emplace(Std.count(), "std::hash and operator== time (.s) ");
+  for (auto &T : Time)
+    std::cout << T.second << T.first << std::endl;
+  return 0;
+}
@@ -0,0 +1,112 @@
+//===- hash_test.cpp --------- Hash and Equality Test -------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for std::hash specializations and equality
+// operators of bcl::StaticMap, bcl::StaticTypeMap, bcl::tagged_pair and
+// bcl::tagged_tuple.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/cell.h>
+#include <bcl/tagged.h>
+#include <bcl/utility.h>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+
+struct Name { typedef std::string ValueType; };
+struct Id { typedef std::uint32_t ValueType; };
+struct Kind { typedef std::uint32_t ValueType; };
+struct Flag { typedef char ValueType; };
+struct Weight { typedef std::uint64_t ValueType; };
+
+using Key = bcl::StaticMap<Id, Kind, Weight>;
+using Padded = bcl::StaticMap<Flag, Weight>;
+using Named = bcl::StaticMap<Name, Id>;
+
+static_assert(bcl::is_bitwise_comparable<Key>::value,
+  "Map without padding must be bitwise comparable!");
+static_assert(!bcl::is_bitwise_comparable<Padded>::value,
+  "Map with padding must not be bitwise comparable!");
+static_assert(!bcl::is_bitwise_comparable<Named>::value,
+  "Map with std::string must not be bitwise comparable!");
+static_assert(bcl::is_bitwise_comparable<
+  bcl::StaticTypeMap<std::uint32_t, std::int32_t>>::value,
+  "Type map without padding must be bitwise comparable!");
+static_assert(bcl::is_bitwise_comparable<
+  bcl::tagged_pair<bcl::tagged<int, Id>, bcl::tagged<int, Kind>>>::value,
+  "Pair without padding must be bitwise comparable!");
+static_assert(!bcl::is_bitwise_comparable<
+  bcl::tagged_tuple<bcl::tagged<int, Id>, bcl::tagged<double, Weight>>>::value,
+  "Tuple with floating-point values must not be bitwise comparable!");
+
+static bool check(const char *Title, bool Ok) {
+  std::cout << Title << (Ok ? ": passed" : ": failed") << std::endl;
+  return Ok;
+}
+
+/// Checks that equal values have equal hashes, that different values are not
+/// equal, and that a hash set distinguishes values.
+template<class T> bool checkSet(const char *Title, const T &V1, const T &V2) {
+  std::hash<T> H;
+  T Copy(V1);
+  std::unordered_set<T> Set{ V1, V2, Copy };
+  return check(Title, V1 == Copy && !(V1 != Copy) && V1 != V2 &&
+    H(V1) == H(Copy) && Set.size() == 2 && Set.count(V2) == 1);
+}
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  bool Ok = true;
+  Ok &= checkSet("bitwise comparable bcl::StaticMap",
+    Key(1u, 2u, std::uint64_t(3)), Key(1u, 2u, std::uint64_t(4)));
+  Padded P1, P2;
+  P1[Flag()] = 'a'; P1[Weight()] = 1;
+  P2[Flag()] = 'a'; P2[Weight()] = 2;
+  Ok &= checkSet("bcl::StaticMap with padding", P1, P2);
+  Ok &= checkSet("bcl::StaticMap with std::string",
+    Named(std::string("Jon"), 1u), Named(std::string("Ann"), 1u));
+  bcl::StaticTypeMap<std::uint32_t, std::string> T1, T2;
+  T1.value<std::uint32_t>() = T2.value<std::uint32_t>() = 1;
+  T1.value<std::string>() = "a";
+  T2.value<std::string>() = "b";
+  Ok &= checkSet("bcl::StaticTypeMap", T1, T2);
+  using Pair = bcl::tagged_pair<bcl::tagged<int, Id>, bcl::tagged<int, Kind>>;
+  Ok &= checkSet("bcl::tagged_pair", Pair(1, 2), Pair(2, 1));
+  using Tuple = bcl::tagged_tuple<
+    bcl::tagged<std::string, Name>, bcl::tagged<double, Weight>>;
+  Ok &= checkSet("bcl::tagged_tuple",
+    Tuple(std::string("a"), 0.5), Tuple(std::string("a"), 1.5));
+  // Bytes of all words must affect a hash value.
+  unsigned char Bytes[100] = {};
+  auto Base = bcl::hash_bytes(Bytes, sizeof(Bytes));
+  bool Distinct = true;
+  for (std::size_t I = 0; I < sizeof(Bytes); ++I) {
+    Bytes[I] = 1;
+    Distinct &= bcl::hash_bytes(Bytes, sizeof(Bytes)) != Base;
+    Distinct &= bcl::hash_bytes(Bytes, I, 1) != bcl::hash_bytes(Bytes, I, 2);
+    Bytes[I] = 0;
+  }
+  Ok &= check("bcl::hash_bytes", Distinct &&
+    bcl::hash_bytes(Bytes, 10) != bcl::hash_bytes(Bytes, 11));
+  return Ok ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+//===- iterator_test.cpp ---- Iterator Data Adaptor Test ----------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for bcl::IteratorDataAdaptor.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/IteratorDataAdaptor.h>
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Value which is constructed from an element and a scale factor.
+struct Scaled {
+  Scaled(int V, int Factor) : Value(V * Factor) {}
+  int Value;
+};
+
+/// Tag which is stronger than std::random_access_iterator_tag, like
+/// std::contiguous_iterator_tag in C++ 20.
+struct ContiguousTag : public std::random_access_iterator_tag {};
+
+/// Pointer which reports a contiguous iterator concept.
+struct ContiguousItr {
+  using iterator_category = std::random_access_iterator_tag;
+  using iterator_concept = ContiguousTag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = int;
+  using pointer = const int *;
+  using reference = const int &;
+};
+
+using VectorAdaptor = bcl::IteratorDataAdaptor<
+  std::vector<int>::const_iterator, int, Scaled>;
+using ListAdaptor = bcl::IteratorDataAdaptor<
+  std::list<int>::const_iterator, int, Scaled>;
+using ContiguousAdaptor = bcl::IteratorDataAdaptor<ContiguousItr, int, Scaled>;
+
+static_assert(std::is_same<std::iterator_traits<VectorAdaptor>::pointer,
+  decltype(std::declval<const VectorAdaptor &>().operator->())>::value,
+  "Type of a pointer must be a type of operator->()!");
+static_assert(std::is_same<VectorAdaptor::iterator_category,
+  std::random_access_iterator_tag>::value,
+  "Adaptor of a vector iterator must be random access!");
+static_assert(std::is_same<VectorAdaptor::iterator_concept,
+  std::random_access_iterator_tag>::value,
+  "Adaptor of a vector iterator must be random access!");
+static_assert(std::is_same<ListAdaptor::iterator_concept,
+  std::bidirectional_iterator_tag>::value,
+  "Adaptor of a list iterator must be bidirectional!");
+static_assert(std::is_same<ContiguousAdaptor::iterator_concept,
+  std::random_access_iterator_tag>::value,
+  "Adaptor must not be stronger than a random access iterator!");
+
+bool check(const char *Title, bool Ok) {
+  std::cout << Title << ": " << (Ok ? "passed" : "failed") << std::endl;
+  return Ok;
+}
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  const std::vector<int> Values{1, 3, 5, 7, 9};
+  VectorAdaptor Begin(Values.begin(), 10), End(Values.end(), 10);
+  bool Ok = check("dereference", (*Begin).Value == 10 &&
+    Begin->Value == 10 && Begin[3].Value == 70);
+  auto I = Begin;
+  I += 3;
+  bool Arithmetic = I->Value == 70 && (I - 2)->Value == 30 &&
+    (1 + I)->Value == 90 && (I + 1)->Value == 90 && I - Begin == 3 &&
+    End - Begin == 5;
+  I -= 2;
+  Arithmetic &= I->Value == 30 && (I--)->Value == 30 && I == Begin &&
+    (++I)->Value == 30 && (--I)->Value == 10;
+  Ok &= check("arithmetic", Arithmetic);
+  Ok &= check("comparison", Begin < End && End > Begin && Begin <= Begin &&
+    Begin >= Begin && !(End <= Begin) && !(Begin >= End) &&
+    Begin != End && Begin + 5 == End &&
+    VectorAdaptor(Values.begin(), 10) != VectorAdaptor(Values.begin(), 1));
+  Ok &= check("random access algorithms",
+    std::distance(Begin, End) == 5 &&
+    std::lower_bound(Begin, End, 70, [](const Scaled &V, int X) {
+      return V.Value < X; }) == Begin + 3);
+  const std::list<int> List{1, 2, 3};
+  ListAdaptor ListEnd(List.end(), 2);
+  Ok &= check("bidirectional iterator",
+    (--ListEnd)->Value == 6 && (ListEnd--)->Value == 6 &&
+    ListEnd->Value == 4 &&
+    std::distance(ListAdaptor(List.begin(), 2), ListAdaptor(List.end(), 2)) ==
+      3);
+  return Ok ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+//===- json_literal_test.cpp ---- JSON Literal Test ---------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for json::Literal. Most checks are performed at
+// compile time.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/JsonLiteral.h>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+enum class Mode { Fast, Safe };
+JSON_ENUM_TRAITS(::, Mode, {Mode::Fast, "fast"}, {Mode::Safe, "safe"})
+
+struct Endpoint {
+  std::string_view Host;
+  unsigned Port;
+};
+
+namespace json {
+template<> struct LiteralTraits<Endpoint> {
+  static constexpr Endpoint get(const Literal &L) {
+    return Endpoint{L["Host"].get<std::string_view>(),
+      L["Port"].get<unsigned>()};
+  }
+};
+}
+
+constexpr json::Literal Config(R"j(
+  {
+    "Endpoint": {"Host": "localhost", "Port": 8080},
+    "Mode": "safe",
+    "Retries": [1, 2, 3],
+    "Ratio": -0.25e1,
+    "Limit": -9223372036854775808,
+    "Verbose": false,
+    "Comment": null,
+    "Escaped": "a\"b"
+  }
+)j");
+
+constexpr auto Remote = Config["Endpoint"].get<Endpoint>();
+static_assert(Remote.Host == "localhost" && Remote.Port == 8080,
+  "Object must be converted at compile time!");
+static_assert(Config["Mode"].get<Mode>() == Mode::Safe,
+  "Enumerator must be converted at compile time!");
+static_assert(Config["Retries"].get<std::array<int, 3>>()[2] == 3 &&
+  Config["Retries"].size() == 3, "Array must be converted at compile time!");
+static_assert(Config["Ratio"].get<double>() == -2.5,
+  "Number must be converted at compile time!");
+static_assert(Config["Limit"].get<long long>() == INT64_MIN,
+  "Minimum value must be converted at compile time!");
+static_assert(!Config["Verbose"].get<bool>() &&
+  !Config["Comment"].get<std::optional<int>>() &&
+  Config["Escaped"].str() == R"j("a\"b")j",
+  "Keywords must be converted at compile time!");
+static_assert(Config.size() == 8 && Config.key(1) == "Mode" &&
+  Config.contains("Ratio") && !Config.contains("Port") &&
+  Config[2].kind() == json::LiteralKind::ARRAY,
+  "Members must be available at compile time!");
+static_assert(json::Literal("0.1").get<double>() == 0.1 &&
+  json::Literal(" [ ] ").empty() && json::Literal("{}").size() == 0,
+  "Literals must be checked at compile time!");
+
+static bool check(const char *Title, bool Ok) {
+  std::cout << Title << (Ok ? ": passed" : ": failed") << std::endl;
+  return Ok;
+}
+
+/// Returns true if a specified JSON literal is rejected with a specified
+/// error at a specified position.
+template<class Ty> bool checkError(std::string_view JSON, json::Error Code,
+    json::Position Pos) {
+  try {
+    json::Literal(JSON).get<Ty>();
+  } catch (const json::LiteralError &E) {
+    return E.code() == Code && E.position() == Pos;
+  }
+  return false;
+}
+
+/// Returns distance in units in the last place between a JSON literal
+/// converted to double and the result of std::from_chars().
+static std::uint64_t ulpDistance(std::string_view JSON) {
+  double Expected = 0;
+  std::from_chars(JSON.data(), JSON.data() + JSON.size(), Expected);
+  double Value = json::Literal(JSON).get<double>();
+  std::int64_t LHS, RHS;
+  std::memcpy(&LHS, &Value, sizeof(double));
+  std::memcpy(&RHS, &Expected, sizeof(double));
+  return LHS < RHS ? RHS - LHS : LHS - RHS;
+}
+
+int main() {
+  bool Ok = true;
+  {
+    // Error bound of the conversion, see LiteralTraits for floating-point.
+    bool IsWide = std::numeric_limits<long double>::digits >
+      std::numeric_limits<double>::digits;
+    auto bound = [IsWide](int Exp) -> std::uint64_t {
+      return IsWide ? 1 : (std::abs(Exp) + 21) / 22 + 1;
+    };
+    Ok &= check("floating-point precision",
+      ulpDistance("1.2345678901234567e-300") <= bound(-316) &&
+      ulpDistance("2.2250738585072014e-308") <= bound(-324) &&
+      ulpDistance("1.7976931348623157e308") <= bound(292) &&
+      ulpDistance("9007199254740993") <= bound(0) &&
+      ulpDistance("0.30000000000000004") <= bound(-17) &&
+      ulpDistance("123456.789e-2") <= bound(-5) &&
+      ulpDistance("-6.02214076e23") <= bound(15) &&
+      json::Literal("1.2345678901234567e-300").get<double>() > 0);
+  }
+  Ok &= check("unexpected end",
+    checkError<int>("[1, 2", json::Error::UNEXPECTED_END, 5));
+  Ok &= check("unexpected character",
+    checkError<int>("[1; 2]", json::Error::UNEXPECTED_CHARACTER, 2));
+  Ok &= check("trailing characters",
+    checkError<int>("1 2", json::Error::UNEXPECTED_CHARACTER, 2));
+  Ok &= check("key expected",
+    checkError<int>("{1:2}", json::Error::IDENTIFIER_EXPECTED, 1));
+  Ok &= check("value expected",
+    checkError<int>("[1, :]", json::Error::VALUE_EXPECTED, 4));
+  Ok &= check("integer overflow",
+    checkError<unsigned char>("256", json::Error::CONVERSION, 0));
+  Ok &= check("fraction to integer",
+    checkError<int>("1.5", json::Error::CONVERSION, 1));
+  Ok &= check("array size",
+    checkError<std::array<int, 2>>("[1]", json::Error::CONVERSION, 0));
+  Ok &= check("escaped string",
+    checkError<std::string_view>(R"j("a\nb")j", json::Error::CONVERSION, 2));
+  Ok &= check("unknown enumerator",
+    checkError<Mode>(R"j("slow")j", json::Error::ILLEGAL_VALUE, 0));
+  bool UnknownKey = false;
+  try {
+    Config["Port"];
+  } catch (const json::LiteralError &E) {
+    UnknownKey = E.code() == json::Error::UNKNOWN_IDENTIFIER;
+  }
+  Ok &= check("unknown key", UnknownKey);
+  return Ok ? 0 : 1;
+}
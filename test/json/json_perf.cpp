@@ -0,0 +1,122 @@
+//===- json_perf.cpp ---------- JSON Parser Benchmark -------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements performance benchmark for json::Parser. Parsing of
+// well-formed documents is compared with rejection of malformed documents.
+// Errors are recorded by a lexer and diagnostics are formatted on demand, so
+// rejection without formatting should not be slower than acceptance.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/Json.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using TimeT = std::chrono::duration<double>;
+
+/// Parses each document as an array of integers and counts accepted
+/// documents.
+///
+/// If FormatErrors is true, diagnostics for rejected documents are formatted.
+static TimeT parseTime(const std::vector<std::string> &Docs, bool FormatErrors,
+    std::size_t &Accepted) {
+  auto S = std::chrono::high_resolution_clock::now();
+  for (auto &D : Docs) {
+    json::Parser<> P(D);
+    int *Array = nullptr;
+    if (P.parse(Array)) {
+      ++Accepted;
+      delete[] Array;
+    } else if (FormatErrors) {
+      Accepted += P.errors().empty();
+    }
+  }
+  auto E = std::chrono::high_resolution_clock::now();
+  return E - S;
+}
+
+int main(int Argc, char **Argv) {
+  std::string Help = "parameters: <number of documents> [number of iterations]\n";
+  if (Argc < 2) {
+    std::cerr << "error: too few arguments\n" << Help;
+    return 1;
+  } else if (Argc > 3) {
+    std::cerr << "error: too many arguments\n" << Help;
+    return 2;
+  }
+  std::size_t Size = std::atoll(Argv[1]);
+  unsigned MaxIter = (Argc > 2) ? std::atoi(Argv[2]) : 10;
+  // Malformed documents contain a gap in indexes, a duplicate index or
+  // a value which is not a number.
+  std::vector<std::string> Good, Bad;
+  for (std::size_t I = 0; I < Size; ++I) {
+    auto V = std::to_string(I);
+    Good.push_back(R"j({"0":)j" + V + R"j(, "1":2, "2":3, "3":4})j");
+    switch (I % 3) {
+    case 0: Bad.push_back(R"j({"0":)j" + V + R"j(, "1":2, "3":3, "4":4})j");
+      break;
+    case 1: Bad.push_back(R"j({"0":)j" + V + R"j(, "1":2, "1":3, "2":4})j");
+      break;
+    case 2: Bad.push_back(R"j({"0":)j" + V + R"j(, "1":2, "2":"x", "3":4})j");
+      break;
+    }
+  }
+  TimeT Accept(0), Reject(0), Format(0);
+  std::size_t Accepted = 0, Rejected = 0;
+  for (unsigned I = 0; I < MaxIter; ++I) {
+    Accept += parseTime(Good, false, Accepted);
+    Reject += parseTime(Bad, false, Rejected);
+    Format += parseTime(Bad, true, Rejected);
+  }
+  if (Accepted != Size * MaxIter || Rejected != 0) {
+    std::cerr << "error: unexpected result of parsing\n";
+    return 3;
+  }
+  std::cout << "Results for " << __FILE__ << " benchmark" << std::endl;
+  std::cout << "  date " << __DATE__ << std::endl;
+  std::cout << "  compiler ";
+#if defined __GNUC__
+  std::cout << "GCC " << __GNUC__;
+#elif defined __clang__
+  std::cout << "Clang " << __clang__;
+#elif defined _MSC_VER
+  std::cout << "Microsoft " << _MSC_VER;
+#else
+  std::cout << "unknown";
+#endif
+  std::cout << std::endl;
+  std::cout << "  BCL version " << BCL_VERSION_STRING << std::endl;
+  std::cout << "  number of documents " << Size << std::endl;
+  std::cout << "  number of iterations " << MaxIter << std::endl;
+  std::map<double, std::string> Time;
+  std::cout << std::endl;
+  Time.emplace(Accept.count(), "accept well-formed documents time (.s) ");
+  Time.emplace(Reject.count(), "reject malformed documents time (.s) ");
+  Time.emplace(Format.count(),
+    "reject malformed documents and format diagnostics time (.s) ");
+  for (auto &T : Time)
+    std::cout << T.second << T.first << std::endl;
+  return 0;
+}
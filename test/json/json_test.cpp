@@ -0,0 +1,425 @@
+//===- json_test.cpp ------------ JSON Parser Test ----------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for json::Parser and built-in json::Traits.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/Json.h>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+JSON_OBJECT_BEGIN(Human)
+JSON_OBJECT_ROOT_PAIR_3(Human,
+  Name, std::string,
+  Age, unsigned,
+  Children, std::vector<std::string>)
+  Human() : JSON_INIT_ROOT {}
+JSON_OBJECT_END(Human)
+JSON_DEFAULT_TRAITS(::, Human)
+
+JSON_OBJECT_BEGIN(Profile)
+JSON_OBJECT_ROOT_PAIR_2(Profile,
+  Nick, const char *,
+  Rank, std::optional<unsigned>)
+  Profile() : JSON_INIT_ROOT {}
+JSON_OBJECT_END(Profile)
+JSON_DEFAULT_TRAITS(::, Profile)
+
+JSON_OBJECT_BEGIN(Robot)
+JSON_OBJECT_ROOT_PAIR_2(Robot,
+  Model, std::string,
+  Serial, unsigned)
+  Robot() : JSON_INIT_ROOT {}
+JSON_OBJECT_END(Robot)
+JSON_DEFAULT_TRAITS(::, Robot)
+
+enum class Color { Red, Green, Blue };
+JSON_ENUM_TRAITS(::, Color,
+  {Color::Red, "red"}, {Color::Green, "green"}, {Color::Blue, "blue"})
+
+enum Level { Low = -1000, High = 1000 };
+JSON_ENUM_TRAITS(::, Level, {Low, "low"}, {High, "high"})
+
+static_assert(json::Traits<Color>::name(Color::Blue) == "blue" &&
+  json::Traits<Level>::name(High) == "high" &&
+  json::Traits<Color>::name(static_cast<Color>(7)).empty(),
+  "Names of enumerators must be available at compile time!");
+
+static bool check(const char *Title, bool Ok) {
+  std::cout << Title << (Ok ? ": passed" : ": failed") << std::endl;
+  return Ok;
+}
+
+/// Parses a specified JSON string and returns true if it has been rejected
+/// with a specified error at a specified position. Diagnostic must be
+/// formatted on demand only.
+template<class Ty> bool checkError(const char *JSON, json::Error Code,
+    json::Position Pos) {
+  json::Parser<> P(JSON);
+  Ty Obj{};
+  if (P.parse(Obj) || !P.hasErrors() || P.errorRecords().empty())
+    return false;
+  auto &E = P.errorRecords().front();
+  if (E.Code != Code || E.Pos != Pos)
+    return false;
+  auto &Errors = P.errors();
+  if (Errors.size() != P.errorRecords().size())
+    return false;
+  std::string Prefix = "json error C" +
+    std::to_string(static_cast<unsigned>(Code)) + "(" + std::to_string(Pos) +
+    "): ";
+  return std::strncmp(*Errors.begin(), Prefix.c_str(), Prefix.size()) == 0;
+}
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  bool Ok = true;
+  {
+    json::Parser<> P(R"j({"0":1, "1":-2, "2":+3})j");
+    int *Array = nullptr;
+    Ok &= check("parse array of integers", P.parse(Array) &&
+      Array[0] == 1 && Array[1] == -2 && Array[2] == 3);
+    delete[] Array;
+  }
+  {
+    json::Parser<> P(R"j([1.5, 2, "0.25"])j");
+    std::vector<double> V;
+    Ok &= check("parse vector of doubles", P.parse(V) && V.size() == 3 &&
+      V[0] == 1.5 && V[1] == 2 && V[2] == 0.25);
+  }
+  {
+    json::Parser<> P("[ 1,-2 ,+3,\n4 ]");
+    int *Array = nullptr;
+    std::vector<long> V;
+    Ok &= check("parse numeric arrays", P.parse(Array) &&
+      Array[0] == 1 && Array[1] == -2 && Array[2] == 3 && Array[3] == 4 &&
+      json::Parser<>("[]").parse(V) && V.empty() &&
+      json::Parser<>("[7]").parse(V) && V.size() == 1 && V[0] == 7);
+    delete[] Array;
+  }
+  {
+    std::vector<double> V{ 1.5, -0.25, 1e20 };
+    std::vector<unsigned> U{ 0, 42 };
+    auto JSON = json::Parser<>::unparse(V);
+    std::vector<double> Parsed;
+    json::Parser<> P(JSON);
+    Ok &= check("unparse numeric arrays",
+      JSON == "[" + std::to_string(V[0]) + "," + std::to_string(V[1]) + "," +
+        std::to_string(V[2]) + "]" &&
+      json::Parser<>::unparse(U) == "[0,42]" &&
+      json::Parser<>::unparse(std::vector<int>()) == "[]" &&
+      P.parse(Parsed) && Parsed == V);
+  }
+  {
+    json::Parser<> P(R"j(["a", "\n", "\\"])j");
+    char *Str = nullptr;
+    Ok &= check("parse array of characters", P.parse(Str) &&
+      Str[0] == 'a' && Str[1] == '\n' && Str[2] == '\\');
+    delete[] Str;
+  }
+  {
+    json::Parser<> P(R"j({"a":[1, 0], "b":[], "c":null})j");
+    std::map<std::string, std::optional<std::vector<int>>> M;
+    Ok &= check("parse map of optional values", P.parse(M) &&
+      M.size() == 3 && M["a"] && M["a"]->size() == 2 && (*M["a"])[0] &&
+      !(*M["a"])[1] && M["b"] && M["b"]->empty() && !M["c"]);
+  }
+  {
+    json::Parser<Human> P(R"j({"name": "Human", "Name": "Jon", "Age": 42,)j"
+      R"j( "Children": ["Ann", "Bob"]})j");
+    auto O = P.parse();
+    Ok &= check("parse object", O && O->is<Human>() &&
+      O->as<Human>()[Human::Name] == "Jon" &&
+      O->as<Human>()[Human::Age] == 42 &&
+      O->as<Human>()[Human::Children].size() == 2 && !P.hasErrors());
+  }
+  {
+    Robot R;
+    R[Robot::Model] = "R2";
+    R[Robot::Serial] = 2;
+    Ok &= check("object identifiers", R.is<Robot>() && !R.is<Human>() &&
+      R.getId() == json::Object::id<Robot>() &&
+      R.getId() == json::Object::intern("Robot") &&
+      json::Object("Robot").is<Robot>() && R.getName() == "Robot" &&
+      !json::Object::lookup("Android"));
+    auto JSON = json::Parser<Human, Robot>::unparseAsObject(R);
+    json::Parser<Human, Robot> P(JSON);
+    auto O = P.parse();
+    Ok &= check("dispatch by identifier", O && O->is<Robot>() &&
+      O->as<Robot>()[Robot::Model] == "R2" &&
+      O->as<Robot>()[Robot::Serial] == 2);
+    json::Parser<Human, Robot> Unknown(R"j({"name": "Android"})j");
+    Ok &= check("unknown object", !Unknown.parse());
+  }
+  {
+    using Message = std::variant<Human, Robot>;
+    Message M(std::in_place_type<Robot>);
+    std::get<Robot>(M)[Robot::Model] = "R2";
+    std::get<Robot>(M)[Robot::Serial] = 2;
+    auto JSON = json::Parser<>::unparse(M);
+    json::Parser<> P(JSON);
+    Message Parsed;
+    Ok &= check("unparse variant",
+      JSON.compare(0, 15, R"j({"name":"Robot")j") == 0 &&
+      P.parse(Parsed) && std::holds_alternative<Robot>(Parsed) &&
+      std::get<Robot>(Parsed)[Robot::Model] == "R2" &&
+      std::get<Robot>(Parsed)[Robot::Serial] == 2);
+    json::Parser<> Last(R"j({"Age": 42, "Children": [], "name": "Human"})j");
+    Ok &= check("parse variant with trailing discriminator",
+      Last.parse(Parsed) && std::holds_alternative<Human>(Parsed) &&
+      std::get<Human>(Parsed)[Human::Age] == 42);
+    struct Broken {
+      operator Human() const { throw std::runtime_error("broken human"); }
+    };
+    try {
+      Parsed.emplace<Human>(Broken{});
+    } catch (const std::runtime_error &) {}
+    bool IsRejected = false;
+    try {
+      json::Parser<>::unparse(Parsed);
+    } catch (const std::bad_variant_access &) {
+      IsRejected = true;
+    }
+    Ok &= check("reject valueless variant",
+      Parsed.valueless_by_exception() && IsRejected);
+  }
+  Ok &= check("variant without discriminator",
+    checkError<std::variant<Human, Robot>>(R"j({"Age": 42})j",
+      json::Error::UNKNOWN_IDENTIFIER, 10));
+  Ok &= check("unknown alternative",
+    checkError<std::variant<Human, Robot>>(R"j({"name": "Android"})j",
+      json::Error::ILLEGAL_VALUE, 9));
+  {
+    json::SymbolPool Pool;
+    json::Parser<> P(R"j(["kind", "file", "kind", "ki\nd", "kind"])j");
+    P.setSymbolPool(&Pool);
+    std::vector<json::Symbol> V;
+    Ok &= check("parse symbols", P.parse(V) && V.size() == 5 &&
+      Pool.size() == 3 && V[0] == V[2] && V[0].str().data() ==
+        V[4].str().data() && V[0] != V[1] && V[3].str() == "ki\nd" &&
+      V[0].pool() == &Pool && V[0].hash() == std::hash<std::string_view>()(
+        "kind") && json::Parser<>::unparse(V[3]) == R"j("ki\nd")j");
+    std::vector<json::Symbol> Shared;
+    json::Parser<> SharedP(R"j(["kind"])j");
+    SharedP.setSymbolPool(&json::SymbolPool::shared());
+    Ok &= check("compare symbols from different pools",
+      SharedP.parse(Shared) && Shared.size() == 1 &&
+      Shared[0].pool() == &json::SymbolPool::shared() && Shared[0] == V[0] &&
+      std::hash<json::Symbol>()(Shared[0]) == std::hash<json::Symbol>()(V[0]) &&
+      json::Symbol() == Pool.intern("") && json::Symbol() < V[0]);
+  }
+  Ok &= check("symbols without a pool",
+    checkError<std::vector<json::Symbol>>(R"j(["kind"])j",
+      json::Error::ILLEGAL_VALUE, 1));
+  {
+    json::Parser<> P(R"j(["green", "red", "blue", "green"])j");
+    std::vector<Color> V;
+    std::map<std::string, Level> M;
+    Ok &= check("parse enumerations", P.parse(V) && V.size() == 4 &&
+      V[0] == Color::Green && V[1] == Color::Red && V[2] == Color::Blue &&
+      json::Parser<>::unparse(V) == R"j(["green","red","blue","green"])j" &&
+      json::Parser<>(R"j({"a":"high", "b":"low"})j").parse(M) &&
+      M["a"] == High && M["b"] == Low &&
+      json::Parser<>::unparse(M) == R"j({"a":"high","b":"low"})j");
+  }
+  Ok &= check("unknown enumerator",
+    checkError<std::vector<Color>>(R"j(["red", "purple"])j",
+      json::Error::ILLEGAL_VALUE, 8));
+  {
+    Human Prev;
+    Prev[Human::Name] = "Jon";
+    Prev[Human::Age] = 42;
+    Prev[Human::Children] = { "Ann", "Bob" };
+    Human Next(Prev);
+    Next[Human::Age] = 43;
+    auto Delta = json::Parser<>::unparse(Next, Prev);
+    json::Parser<> P(Delta);
+    Human Merged(Prev);
+    Ok &= check("unparse changed values",
+      Delta == R"j({"Age":43})j" && P.merge(Merged) &&
+      Merged[Human::Name] == "Jon" && Merged[Human::Age] == 43 &&
+      Merged[Human::Children].size() == 2 &&
+      json::Parser<>::unparse(Prev, Prev) == "{}");
+    json::Parser<> Replace(R"j({"Children": ["Eve"]})j");
+    Ok &= check("merge replaces values", Replace.merge(Merged) &&
+      Merged[Human::Children].size() == 1 &&
+      Merged[Human::Children][0] == "Eve" && Merged[Human::Age] == 43);
+  }
+  {
+    Profile Prev;
+    Prev[Profile::Nick] = "R2";
+    Prev[Profile::Rank] = 1;
+    Profile Next;
+    Next[Profile::Nick] = nullptr;
+    Next[Profile::Rank] = std::nullopt;
+    auto Delta = json::Parser<>::unparse(Next, Prev);
+    json::Parser<> P(Delta);
+    Profile Merged(Prev);
+    Ok &= check("merge values which become empty",
+      Delta == R"j({"Nick":null,"Rank":null})j" && P.merge(Merged) &&
+      !Merged[Profile::Nick] && !Merged[Profile::Rank]);
+    char PrevNick[] = "R2", NextNick[] = "R2";
+    Prev[Profile::Nick] = PrevNick;
+    Next[Profile::Nick] = NextNick;
+    Next[Profile::Rank] = 1;
+    auto Same = json::Parser<>::unparse(Next, Prev);
+    NextNick[1] = '3';
+    auto Changed = json::Parser<>::unparse(Next, Prev);
+    Ok &= check("compare strings in delta by content",
+      Same == "{}" && Changed == R"j({"Nick":"R3"})j");
+  }
+  {
+    std::vector<Human> People(100);
+    for (unsigned I = 0; I < People.size(); ++I) {
+      People[I][Human::Name] = "Human" + std::to_string(I);
+      People[I][Human::Age] = I;
+      People[I][Human::Children] = { "Child" + std::to_string(I) };
+    }
+    auto JSON = json::Parser<>::unparse(People);
+    auto Chunks = json::Parser<>::unparseChunks(People, 4, 10);
+    std::string Joined;
+    for (auto &C : Chunks)
+      Joined += C;
+    Ok &= check("unparse chunks in parallel", Chunks.size() == 4 &&
+      Joined == JSON &&
+      json::Parser<>::unparseParallel(People, 4, 10) == JSON &&
+      json::Parser<>::unparseParallel(People, 4, 1000) == JSON &&
+      json::Parser<>::unparseParallel(std::vector<Human>{}, 4, 1) ==
+        json::Parser<>::unparse(std::vector<Human>{}));
+    std::vector<Color> Colors(8, Color::Green);
+    Colors[5] = static_cast<Color>(7);
+    Ok &= check("unparse chunks with empty elements",
+      json::Parser<>::unparseParallel(Colors, 4, 1) ==
+        json::Parser<>::unparse(Colors));
+    std::vector<double> Numbers{1.5, -2, 1e10, 0.125, 3};
+    std::vector<std::uint8_t> Bytes{0, 1, 2, 254, 255};
+    Ok &= check("unparse chunks of numbers and bytes",
+      json::Parser<>::unparseParallel(Numbers, 4, 1) ==
+        json::Parser<>::unparse(Numbers) &&
+      json::Parser<>::unparseChunks(Bytes, 4, 1).size() == 1 &&
+      json::Parser<>::unparseParallel(Bytes, 4, 1) ==
+        json::Parser<>::unparse(Bytes));
+  }
+  {
+    bcl::Diagnostic D("analysis error");
+    D.insert(101, "unexpected \"%s\" in %s", 100, "a b", "file");
+    D.insert(7, "line\nbreak", 3);
+    auto JSON = json::Parser<>::unparse(D);
+    json::Parser<> P(JSON);
+    bcl::Diagnostic Copy("analysis error");
+    Ok &= check("diagnostic round trip", P.parse(Copy) &&
+      Copy.size() == 2 &&
+      std::strcmp(*Copy.begin(), *D.begin()) == 0 &&
+      std::strcmp(*++Copy.begin(), *++D.begin()) == 0 &&
+      JSON.compare(0, 61, R"j([{"Kind":"analysis error","Code":101,)j"
+        R"j("Position":100,"Message")j") == 0);
+    json::Parser<> Legacy(R"j(["analysis error C5(10): a \"b\" c"])j");
+    bcl::Diagnostic FromLegacy("analysis error");
+    Ok &= check("legacy diagnostic", Legacy.parse(FromLegacy) &&
+      FromLegacy.size() == 1 && std::strcmp(*FromLegacy.begin(),
+        R"(analysis error C5(10): a "b" c)") == 0);
+    json::String LegacyJSON;
+    json::Traits<bcl::Diagnostic>::unparseLegacy(LegacyJSON, D);
+    json::Parser<> LegacyP(LegacyJSON);
+    bcl::Diagnostic LegacyCopy("analysis error");
+    Ok &= check("unparse legacy diagnostic",
+      LegacyJSON.compare(0, 28, R"j(["analysis error C101(100): )j") == 0 &&
+      LegacyP.parse(LegacyCopy) && LegacyCopy.size() == 2 &&
+      std::strcmp(*LegacyCopy.begin(), *D.begin()) == 0 &&
+      std::strcmp(*++LegacyCopy.begin(), *++D.begin()) == 0);
+    json::Parser<> Other(R"j([{"Kind":"warning","Code":1,)j"
+      R"j("Position":0,"Message":""}])j");
+    bcl::Diagnostic FromOther("analysis error");
+    Ok &= check("diagnostic of other kind", !Other.parse(FromOther) &&
+      !Other.errorRecords().empty() &&
+      Other.errorRecords().front().Code == json::Error::ILLEGAL_VALUE &&
+      Other.errorRecords().front().Pos == 1);
+    using namespace std::string_literals;
+    json::Parser<> RawNull(
+      R"j([{"Code":1,"Position":0,"Message":"a)j" "\0"s + R"j(b"}])j");
+    json::Parser<> LegacyNull(
+      R"j(["analysis error C1(0): a)j" "\0"s + R"j(b"])j");
+    bcl::Diagnostic WithNull("analysis error");
+    Ok &= check("reject diagnostic with null characters",
+      !RawNull.parse(WithNull) && !LegacyNull.parse(WithNull) &&
+      RawNull.errorRecords().front().Code == json::Error::ILLEGAL_VALUE &&
+      LegacyNull.errorRecords().front().Code == json::Error::ILLEGAL_VALUE &&
+      !WithNull.insert_text(1, 0, "a\0b"s) && WithNull.empty());
+  }
+  {
+    std::string JSON(R"j(["a\"b", "c/", "d\\", "/"])j");
+    json::Lexer Lex(JSON);
+    std::vector<std::string> Tokens;
+    while (Lex.goToNext() && !Lex.is(json::Token::RIGHT_BRACKET))
+      if (Lex.is(json::Token::IDENTIFIER))
+        Tokens.push_back(JSON.substr(Lex.start(), Lex.end() - Lex.start() + 1));
+    Ok &= check("lex escaped quotes and trailing slashes",
+      Tokens == std::vector<std::string>{
+        R"("a\"b")", R"("c/")", R"("d\\")", R"("/")"});
+    std::vector<std::string> Strings;
+    json::Parser<> P(JSON);
+    Ok &= check("parse escaped quotes and trailing slashes",
+      P.parse(Strings) &&
+      Strings == std::vector<std::string>{"a\"b", "c/", "d\\", "/"});
+  }
+  Ok &= check("unexpected end of string",
+    checkError<std::vector<int>>("[1, 2", json::Error::UNEXPECTED_END, 5));
+  Ok &= check("unexpected character",
+    checkError<std::vector<int>>("[1; 2]",
+      json::Error::UNEXPECTED_CHARACTER, 2));
+  Ok &= check("value expected",
+    checkError<std::vector<int>>("[1, :]", json::Error::VALUE_EXPECTED, 4));
+  Ok &= check("identifier expected",
+    checkError<std::map<std::string, int>>("{1:2}",
+      json::Error::IDENTIFIER_EXPECTED, 1));
+  Ok &= check("uninitialized elements",
+    checkError<int *>(R"j({"0":1, "2":3})j",
+      json::Error::UNINITIALIZED_ELEMENTS, 0));
+  Ok &= check("duplicate key in array",
+    checkError<std::vector<int>>(R"j({"0":1, "0":3})j",
+      json::Error::DUPLICATE_KEY, 0));
+  Ok &= check("duplicate key in set",
+    checkError<std::set<int>>("[1, 1]", json::Error::DUPLICATE_KEY, 4));
+  Ok &= check("conversion error",
+    checkError<std::vector<unsigned>>(R"j(["a"])j",
+      json::Error::CONVERSION, 1));
+  {
+    json::Lexer Lex("{}");
+    Lex.addError(json::Error::UNKNOWN_IDENTIFIER, 2, "name");
+    bool NotFormatted = Lex.hasErrors() && Lex.errorRecords().size() == 1;
+    Ok &= check("format errors on demand", NotFormatted &&
+      Lex.errors().size() == 1 &&
+      std::strcmp(*Lex.errors().begin(), "json error C3(2): unknown json "
+        "string, identifier 'name' is not found") == 0 &&
+      Lex.errors().size() == 1);
+  }
+  return Ok ? 0 : 1;
+}
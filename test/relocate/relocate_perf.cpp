@@ -0,0 +1,171 @@
+//===- relocate_perf.cpp ---- Relocation Benchmark ----------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements performance benchmark for bcl::relocate_n() and
+// bcl::uninitialized_relocate(). Relocation of trivially relocatable objects
+// is compared with a loop of move constructors and destructors.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/utility.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+using TimeT = std::chrono::duration<double>;
+
+/// Object which owns heap memory, so it has non-trivial move constructor and
+/// destructor but it does not depend on its own address.
+struct Element {
+  explicit Element(int V) : mValue(new int(V)) {}
+  std::unique_ptr<int> mValue;
+  std::size_t mPayload[3] = {0, 0, 0};
+};
+
+namespace bcl {
+template<> struct is_trivially_relocatable<Element> : public std::true_type {};
+}
+
+/// Relocates objects to a new location using move constructor and destructor.
+static Element * moveAndDestroy(Element *First, std::size_t N, Element *Dest) {
+  if (Dest < First) {
+    for (std::size_t I = 0; I < N; ++I) {
+      ::new (static_cast<void *>(Dest + I)) Element(std::move(First[I]));
+      First[I].~Element();
+    }
+  } else {
+    for (std::size_t I = N; I > 0; --I) {
+      ::new (static_cast<void *>(Dest + I - 1)) Element(std::move(First[I - 1]));
+      First[I - 1].~Element();
+    }
+  }
+  return Dest + N;
+}
+
+static Element * allocate(std::size_t Size) {
+  return static_cast<Element *>(::operator new(Size * sizeof(Element)));
+}
+
+static void destroy(Element *First, std::size_t Size) {
+  for (std::size_t I = 0; I < Size; ++I)
+    First[I].~Element();
+  ::operator delete(First);
+}
+
+/// Emulates growth of a container: each time the storage is full its capacity
+/// is doubled and all elements are relocated to the new storage.
+template<class RelocateT>
+TimeT growTime(std::size_t Size, RelocateT Relocate) {
+  TimeT T(0);
+  std::size_t Capacity = 1;
+  Element *Data = allocate(Capacity);
+  for (std::size_t I = 0; I < Size; ++I) {
+    if (I == Capacity) {
+      auto *NewData = allocate(Capacity * 2);
+      auto S = std::chrono::high_resolution_clock::now();
+      Relocate(Data, Capacity, NewData);
+      auto E = std::chrono::high_resolution_clock::now();
+      T += E - S;
+      ::operator delete(Data);
+      Data = NewData;
+      Capacity *= 2;
+    }
+    ::new (static_cast<void *>(Data + I)) Element(static_cast<int>(I));
+  }
+  destroy(Data, Size);
+  return T;
+}
+
+/// Emulates erasure of elements from the beginning of a container, each time
+/// the rest of elements is shifted to the left.
+template<class RelocateT>
+TimeT eraseTime(std::size_t Size, std::size_t EraseNum, RelocateT Relocate) {
+  Element *Data = allocate(Size);
+  for (std::size_t I = 0; I < Size; ++I)
+    ::new (static_cast<void *>(Data + I)) Element(static_cast<int>(I));
+  auto S = std::chrono::high_resolution_clock::now();
+  for (std::size_t I = 0; I < EraseNum && Size > 0; ++I, --Size) {
+    Data[0].~Element();
+    Relocate(Data + 1, Size - 1, Data);
+  }
+  auto E = std::chrono::high_resolution_clock::now();
+  destroy(Data, Size);
+  return E - S;
+}
+
+int main(int Argc, char **Argv) {
+  std::string Help = "parameters: <size of data> [number of iterations]"
+  " [number of erased elements]\n";
+  if (Argc < 2) {
+    std::cerr << "error: too few arguments\n" << Help;
+    return 1;
+  } else if (Argc > 4) {
+    std::cerr << "error: too many arguments\n" << Help;
+    return 2;
+  }
+  std::size_t Size = std::atoll(Argv[1]);
+  unsigned MaxIter = (Argc > 2) ? std::atoi(Argv[2]) : 10;
+  std::size_t EraseNum = (Argc > 3) ? std::atoll(Argv[3]) : 100;
+  TimeT GrowMove(0), GrowRelocate(0), EraseMove(0), EraseRelocate(0);
+  for (unsigned I = 0; I < MaxIter; ++I) {
+    GrowMove += growTime(Size, moveAndDestroy);
+    GrowRelocate += growTime(Size, [](Element *F, std::size_t N, Element *D) {
+      return bcl::uninitialized_relocate(F, F + N, D);
+    });
+    EraseMove += eraseTime(Size, EraseNum, moveAndDestroy);
+    EraseRelocate += eraseTime(Size, EraseNum, bcl::relocate_n<Element>);
+  }
+  std::cout << "Results for " << __FILE__ << " benchmark" << std::endl;
+  std::cout << "  date " << __DATE__ << std::endl;
+  std::cout << "  compiler ";
+#if defined __GNUC__
+  std::cout << "GCC " << __GNUC__;
+#elif defined __clang__
+  std::cout << "Clang " << __clang__;
+#elif defined _MSC_VER
+  std::cout << "Microsoft " << _MSC_VER;
+#else
+  std::cout << "unknown";
+#endif
+  std::cout << std::endl;
+  std::cout << "  BCL version " << BCL_VERSION_STRING << std::endl;
+  std::cout << "  size of data " << Size << std::endl;
+  std::cout << "  size of element " << sizeof(Element) << std::endl;
+  std::cout << "  number of erased elements " << EraseNum << std::endl;
+  std::cout << "  number of iterations " << MaxIter << std::endl;
+  std::map<double, std::string> Time;
+  std::cout << std::endl;
+  Time.emplace(GrowMove.count(), "move and destroy on growth time (.s) ");
+  Time.emplace(GrowRelocate.count(),
+    "bcl::uninitialized_relocate() on growth time (.s) ");
+  for (auto &T : Time)
+    std::cout << T.second << T.first << std::endl;
+  std::cout << std::endl;
+  Time.clear();
+  Time.emplace(EraseMove.count(), "move and destroy on erasure time (.s) ");
+  Time.emplace(EraseRelocate.count(), "bcl::relocate_n() on erasure time (.s) ");
+  for (auto &T : Time)
+    std::cout << T.second << T.first << std::endl;
+  return 0;
+}
@@ -0,0 +1,93 @@
+//===- relocate_test.cpp ------ Relocation Correctness Test -------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for bcl::swapMemory(), bcl::relocate_n() and
+// bcl::is_trivially_relocatable specializations.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/cell.h>
+#include <bcl/convertible_pair.h>
+#include <bcl/tagged.h>
+#include <bcl/utility.h>
+#include <iostream>
+#include <memory>
+#include <string>
+
+struct Name { typedef std::string ValueType; };
+struct Age { typedef unsigned ValueType; };
+struct Id {};
+
+static_assert(bcl::is_trivially_relocatable<bcl::StaticMap<Age>>::value,
+  "Map with trivially copyable values must be trivially relocatable!");
+static_assert(!bcl::is_trivially_relocatable<bcl::StaticMap<Name, Age>>::value,
+  "Map with std::string must not be trivially relocatable!");
+static_assert(bcl::is_trivially_relocatable<
+  bcl::tagged_tuple<bcl::tagged<int, Id>, bcl::tagged<long, Age>>>::value,
+  "Tuple with trivially copyable values must be trivially relocatable!");
+static_assert(bcl::is_trivially_relocatable<
+  bcl::convertible_pair<int, double>>::value,
+  "Pair with trivially copyable values must be trivially relocatable!");
+
+/// String which owns heap memory and can be relocated with memmove().
+struct BoxedString {
+  BoxedString(const std::string &S) : mValue(new std::string(S)) {}
+  operator const std::string & () const { return *mValue; }
+  std::unique_ptr<std::string> mValue;
+};
+
+namespace bcl {
+template<> struct is_trivially_relocatable<BoxedString> :
+  public std::true_type {};
+}
+
+template<class T> bool check(const char *Title) {
+  std::cout << Title << ": ";
+  auto *Data = static_cast<T *>(::operator new(10 * sizeof(T)));
+  for (int I = 0; I < 8; ++I)
+    ::new (Data + I) T(std::to_string(I));
+  // Shift to the right: 0 1 2 3 4 5 6 7 _ _ -> 0 _ _ 1 2 3 4 5 6 7
+  bcl::relocate_n(Data + 1, 7, Data + 3);
+  ::new (Data + 1) T(std::string("a"));
+  ::new (Data + 2) T(std::string("b"));
+  // Shift to the left: 0 a b 1 2 3 4 5 6 7 -> 0 b 1 2 3 4 5 6 7 _
+  Data[1].~T();
+  bcl::relocate_n(Data + 2, 8, Data + 1);
+  if (bcl::is_trivially_relocatable<T>::value)
+    bcl::swapMemory(Data[0], Data[8]);
+  else
+    std::swap(Data[0], Data[8]);
+  std::string Result;
+  for (int I = 0; I < 9; ++I) {
+    Result += static_cast<const std::string &>(Data[I]);
+    Data[I].~T();
+  }
+  ::operator delete(Data);
+  std::cout << Result << std::endl;
+  return Result == "7b1234560";
+}
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  bool Ok = check<std::string>("std::string");
+  Ok &= check<BoxedString>("trivially relocatable string");
+  return Ok ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+//===- shrink_test.cpp ------- Shrinking Pairs Correctness Test ---*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for bcl::bit_cast(), bcl::shrinkPair(),
+// bcl::shrinkPairs() and bcl::restoreShrinkedPairs().
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/utility.h>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using Bytes = std::array<unsigned char, 4>;
+
+static_assert(!bcl::detail::IsShrinkableByShift<
+  bool, std::uint32_t, std::uint64_t>::value,
+  "Pairs of booleans must not be shrinked with shifts!");
+static_assert(!bcl::detail::IsShrinkableByShift<
+  std::uint32_t, bool, std::uint64_t>::value,
+  "Pairs of booleans must not be shrinked with shifts!");
+#ifdef BCL_LITTLE_ENDIAN
+static_assert(bcl::detail::IsShrinkableByShift<
+  std::uint32_t, std::int16_t, std::uint32_t>::value,
+  "Pairs of integers must be shrinked with shifts!");
+#endif
+
+#ifdef BCL_HAS_BUILTIN_BIT_CAST
+template<class T> constexpr bool isEqual(const T &LHS, const T &RHS) {
+  return LHS == RHS;
+}
+
+template<class T, std::size_t N>
+constexpr bool isEqual(const std::array<T, N> &LHS,
+    const std::array<T, N> &RHS) {
+  for (std::size_t I = 0; I < N; ++I)
+    if (LHS[I] != RHS[I])
+      return false;
+  return true;
+}
+
+/// Shrinks a pair of values and restores it back in a constant expression.
+template<class T, class FirstT, class SecondT>
+constexpr bool roundTrip(const FirstT &First, const SecondT &Second) {
+  T Out{};
+  if (!bcl::shrinkPair(First, Second, Out))
+    return false;
+  FirstT RestoredFirst{};
+  SecondT RestoredSecond{};
+  bcl::restoreShrinkedPair(Out, RestoredFirst, RestoredSecond);
+  return isEqual(First, RestoredFirst) && isEqual(Second, RestoredSecond);
+}
+
+static_assert(bcl::bit_cast<std::uint32_t>(1.0f) == 0x3F800000u,
+  "Object representation of a float must be preserved!");
+static_assert(roundTrip<std::uint32_t>(Bytes{1, 2, 0, 0}, Bytes{3, 4, 0, 0}),
+  "Pair of half-filled arrays must be shrinked!");
+static_assert(!roundTrip<std::uint32_t>(Bytes{1, 2, 3, 0}, Bytes{3, 4, 0, 0}),
+  "Pair of filled arrays must not be shrinked!");
+#ifdef BCL_LITTLE_ENDIAN
+static_assert(
+  roundTrip<std::uint32_t>(std::uint32_t(0xFFFF), std::int16_t(-1)),
+  "Pair of small integers must be shrinked!");
+static_assert(
+  !roundTrip<std::uint32_t>(std::uint32_t(0x10000), std::int16_t(1)),
+  "Pair of large integers must not be shrinked!");
+static_assert([] {
+    std::uint32_t Out = 0;
+    bcl::shrinkPair(std::uint16_t(0x1234), std::uint16_t(0x5678), Out);
+    return Out;
+  }() == 0x56781234u, "The first value must be stored in low bytes!");
+#endif
+#endif
+
+bool check(const char *Title, bool Ok) {
+  std::cout << Title << ": " << (Ok ? "passed" : "failed") << std::endl;
+  return Ok;
+}
+
+using Pair = std::pair<std::uint32_t, std::int16_t>;
+
+/// Shrinks pairs with a specified implementation and restores them back.
+///
+/// Failed indices must match bcl::shrinkPair() results and the other pairs
+/// must be restored unchanged.
+template<class ShrinkTag, class RestoreTag>
+bool roundTrip(const std::vector<Pair> &Data,
+    std::vector<std::uint32_t> &Out) {
+  Out.assign(Data.size(), 0);
+  std::vector<std::size_t> Failed;
+  auto FailedNum = bcl::detail::shrinkPairs(Data.data(), Data.size(),
+    Out.data(), std::back_inserter(Failed), ShrinkTag());
+  if (FailedNum != Failed.size())
+    return false;
+  std::vector<Pair> Restored(Data.size());
+  bcl::detail::restoreShrinkedPairs(Out.data(), Out.size(), Restored.data(),
+    RestoreTag());
+  auto FailedItr = Failed.begin();
+  for (std::size_t I = 0; I < Data.size(); ++I) {
+    std::uint32_t Single;
+    if (!bcl::shrinkPair(Data[I], Single)) {
+      if (FailedItr == Failed.end() || *FailedItr++ != I)
+        return false;
+    } else if (Single != Out[I] || Restored[I] != Data[I]) {
+      return false;
+    }
+  }
+  return FailedItr == Failed.end();
+}
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  std::vector<Pair> Data;
+  for (std::uint32_t I = 0; I < 100; ++I)
+    Data.emplace_back(I * 1021, static_cast<std::int16_t>(I % 2 ? -I : I));
+  std::vector<std::uint32_t> Out;
+  bool Ok = check("shrink pairs by bytes",
+    roundTrip<std::false_type, std::false_type>(Data, Out));
+#ifdef BCL_LITTLE_ENDIAN
+  std::vector<std::uint32_t> OutByShift;
+  Ok &= check("shrink pairs by shifts",
+    roundTrip<std::true_type, std::true_type>(Data, OutByShift));
+  Ok &= check("shrink pairs by bytes and shifts",
+    roundTrip<std::true_type, std::false_type>(Data, OutByShift) &&
+    roundTrip<std::false_type, std::true_type>(Data, OutByShift));
+  Ok &= check("both implementations agree", Out == OutByShift);
+#endif
+  std::vector<std::size_t> Failed;
+  Out.assign(Data.size(), 0);
+  auto FailedNum = bcl::shrinkPairs(Data.data(), Data.size(), Out.data(),
+    std::back_inserter(Failed));
+  std::vector<Pair> Restored(Data.size());
+  bcl::restoreShrinkedPairs(Out.data(), Out.size(), Restored.data());
+  bool IsRestored = FailedNum == Failed.size();
+  for (std::size_t I = 0, FailedIdx = 0; I < Data.size(); ++I)
+    if (FailedIdx < Failed.size() && Failed[FailedIdx] == I)
+      ++FailedIdx;
+    else
+      IsRestored &= Restored[I] == Data[I];
+  Ok &= check("restore shrinked pairs", IsRestored);
+  return Ok ? 0 : 1;
+}
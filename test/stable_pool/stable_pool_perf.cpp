@@ -0,0 +1,130 @@
+//===- stable_pool_perf.cpp --- Stable Pool Benchmark -------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements performance benchmark for bcl::StablePool. The pool is
+// compared with a vector of bcl::ValuePtrWrapper objects which updates
+// external pointers each time objects are moved.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/StablePool.h>
+#include <bcl/ValuePtrWrapper.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using TimeT = std::chrono::duration<double>;
+
+struct Element {
+  explicit Element(std::size_t V) : mValue(V) {}
+  std::size_t mValue;
+  std::size_t mPayload[3] = {0, 0, 0};
+};
+
+/// Fills a vector of wrappers, accesses objects through external pointers
+/// and iterates over a vector.
+std::pair<TimeT, std::size_t> wrapperTime(std::size_t Size) {
+  auto S = std::chrono::high_resolution_clock::now();
+  std::vector<Element *> Ptrs(Size);
+  std::vector<bcl::ValuePtrWrapper<Element>> Pool;
+  for (std::size_t I = 0; I < Size; ++I)
+    Pool.emplace_back(Ptrs[I], I);
+  std::size_t Sum = 0;
+  for (std::size_t I = 0; I < Size; I += 3)
+    Sum += Ptrs[I]->mValue;
+  for (auto &W : Pool)
+    Sum += (*W).mValue;
+  auto E = std::chrono::high_resolution_clock::now();
+  return std::make_pair(E - S, Sum);
+}
+
+/// Fills a pool, accesses objects through handles and iterates over a pool.
+std::pair<TimeT, std::size_t> poolTime(std::size_t Size) {
+  using PoolT = bcl::StablePool<Element>;
+  auto S = std::chrono::high_resolution_clock::now();
+  std::vector<PoolT::handle> Handles(Size);
+  PoolT Pool;
+  for (std::size_t I = 0; I < Size; ++I)
+    Handles[I] = Pool.emplace(I);
+  std::size_t Sum = 0;
+  for (std::size_t I = 0; I < Size; I += 3)
+    Sum += Pool[Handles[I]].mValue;
+  for (auto &V : Pool)
+    Sum += V.mValue;
+  auto E = std::chrono::high_resolution_clock::now();
+  return std::make_pair(E - S, Sum);
+}
+
+int main(int Argc, char **Argv) {
+  std::string Help = "parameters: <size of data> [number of iterations]\n";
+  if (Argc < 2) {
+    std::cerr << "error: too few arguments\n" << Help;
+    return 1;
+  } else if (Argc > 3) {
+    std::cerr << "error: too many arguments\n" << Help;
+    return 2;
+  }
+  std::size_t Size = std::atoll(Argv[1]);
+  unsigned MaxIter = (Argc > 2) ? std::atoi(Argv[2]) : 10;
+  TimeT WrapperT(0), PoolT(0);
+  std::size_t WrapperSum = 0, PoolSum = 0;
+  for (unsigned I = 0; I < MaxIter; ++I) {
+    auto W = wrapperTime(Size);
+    WrapperT += W.first;
+    WrapperSum += W.second;
+    auto P = poolTime(Size);
+    PoolT += P.first;
+    PoolSum += P.second;
+  }
+  if (WrapperSum != PoolSum) {
+    std::cerr << "error: results mismatch\n";
+    return 3;
+  }
+  std::cout << "Results for " << __FILE__ << " benchmark" << std::endl;
+  std::cout << "  date " << __DATE__ << std::endl;
+  std::cout << "  compiler ";
+#if defined __GNUC__
+  std::cout << "GCC " << __GNUC__;
+#elif defined __clang__
+  std::cout << "Clang " << __clang__;
+#elif defined _MSC_VER
+  std::cout << "Microsoft " << _MSC_VER;
+#else
+  std::cout << "unknown";
+#endif
+  std::cout << std::endl;
+  std::cout << "  BCL version " << BCL_VERSION_STRING << std::endl;
+  std::cout << "  size of data " << Size << std::endl;
+  std::cout << "  size of element " << sizeof(Element) << std::endl;
+  std::cout << "  number of iterations " << MaxIter << std::endl;
+  std::map<double, std::string> Time;
+  std::cout << std::endl;
+  Time.emplace(WrapperT.count(),
+    "std::vector<bcl::ValuePtrWrapper> time (.s) ");
+  Time.emplace(PoolT.count(), "bcl::StablePool time (.s) ");
+  for (auto &T : Time)
+    std::cout << T.second << T.first << std::endl;
+  return 0;
+}
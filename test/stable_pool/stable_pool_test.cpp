@@ -0,0 +1,89 @@
+//===- stable_pool_test.cpp --- Stable Pool Correctness Test -------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for bcl::StablePool.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/StablePool.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/// Counts live objects to check that a pool destroys all of them.
+struct Counted {
+  explicit Counted(int V) : mValue(V) { ++Live; }
+  Counted(const Counted &) = delete;
+  Counted & operator=(const Counted &) = delete;
+  ~Counted() { --Live; }
+  int mValue;
+  static int Live;
+};
+
+int Counted::Live = 0;
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  bool Ok = true;
+  {
+    bcl::StablePool<Counted, 4> Pool;
+    std::vector<bcl::StablePool<Counted, 4>::handle> Handles;
+    std::vector<Counted *> Ptrs;
+    for (int I = 0; I < 10; ++I) {
+      Handles.push_back(Pool.emplace(I));
+      Ptrs.push_back(Pool.get(Handles.back()));
+    }
+    Ok &= Pool.size() == 10 && Pool.capacity() == 12;
+    // Addresses must survive further growth and erasure.
+    for (int I = 1; I < 10; I += 2)
+      Pool.erase(Handles[I]);
+    for (int I = 10; I < 20; ++I)
+      Pool.emplace(I);
+    for (int I = 0; I < 10; ++I)
+      if (I % 2 == 0)
+        Ok &= Pool.get(Handles[I]) == Ptrs[I] && Ptrs[I]->mValue == I;
+      else
+        Ok &= !Pool.contains(Handles[I]) && !Pool.get(Handles[I]);
+    // Released slots must be reused before new chunks are allocated.
+    Ok &= Pool.size() == 15 && Pool.capacity() == 16;
+    std::vector<int> Values;
+    for (auto &C : Pool)
+      Values.push_back(C.mValue);
+    std::sort(Values.begin(), Values.end());
+    std::string Result;
+    for (auto V : Values)
+      Result += std::to_string(V) + " ";
+    std::cout << Result << std::endl;
+    Ok &= Result == "0 2 4 6 8 10 11 12 13 14 15 16 17 18 19 ";
+    for (auto I = Pool.begin(), EI = Pool.end(); I != EI; ++I)
+      Ok &= &Pool[I.getHandle()] == &*I;
+    auto Moved = std::move(Pool);
+    Ok &= Pool.empty() && Moved.get(Handles[0]) == Ptrs[0];
+    Moved.clear();
+    Ok &= Counted::Live == 0 && !Moved.contains(Handles[0]);
+    Moved.emplace(1);
+    Moved.emplace(2);
+  }
+  Ok &= Counted::Live == 0;
+  std::cout << (Ok ? "passed" : "failed") << std::endl;
+  return Ok ? 0 : 1;
+}
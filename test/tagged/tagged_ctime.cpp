@@ -0,0 +1,78 @@
+//===- tagged_ctime.cpp -- Compile-Time Lookup Benchmark ------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements compile-time benchmark for lookup of tags in
+// bcl::StaticMap and bcl::tagged_tuple. The number of tags is specified with
+// the BCL_TAG_NUMBER macro, each tag is accessed in a map and in a tuple.
+// Compilation time and number of instantiations for different values of
+// BCL_TAG_NUMBER should be compared, so build with BCL_TIME_REPORT to obtain
+// a compiler report.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/cell.h>
+#include <bcl/tagged.h>
+#include <iostream>
+#include <utility>
+
+#ifndef BCL_TAG_NUMBER
+# define BCL_TAG_NUMBER 10
+#endif
+
+template<std::size_t Idx> struct Tag { typedef std::size_t ValueType; };
+
+template<class IndexSeq> struct Benchmark;
+
+template<std::size_t... Indexes>
+struct Benchmark<std::index_sequence<Indexes...>> {
+  using MapT = bcl::StaticMap<Tag<Indexes>...>;
+  using TupleT = bcl::tagged_tuple<bcl::tagged<std::size_t, Tag<Indexes>>...>;
+
+  static std::size_t run() {
+    MapT M;
+    TupleT T;
+    ((M.template value<Tag<Indexes>>() = Indexes), ...);
+    ((T.template get<Tag<Indexes>>() = M.template value<Tag<Indexes>>()), ...);
+    return (std::size_t(0) + ... + T.template get<Tag<Indexes>>());
+  }
+};
+
+int main() {
+  auto Sum = Benchmark<std::make_index_sequence<BCL_TAG_NUMBER>>::run();
+  std::cout << "Results for " << __FILE__ << " benchmark" << std::endl;
+  std::cout << "  date " << __DATE__ << std::endl;
+  std::cout << "  compiler ";
+#if defined __GNUC__
+  std::cout << "GCC " << __GNUC__;
+#elif defined __clang__
+  std::cout << "Clang " << __clang__;
+#elif defined _MSC_VER
+  std::cout << "Microsoft " << _MSC_VER;
+#else
+  std::cout << "unknown";
+#endif
+  std::cout << std::endl;
+  std::cout << "  BCL version " << BCL_VERSION_STRING << std::endl;
+  std::cout << "  number of tags " << BCL_TAG_NUMBER << std::endl;
+  std::cout << std::endl;
+  std::cout << "sum of values " << Sum << std::endl;
+  return Sum == BCL_TAG_NUMBER * (BCL_TAG_NUMBER - 1) / 2 ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+//===- tagged_test.cpp ------- Tagged Types Lookup Test -----------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for lookup of types in a list of types
+// (bcl::index_of()) and lookup of tags (bcl::get_tagged, bcl::tagged_tuple).
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/tagged.h>
+#include <bcl/utility.h>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+struct Name {};
+struct Age {};
+struct Id {};
+struct Alias {};
+
+static_assert(bcl::index_of<long, int, long, long>() == 1,
+  "Index of the first occurrence must be returned!");
+static_assert(bcl::detail::IndexOfImp<char, int, long>::index_of() == 2,
+  "Index of a missing type must be equal to the number of types!");
+static_assert(bcl::detail::IndexOfImp<char>::index_of() == 0,
+  "Index of a missing type must be equal to the number of types!");
+static_assert(bcl::detail::findFirst<false, true, true>() == 1,
+  "Index of the first true flag must be returned!");
+static_assert(bcl::detail::findFirst<false, false>() == 2,
+  "Number of flags must be returned if all flags are false!");
+
+static_assert(std::is_same<bcl::get_tagged<Age,
+  bcl::tagged<int, Id>, bcl::tagged<long, Age>>,
+  bcl::tagged<long, Age>>::value,
+  "Tagged type must be found by its tag!");
+static_assert(std::is_same<bcl::get_tagged_t<Alias,
+  bcl::tagged<int, Id>, bcl::tagged<long, Age, Alias>,
+  bcl::tagged<char, Alias>>, long>::value,
+  "The first tagged type must be found by its alias!");
+static_assert(std::is_void<bcl::get_tagged<Age,
+  bcl::tagged<int, Id>, bcl::tagged<long, Name>>>::value,
+  "Missing tag must not be found!");
+static_assert(std::is_void<bcl::get_tagged<Age>>::value,
+  "Tag must not be found in an empty list!");
+
+static bool check(const char *Title, bool Ok) {
+  std::cout << Title << (Ok ? ": passed" : ": failed") << std::endl;
+  return Ok;
+}
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  bcl::tagged_tuple<bcl::tagged<int, Id>, bcl::tagged<std::string, Name>,
+    bcl::tagged<unsigned, Age, Alias>> Person(1, "Alice", 30u);
+  Person.get<Alias>() += 1;
+  bool Ok = check("access tuple elements by tags",
+    Person.get<Id>() == 1 && Person.get<Name>() == "Alice" &&
+    Person.get<Age>() == 31);
+  return Ok ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+//===- trace_test.cpp --------- Tracepoints Test ------------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for BCL_TRACE_SCOPE and export of collected
+// records in the Chrome trace event format.
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/Json.h>
+#include <bcl/Trace.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+JSON_OBJECT_BEGIN(Human)
+JSON_OBJECT_ROOT_PAIR_2(Human, Name, std::string, Age, unsigned)
+  Human() : JSON_INIT_ROOT {}
+JSON_OBJECT_END(Human)
+JSON_DEFAULT_TRAITS(::, Human)
+
+/// Returns number of occurrences of a specified substring.
+static std::size_t count(const std::string &Str, const std::string &What) {
+  std::size_t N = 0;
+  for (auto Pos = Str.find(What); Pos != std::string::npos;
+       Pos = Str.find(What, Pos + What.size()))
+    ++N;
+  return N;
+}
+
+static void work(unsigned N) {
+  BCL_TRACE_SCOPE("work");
+  for (unsigned I = 0; I < N; ++I) {
+    BCL_TRACE_SCOPE("iteration");
+  }
+}
+
+/// Declares two scopes on the same line.
+#define TRACE_NESTED_SCOPES \
+  BCL_TRACE_SCOPE("outer"); BCL_TRACE_SCOPE("inner")
+
+static void nested() {
+  TRACE_NESTED_SCOPES;
+}
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  json::Parser<Human> P(R"j({"name": "Human", "Name": "Jon", "Age": 1})j");
+  auto O = P.parse();
+  bool Ok = O && O->is<Human>();
+  std::thread T(work, 3);
+  work(2);
+  T.join();
+  std::ostringstream OS;
+  bcl::trace::dump(OS);
+  auto Trace = OS.str();
+  std::cout << Trace;
+  Ok &= Trace.compare(0, 15, "{\"traceEvents\":") == 0;
+  Ok &= count(Trace, "\"ph\":\"B\"") == count(Trace, "\"ph\":\"E\"");
+  Ok &= count(Trace, "\"name\":\"json::Parser::parse\"") == 2;
+  Ok &= count(Trace, "\"name\":\"json::Parser::parseName\"") == 2;
+  Ok &= count(Trace, "\"name\":\"work\"") == 4;
+  Ok &= count(Trace, "\"name\":\"iteration\"") == 10;
+  Ok &= count(Trace, "\"tid\":1") == 8;
+  bcl::trace::clear();
+  std::ostringstream Empty;
+  bcl::trace::dump(Empty);
+  Ok &= count(Empty.str(), "\"ph\"") == 0;
+  // Buffers of exited threads are reused and their records are kept.
+  auto NumBuffers = bcl::trace::getNumBuffers();
+  for (unsigned I = 0; I < 16; ++I)
+    std::thread(work, 1).join();
+  Ok &= bcl::trace::getNumBuffers() == NumBuffers;
+  std::ostringstream Retired;
+  bcl::trace::dump(Retired);
+  Ok &= count(Retired.str(), "\"name\":\"work\"") == 32;
+  Ok &= count(Retired.str(), "\"tid\":17}") == 4;
+  // Records may be cleared while other threads write them.
+  std::thread Writer(work, 100000);
+  for (unsigned I = 0; I < 100; ++I)
+    bcl::trace::clear();
+  Writer.join();
+  bcl::trace::clear();
+  std::ostringstream Cleared;
+  bcl::trace::dump(Cleared);
+  Ok &= count(Cleared.str(), "\"ph\"") == 0;
+  nested();
+  std::ostringstream Nested;
+  bcl::trace::dump(Nested);
+  Ok &= count(Nested.str(), "\"name\":\"outer\"") == 2;
+  Ok &= count(Nested.str(), "\"name\":\"inner\"") == 2;
+  std::cout << (Ok ? "passed" : "failed") << std::endl;
+  return Ok ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+//===- value_test.cpp ------- Nullable Value Test -----------------*- C -*-===//
+//
+//                       Base Construction Library (BCL)
+//
+// Copyright 2018 Nikita Kataev
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements test for bcl::Nullable, bcl::SmallString and adapters
+// for legacy values (if BCL_LEGACY is enabled).
+//
+//===----------------------------------------------------------------------===//
+
+#include <bcl/bcl-config.h>
+#include <bcl/Nullable.h>
+#include <bcl/SmallString.h>
+#ifdef BCL_LEGACY
+# include <bcl/legacy/adapter.h>
+#endif
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+/// Index which uses the maximum value as an undefined value.
+struct Index { std::uint32_t Value; };
+
+namespace bcl {
+template<> struct null_value<Index> {
+  static constexpr Index value() noexcept { return Index{ UINT32_MAX }; }
+  static constexpr bool is_null(Index I) noexcept {
+    return I.Value == UINT32_MAX;
+  }
+};
+}
+
+static_assert(std::is_trivially_copyable<bcl::Nullable<int>>::value,
+  "Nullable trivially copyable value must be trivially copyable!");
+static_assert(std::is_trivially_copyable<bcl::Nullable<double>>::value,
+  "Nullable trivially copyable value must be trivially copyable!");
+static_assert(std::is_trivially_copyable<bcl::Nullable<int *>>::value &&
+  sizeof(bcl::Nullable<int *>) == sizeof(int *),
+  "Nullable pointer must use nullptr as an undefined value!");
+static_assert(std::is_trivially_copyable<bcl::Nullable<Index>>::value &&
+  sizeof(bcl::Nullable<Index>) == sizeof(Index),
+  "Nullable value with a sentinel must have the same size as a value!");
+static_assert(std::is_trivially_copyable<bcl::SmallString<15>>::value &&
+  sizeof(bcl::SmallString<15>) == 17,
+  "Small string must be trivially copyable!");
+static_assert(!std::is_trivially_copyable<bcl::Nullable<std::string>>::value,
+  "Nullable std::string must not be trivially copyable!");
+
+static bool check(const char *Title, bool Ok) {
+  std::cout << Title << (Ok ? ": passed" : ": failed") << std::endl;
+  return Ok;
+}
+
+template<class T> bool checkNullable(const T &V1, const T &V2) {
+  bcl::Nullable<T> N;
+  if (N || N.has_value() || N != std::nullopt || N == V1 || N.value_or(V2) != V2)
+    return false;
+  N = V1;
+  if (!N || N != V1 || N == V2 || *N != V1 || N.value() != V1)
+    return false;
+  bcl::Nullable<T> Copy(N), Undef;
+  if (Copy != N || Undef == N || !(Undef < N) || N < Undef)
+    return false;
+  std::unordered_set<bcl::Nullable<T>> Set{ N, Copy, Undef };
+  if (Set.size() != 2)
+    return false;
+  N.reset();
+  bool Thrown = false;
+  try {
+    N.value();
+  } catch (std::bad_optional_access &) {
+    Thrown = true;
+  }
+  if (!Thrown || N != Undef)
+    return false;
+  N.emplace(V2);
+  return N == V2 && N.toOptional() == std::optional<T>(V2) &&
+    bcl::Nullable<T>(std::optional<T>()) == std::nullopt;
+}
+
+int main() {
+  std::cout << "BCL version " << BCL_VERSION_STRING << std::endl;
+  bool Ok = true;
+  Ok &= check("bcl::Nullable<int>", checkNullable(1, 2));
+  Ok &= check("bcl::Nullable<std::string>",
+    checkNullable(std::string("a"), std::string("b")));
+  int X = 1, Y = 2;
+  Ok &= check("bcl::Nullable<int *>", checkNullable(&X, &Y) &&
+    bcl::Nullable<int *>(nullptr) == std::nullopt);
+  bcl::Nullable<Index> I;
+  Ok &= check("bcl::Nullable with a sentinel", !I && (I = Index{ 5 }) &&
+    I->Value == 5 && !bcl::Nullable<Index>(Index{ UINT32_MAX }));
+  bcl::SmallString<8> S("abc");
+  bool Appended = S.append("def");
+  bool Truncated = !S.append("ghi");
+  std::ostringstream OS;
+  OS << S;
+  Ok &= check("bcl::SmallString", Appended && Truncated && S == "abcdefgh" &&
+    S.size() == 8 && S.c_str()[8] == '\0' && OS.str() == "abcdefgh" &&
+    !S.push_back('i') && (S.clear(), S.empty()) && S.push_back('x') &&
+    S == bcl::SmallString<1>("x"));
+  char Buf[4];
+  Ok &= check("bcl::toText", bcl::toText(-42) == "-42" &&
+    bcl::toText(INT64_MIN) == "-9223372036854775808" &&
+    bcl::toText(UINT64_MAX) == "18446744073709551615" &&
+    bcl::toText(0.5) == "0.5" && bcl::toText(-1.7976931348623157e308) ==
+      "-1.7976931348623157e+308" &&
+    bcl::copyString(Buf, sizeof(Buf), "abc") &&
+    std::string(Buf) == "abc" && !bcl::copyString(Buf, sizeof(Buf), "abcd") &&
+    std::string(Buf) == "abc");
+#ifdef BCL_LEGACY
+  Utility::Value<int, Utility::True> LegacyUndef, LegacyInt(5);
+  Utility::Value<int *, Utility::True> LegacyPtr(&X);
+  auto N = bcl::toNullable(LegacyInt);
+  bcl::legacy::Value<int, Utility::True> W;
+  bool Undef = W == undef;
+  W = 5;
+  int Sum = W + 1;
+  W = undef;
+  Ok &= check("legacy adapters", N == 5 &&
+    bcl::toNullable(LegacyUndef) == undef &&
+    bcl::toNullable(LegacyPtr) == &X &&
+    bcl::toLegacy(N) != undef && static_cast<int>(bcl::toLegacy(N)) == 5 &&
+    bcl::toLegacy(bcl::Nullable<int>()) == undef && Undef && Sum == 6 &&
+    W == undef && std::is_same<bcl::legacy::Value<int, Utility::False>,
+      int>::value && sizeof(W) == sizeof(bcl::Nullable<int>));
+#endif
+  return Ok ? 0 : 1;
+}